@@ -16,10 +16,6 @@
 #include "base/macros.hpp"
 #include "glog/logging.h"
 
-// Clang doesn't have a correct |std::array| yet, and we don't actually use this
-// code, so let's get rid of the entire body.
-#if PRINCIPIA_COMPILER_MSVC
-
 namespace principia {
 namespace base {
 
@@ -85,6 +81,7 @@ constexpr CachingRepertoire<block_size, block_count>::CachingRepertoire(
     char16_t const (&blocks)[block_count_plus_1])
     : blocks_(blocks),
       encoding_bits_(CeilingLog2(block_size * block_count)),
+      encoding_cache_(),
       decoding_cache_() {
   // Don't do pointer arithmetic in this constructor, it confuses MSVC.
   static_assert(block_count_plus_1 == block_count + 1,
@@ -202,12 +199,61 @@ constexpr std::int64_t bytes_per_code_point =
 static_assert(bytes_per_code_point == 3,
               "End of input padding below won't be correct");
 
+// The encoding and decoding proceed by blocks of 15 bytes, i.e., 8 code points,
+// as long as possible: the bit index is 0 at the boundaries of the blocks, and
+// the bits of a block are held in two 64-bit words, so there is no need to
+// track the position in the input.
+constexpr std::int64_t bytes_per_block = 15;
+constexpr std::int64_t code_points_per_block =
+    bytes_per_block * bits_per_byte / bits_per_code_point;
+static_assert(code_points_per_block * bits_per_code_point ==
+                  bytes_per_block * bits_per_byte,
+              "Blocks must be made of whole code points");
+
+// Big-endian loads and stores of |size| bytes in the low-order bytes of a
+// 64-bit word.
+template<int size>
+std::uint64_t LoadBigEndian(std::uint8_t const* const bytes) {
+  std::uint64_t word = 0;
+  for (int i = 0; i < size; ++i) {
+    word = word << bits_per_byte | bytes[i];
+  }
+  return word;
+}
+
+template<int size>
+void StoreBigEndian(std::uint64_t word, std::uint8_t* const bytes) {
+  for (int i = size - 1; i >= 0; --i) {
+    bytes[i] = static_cast<std::uint8_t>(word);
+    word >>= bits_per_byte;
+  }
+}
+
 void Base32768Encode(Array<std::uint8_t const> input,
                      Array<char16_t> output) {
   CHECK_NOTNULL(input.data);
   CHECK(input.size == 0 || output.data != nullptr);
 
   std::uint8_t const* const input_end = input.data + input.size;
+  constexpr std::uint64_t code_point_mask = (1 << bits_per_code_point) - 1;
+  while (input_end - input.data >= bytes_per_block) {
+    // The bits of the block are split between the 8 bytes of |high| and the 7
+    // low-order bytes of |low|.
+    std::uint64_t const high = LoadBigEndian<8>(input.data);
+    std::uint64_t const low = LoadBigEndian<7>(input.data + 8);
+    output.data[0] = fifteen_bits.Encode(high >> 49);
+    output.data[1] = fifteen_bits.Encode((high >> 34) & code_point_mask);
+    output.data[2] = fifteen_bits.Encode((high >> 19) & code_point_mask);
+    output.data[3] = fifteen_bits.Encode((high >> 4) & code_point_mask);
+    output.data[4] =
+        fifteen_bits.Encode((high << 11 | low >> 45) & code_point_mask);
+    output.data[5] = fifteen_bits.Encode((low >> 30) & code_point_mask);
+    output.data[6] = fifteen_bits.Encode((low >> 15) & code_point_mask);
+    output.data[7] = fifteen_bits.Encode(low & code_point_mask);
+    input.data += bytes_per_block;
+    output.data += code_points_per_block;
+  }
+
   std::int64_t input_bit_index = 0;
   while (input.data < input_end) {
     std::int32_t data;
@@ -278,6 +324,28 @@ void Base32768Decode(Array<char16_t const> input, Array<std::uint8_t> output) {
 
   char16_t const* const input_end = input.data + input.size;
   std::uint8_t const* const output_end = output.data + output.size;
+
+  // The last code point may use the seven-bit repertoire or encode padding, so
+  // it is always left to the loop below.
+  while (input_end - input.data > code_points_per_block) {
+    std::uint64_t const k4 = fifteen_bits.Decode(input.data[4]);
+    std::uint64_t const high =
+        std::uint64_t{fifteen_bits.Decode(input.data[0])} << 49 |
+        std::uint64_t{fifteen_bits.Decode(input.data[1])} << 34 |
+        std::uint64_t{fifteen_bits.Decode(input.data[2])} << 19 |
+        std::uint64_t{fifteen_bits.Decode(input.data[3])} << 4 |
+        k4 >> 11;
+    std::uint64_t const low =
+        k4 << 45 |
+        std::uint64_t{fifteen_bits.Decode(input.data[5])} << 30 |
+        std::uint64_t{fifteen_bits.Decode(input.data[6])} << 15 |
+        std::uint64_t{fifteen_bits.Decode(input.data[7])};
+    StoreBigEndian<8>(high, output.data);
+    StoreBigEndian<7>(low, output.data + 8);
+    input.data += code_points_per_block;
+    output.data += bytes_per_block;
+  }
+
   std::int64_t output_bit_index = 0;
   while (input.data < input_end) {
     bool const at_end = input_end - input.data == 1;
@@ -341,5 +409,3 @@ std::int64_t Base32768DecodedLength(Array<char16_t const> const input) {
 }  // namespace internal_base32768
 }  // namespace base
 }  // namespace principia
-
-#endif
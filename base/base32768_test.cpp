@@ -11,10 +11,6 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
-// Clang doesn't have a correct |std::array| yet, and we don't actually use this
-// code, so let's get rid of the entire test.
-#if PRINCIPIA_COMPILER_MSVC
-
 MATCHER_P(EqualsBytes, expected, "") {
   auto const actual = arg;
   if (actual.size != expected.size) {
@@ -281,9 +277,29 @@ TEST_F(Base32768Test, Random) {
     EXPECT_THAT(binary2.get(), EqualsBytes(binary1.get())) << "test: " << test;
   }
 }
+
+// The encoding and decoding process blocks of 15 bytes before dealing with the
+// remaining bytes, so try all the lengths around a few blocks.
+TEST_F(Base32768Test, AllLengths) {
+  std::mt19937_64 random(42);
+  std::uniform_int_distribution<int> bytes_distribution(0, 255);
+  for (int length = 0; length <= 64; ++length) {
+    UniqueArray<std::uint8_t> binary1(length);
+    for (int i = 0; i < binary1.size; ++i) {
+      binary1.data[i] = bytes_distribution(random);
+    }
+
+    UniqueArray<char16_t> const base32768 =
+        Base32768Encode(binary1.get(),
+                        /*null_terminated=*/false);
+    EXPECT_EQ(Base32768EncodedLength(binary1.get()), base32768.size);
+    UniqueArray<std::uint8_t> binary2 = Base32768Decode(base32768.get());
+
+    EXPECT_THAT(binary2.get(), EqualsBytes(binary1.get()))
+        << "length: " << length;
+  }
+}
 #endif
 
 }  // namespace base
 }  // namespace principia
-
-#endif
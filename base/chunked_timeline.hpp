@@ -0,0 +1,159 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace principia {
+namespace base {
+namespace internal_chunked_timeline {
+
+// A map-like container of values indexed by strictly increasing keys, where
+// elements may only be inserted at either end.  The elements are stored
+// contiguously in chunks of |chunk_size| elements, so iteration has good
+// locality and the memory overhead per element is negligible, unlike
+// |std::map| which allocates a node per element.
+// An iterator remains valid when elements are inserted, or when elements
+// other than the one it designates are removed at either end.  In particular,
+// |end()| remains the end iterator when elements are inserted.  Iterators are
+// invalidated by the removal of elements in the middle of the container.
+// Unlike with |std::map|, references and pointers to elements may be
+// invalidated by insertions, because the chunks of a short container grow as
+// needed: callers that hold on to elements across insertions must keep
+// iterators, not references.
+template<typename Key, typename Value>
+class ChunkedTimeline final {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<Key, Value>;
+  using size_type = std::int64_t;
+  using difference_type = std::int64_t;
+
+  class const_iterator final {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename ChunkedTimeline::value_type;
+    using difference_type = std::int64_t;
+    using pointer = value_type const*;
+    using reference = value_type const&;
+
+    const_iterator() = default;
+
+    reference operator*() const;
+    pointer operator->() const;
+
+    const_iterator& operator++();
+    const_iterator& operator--();
+    const_iterator operator++(int);
+    const_iterator operator--(int);
+
+    const_iterator& operator+=(difference_type n);
+    const_iterator& operator-=(difference_type n);
+    const_iterator operator+(difference_type n) const;
+    const_iterator operator-(difference_type n) const;
+    difference_type operator-(const_iterator const& right) const;
+
+    bool operator==(const_iterator const& right) const;
+    bool operator!=(const_iterator const& right) const;
+    bool operator<(const_iterator const& right) const;
+    bool operator<=(const_iterator const& right) const;
+    bool operator>(const_iterator const& right) const;
+    bool operator>=(const_iterator const& right) const;
+
+   private:
+    const_iterator(ChunkedTimeline const* timeline, std::int64_t index);
+
+    ChunkedTimeline const* timeline_ = nullptr;
+    // The index of the element in the sequence of all the elements ever
+    // inserted, which doesn't change when elements are added or removed at
+    // either end.  |end_index| for the end iterator.
+    std::int64_t index_ = end_index;
+
+    friend class ChunkedTimeline;
+  };
+
+  using iterator = const_iterator;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+  bool empty() const;
+  size_type size() const;
+
+  value_type const& front() const;
+  value_type const& back() const;
+
+  // Logarithmic in the size of the container.
+  const_iterator find(Key const& key) const;
+  const_iterator lower_bound(Key const& key) const;
+  const_iterator upper_bound(Key const& key) const;
+
+  // Inserts an element after the last one.  |key| must be greater than the key
+  // of the last element.  Amortized constant time.
+  const_iterator emplace_back(Key const& key, Value const& value);
+  // Inserts an element before the first one.  |key| must be less than the key
+  // of the first element.  Amortized constant time.  Only allocates memory
+  // for the elements inserted, so that a few insertions at the front of a
+  // short container are cheap.
+  const_iterator emplace_front(Key const& key, Value const& value);
+
+  // Removes the given elements.  Constant time (in the number of elements)
+  // if |first == begin()| or |last == end()|, otherwise linear in the number
+  // of elements following |last|.
+  void erase(const_iterator position);
+  void erase(const_iterator first, const_iterator last);
+
+  void clear();
+
+ private:
+  // A sentinel index for the end iterator.  It is not |first_index_ + size_|
+  // because the end iterator must not change when elements are appended.
+  static constexpr std::int64_t end_index =
+      std::numeric_limits<std::int64_t>::max();
+  // The number of elements per chunk.  A power of 2 to make the indexing
+  // cheap.
+  static constexpr std::int64_t chunk_size = 1 << 10;
+
+  // Returns an iterator for the given index, which must be in
+  // [first_index_, first_index_ + size_].
+  const_iterator MakeIterator(std::int64_t index) const;
+  // Returns the position of the element designated by |it| from the beginning
+  // of the container, in [0, size_].
+  std::int64_t Position(const_iterator const& it) const;
+
+  value_type const& at_position(std::int64_t position) const;
+  value_type& at_position(std::int64_t position);
+
+  // Removes all the elements at or after |position|.
+  void Truncate(std::int64_t position);
+
+  // The elements are laid out in slots, the chunk |i| covering the slots
+  // [i * chunk_size, (i + 1) * chunk_size[.  All the chunks hold all their
+  // slots, except the first one which only holds the slots starting at
+  // |front_chunk_start_|, and the last one which may stop short of its last
+  // slot.  The slots before |front_offset_| are not part of the container:
+  // they have been removed or they were reserved for |emplace_front|.  The
+  // last element is at slot |front_offset_ + size_ - 1|.
+  std::deque<std::vector<value_type>> chunks_;
+  std::int64_t front_chunk_start_ = 0;
+  std::int64_t front_offset_ = 0;
+  std::int64_t size_ = 0;
+  // The index of the first element.
+  std::int64_t first_index_ = 0;
+};
+
+}  // namespace internal_chunked_timeline
+
+using internal_chunked_timeline::ChunkedTimeline;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/chunked_timeline_body.hpp"
@@ -0,0 +1,364 @@
+﻿
+#pragma once
+
+#include "base/chunked_timeline.hpp"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_chunked_timeline {
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator*() const
+    -> reference {
+  return timeline_->at_position(timeline_->Position(*this));
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator->() const
+    -> pointer {
+  return &**this;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator++()
+    -> const_iterator& {
+  return *this += 1;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator--()
+    -> const_iterator& {
+  return *this -= 1;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator++(int)
+    -> const_iterator {
+  const_iterator const initial = *this;
+  ++*this;
+  return initial;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator--(int)
+    -> const_iterator {
+  const_iterator const initial = *this;
+  --*this;
+  return initial;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator+=(
+    difference_type const n) -> const_iterator& {
+  *this = timeline_->MakeIterator(
+      timeline_->first_index_ + timeline_->Position(*this) + n);
+  return *this;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator-=(
+    difference_type const n) -> const_iterator& {
+  return *this += -n;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator+(
+    difference_type const n) const -> const_iterator {
+  const_iterator result = *this;
+  return result += n;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator-(
+    difference_type const n) const -> const_iterator {
+  const_iterator result = *this;
+  return result -= n;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::const_iterator::operator-(
+    const_iterator const& right) const -> difference_type {
+  DCHECK_EQ(timeline_, right.timeline_);
+  return timeline_->Position(*this) - timeline_->Position(right);
+}
+
+template<typename Key, typename Value>
+bool ChunkedTimeline<Key, Value>::const_iterator::operator==(
+    const_iterator const& right) const {
+  return timeline_ == right.timeline_ && index_ == right.index_;
+}
+
+template<typename Key, typename Value>
+bool ChunkedTimeline<Key, Value>::const_iterator::operator!=(
+    const_iterator const& right) const {
+  return !(*this == right);
+}
+
+template<typename Key, typename Value>
+bool ChunkedTimeline<Key, Value>::const_iterator::operator<(
+    const_iterator const& right) const {
+  return *this - right < 0;
+}
+
+template<typename Key, typename Value>
+bool ChunkedTimeline<Key, Value>::const_iterator::operator<=(
+    const_iterator const& right) const {
+  return *this - right <= 0;
+}
+
+template<typename Key, typename Value>
+bool ChunkedTimeline<Key, Value>::const_iterator::operator>(
+    const_iterator const& right) const {
+  return *this - right > 0;
+}
+
+template<typename Key, typename Value>
+bool ChunkedTimeline<Key, Value>::const_iterator::operator>=(
+    const_iterator const& right) const {
+  return *this - right >= 0;
+}
+
+template<typename Key, typename Value>
+ChunkedTimeline<Key, Value>::const_iterator::const_iterator(
+    ChunkedTimeline const* const timeline,
+    std::int64_t const index)
+    : timeline_(timeline),
+      index_(index) {}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::begin() const -> const_iterator {
+  return MakeIterator(first_index_);
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::end() const -> const_iterator {
+  return const_iterator(this, end_index);
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::cbegin() const -> const_iterator {
+  return begin();
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::cend() const -> const_iterator {
+  return end();
+}
+
+template<typename Key, typename Value>
+bool ChunkedTimeline<Key, Value>::empty() const {
+  return size_ == 0;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::size() const -> size_type {
+  return size_;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::front() const -> value_type const& {
+  DCHECK(!empty());
+  return at_position(0);
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::back() const -> value_type const& {
+  DCHECK(!empty());
+  return at_position(size_ - 1);
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::find(Key const& key) const
+    -> const_iterator {
+  auto const it = lower_bound(key);
+  if (it == end() || key < it->first) {
+    return end();
+  }
+  return it;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::lower_bound(Key const& key) const
+    -> const_iterator {
+  return std::lower_bound(
+      begin(), end(), key,
+      [](value_type const& element, Key const& key) {
+        return element.first < key;
+      });
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::upper_bound(Key const& key) const
+    -> const_iterator {
+  return std::upper_bound(
+      begin(), end(), key,
+      [](Key const& key, value_type const& element) {
+        return key < element.first;
+      });
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::emplace_back(Key const& key,
+                                               Value const& value)
+    -> const_iterator {
+  DCHECK(empty() || back().first < key);
+  if ((front_offset_ + size_) % chunk_size == 0) {
+    // The last chunk is full, or there is none.  The first chunk grows as
+    // needed, so that short timelines don't use much memory.  The others are
+    // allocated at their final size.
+    chunks_.emplace_back();
+    if (chunks_.size() > 1) {
+      chunks_.back().reserve(chunk_size);
+    }
+  }
+  chunks_.back().emplace_back(key, value);
+  ++size_;
+  return MakeIterator(first_index_ + size_ - 1);
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::emplace_front(Key const& key,
+                                                Value const& value)
+    -> const_iterator {
+  if (empty()) {
+    return emplace_back(key, value);
+  }
+  DCHECK(key < front().first);
+  if (front_offset_ == front_chunk_start_) {
+    // The slot before the first element is not held by the first chunk.
+    if (front_chunk_start_ == 0) {
+      // Start a new first chunk that only holds the last slot.
+      chunks_.emplace_front(1, value_type(key, value));
+      front_chunk_start_ = chunk_size - 1;
+      front_offset_ = chunk_size;
+    } else {
+      // Grow the first chunk at the front, doubling its size to amortize the
+      // cost of moving its elements.  The new slots are filled with copies of
+      // the element to be inserted, as they need to exist.
+      std::int64_t const growth =
+          std::min<std::int64_t>(
+              front_chunk_start_,
+              std::max<std::int64_t>(1, chunks_.front().size()));
+      auto& front_chunk = chunks_.front();
+      front_chunk.insert(front_chunk.begin(), growth, value_type(key, value));
+      front_chunk_start_ -= growth;
+    }
+  }
+  --front_offset_;
+  --first_index_;
+  ++size_;
+  at_position(0) = value_type(key, value);
+  return begin();
+}
+
+template<typename Key, typename Value>
+void ChunkedTimeline<Key, Value>::erase(const_iterator const position) {
+  erase(position, std::next(position));
+}
+
+template<typename Key, typename Value>
+void ChunkedTimeline<Key, Value>::erase(const_iterator const first,
+                                        const_iterator const last) {
+  std::int64_t const first_position = Position(first);
+  std::int64_t const last_position = Position(last);
+  DCHECK_LE(first_position, last_position);
+  if (first_position == last_position) {
+    return;
+  }
+  if (first_position == 0 && last_position < size_) {
+    // Removal at the beginning: drop the chunks that are no longer used.
+    front_offset_ += last_position;
+    first_index_ += last_position;
+    size_ -= last_position;
+    while (front_offset_ >= chunk_size) {
+      chunks_.pop_front();
+      front_chunk_start_ = 0;
+      front_offset_ -= chunk_size;
+    }
+    return;
+  }
+  // Shift the elements that follow |last|, if any, and remove the tail.
+  for (std::int64_t position = last_position; position < size_; ++position) {
+    at_position(first_position + position - last_position) =
+        std::move(at_position(position));
+  }
+  Truncate(size_ - (last_position - first_position));
+}
+
+template<typename Key, typename Value>
+void ChunkedTimeline<Key, Value>::clear() {
+  erase(begin(), end());
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::MakeIterator(std::int64_t const index) const
+    -> const_iterator {
+  DCHECK_LE(first_index_, index);
+  DCHECK_LE(index, first_index_ + size_);
+  return const_iterator(this, index == first_index_ + size_ ? end_index
+                                                             : index);
+}
+
+template<typename Key, typename Value>
+std::int64_t ChunkedTimeline<Key, Value>::Position(
+    const_iterator const& it) const {
+  DCHECK_EQ(this, it.timeline_);
+  if (it.index_ == end_index) {
+    return size_;
+  }
+  DCHECK_LE(first_index_, it.index_);
+  DCHECK_LT(it.index_, first_index_ + size_);
+  return it.index_ - first_index_;
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::at_position(std::int64_t const position)
+    const -> value_type const& {
+  DCHECK_LE(0, position);
+  DCHECK_LT(position, size_);
+  std::int64_t const slot = front_offset_ + position;
+  if (slot < chunk_size) {
+    return chunks_.front()[slot - front_chunk_start_];
+  }
+  return chunks_[slot / chunk_size][slot % chunk_size];
+}
+
+template<typename Key, typename Value>
+auto ChunkedTimeline<Key, Value>::at_position(std::int64_t const position)
+    -> value_type& {
+  DCHECK_LE(0, position);
+  DCHECK_LT(position, size_);
+  std::int64_t const slot = front_offset_ + position;
+  if (slot < chunk_size) {
+    return chunks_.front()[slot - front_chunk_start_];
+  }
+  return chunks_[slot / chunk_size][slot % chunk_size];
+}
+
+template<typename Key, typename Value>
+void ChunkedTimeline<Key, Value>::Truncate(std::int64_t const position) {
+  size_ = position;
+  if (size_ == 0) {
+    chunks_.clear();
+    front_chunk_start_ = 0;
+    front_offset_ = 0;
+    return;
+  }
+  std::int64_t const slots = front_offset_ + size_;
+  std::int64_t const number_of_chunks = (slots + chunk_size - 1) / chunk_size;
+  chunks_.erase(chunks_.begin() + number_of_chunks, chunks_.end());
+  std::int64_t const last_chunk_start =
+      number_of_chunks == 1 ? front_chunk_start_
+                            : (number_of_chunks - 1) * chunk_size;
+  auto& last_chunk = chunks_.back();
+  last_chunk.erase(last_chunk.begin() + (slots - last_chunk_start),
+                   last_chunk.end());
+}
+
+}  // namespace internal_chunked_timeline
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,202 @@
+﻿
+#include "base/chunked_timeline.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+class ChunkedTimelineTest : public ::testing::Test {
+ protected:
+  // More than two chunks.
+  static constexpr int size = 2500;
+
+  ChunkedTimelineTest() {
+    for (int i = 0; i < size; ++i) {
+      timeline_.emplace_back(2 * i, 3.0 * i);
+    }
+  }
+
+  ChunkedTimeline<int, double> timeline_;
+};
+
+TEST_F(ChunkedTimelineTest, Iteration) {
+  EXPECT_FALSE(timeline_.empty());
+  EXPECT_EQ(size, timeline_.size());
+  EXPECT_EQ(size, std::distance(timeline_.begin(), timeline_.end()));
+  int i = 0;
+  for (auto const& pair : timeline_) {
+    EXPECT_EQ(2 * i, pair.first);
+    EXPECT_EQ(3.0 * i, pair.second);
+    ++i;
+  }
+  EXPECT_EQ(size, i);
+  for (auto it = timeline_.end(); it != timeline_.begin();) {
+    --it;
+    --i;
+    EXPECT_EQ(2 * i, it->first);
+  }
+  EXPECT_EQ(0, i);
+  EXPECT_EQ(2 * (size - 1), timeline_.back().first);
+  EXPECT_EQ(2 * (size - 1), (--timeline_.end())->first);
+  EXPECT_EQ(1234, (timeline_.begin() + 617)->first);
+}
+
+TEST_F(ChunkedTimelineTest, Search) {
+  EXPECT_EQ(1500, timeline_.find(1500)->first);
+  EXPECT_EQ(timeline_.end(), timeline_.find(1501));
+  EXPECT_EQ(timeline_.end(), timeline_.find(-2));
+  EXPECT_EQ(timeline_.end(), timeline_.find(2 * size));
+  EXPECT_EQ(1500, timeline_.lower_bound(1500)->first);
+  EXPECT_EQ(1502, timeline_.lower_bound(1501)->first);
+  EXPECT_EQ(1502, timeline_.upper_bound(1500)->first);
+  EXPECT_EQ(timeline_.begin(), timeline_.lower_bound(-7));
+  EXPECT_EQ(timeline_.end(), timeline_.lower_bound(2 * size));
+  EXPECT_EQ(timeline_.end(), timeline_.upper_bound(2 * (size - 1)));
+}
+
+TEST_F(ChunkedTimelineTest, StableIterators) {
+  auto const end = timeline_.end();
+  auto const it = timeline_.find(3000);
+  auto const last = --timeline_.end();
+  timeline_.emplace_back(2 * size, 0.0);
+  EXPECT_EQ(end, timeline_.end());
+  EXPECT_EQ(3000, it->first);
+  EXPECT_EQ(2 * size, std::next(last)->first);
+
+  timeline_.erase(timeline_.begin(), timeline_.find(2400));
+  EXPECT_EQ(end, timeline_.end());
+  EXPECT_EQ(3000, it->first);
+  EXPECT_EQ(timeline_.find(2400), timeline_.begin());
+  EXPECT_EQ(size + 1 - 1200, timeline_.size());
+
+  timeline_.emplace_front(-1, 42.0);
+  EXPECT_EQ(3000, it->first);
+  EXPECT_EQ(-1, timeline_.begin()->first);
+  EXPECT_EQ(42.0, timeline_.front().second);
+  EXPECT_EQ(2400, std::next(timeline_.begin())->first);
+
+  timeline_.erase(std::next(it), timeline_.end());
+  EXPECT_EQ(end, timeline_.end());
+  EXPECT_EQ(it, --timeline_.end());
+  EXPECT_EQ(3000, timeline_.back().first);
+}
+
+TEST_F(ChunkedTimelineTest, EraseMiddle) {
+  timeline_.erase(timeline_.find(10), timeline_.find(4990));
+  EXPECT_THAT(timeline_,
+              ElementsAre(Pair(0, 0.0),
+                          Pair(2, 3.0),
+                          Pair(4, 6.0),
+                          Pair(6, 9.0),
+                          Pair(8, 12.0),
+                          Pair(4990, 7485.0),
+                          Pair(4992, 7488.0),
+                          Pair(4994, 7491.0),
+                          Pair(4996, 7494.0),
+                          Pair(4998, 7497.0)));
+  timeline_.erase(timeline_.find(4));
+  timeline_.emplace_back(5000, 1.0);
+  EXPECT_THAT(timeline_,
+              ElementsAre(Pair(0, 0.0),
+                          Pair(2, 3.0),
+                          Pair(6, 9.0),
+                          Pair(8, 12.0),
+                          Pair(4990, 7485.0),
+                          Pair(4992, 7488.0),
+                          Pair(4994, 7491.0),
+                          Pair(4996, 7494.0),
+                          Pair(4998, 7497.0),
+                          Pair(5000, 1.0)));
+}
+
+TEST_F(ChunkedTimelineTest, Clear) {
+  auto const end = timeline_.end();
+  timeline_.clear();
+  EXPECT_TRUE(timeline_.empty());
+  EXPECT_EQ(0, timeline_.size());
+  EXPECT_EQ(timeline_.begin(), timeline_.end());
+  EXPECT_EQ(end, timeline_.end());
+  timeline_.emplace_front(1, 2.0);
+  timeline_.emplace_front(0, 1.0);
+  timeline_.emplace_back(2, 3.0);
+  EXPECT_THAT(timeline_,
+              ElementsAre(Pair(0, 1.0), Pair(1, 2.0), Pair(2, 3.0)));
+}
+
+// Insertions at the front of a short timeline, as done when detaching a fork,
+// followed by insertions at the back that fill several chunks.
+TEST_F(ChunkedTimelineTest, ShortFront) {
+  ChunkedTimeline<int, double> timeline;
+  timeline.emplace_back(0, 0.0);
+  timeline.emplace_back(1, 1.0);
+  auto const it = timeline.begin();
+  for (int i = -1; i >= -10; --i) {
+    timeline.emplace_front(i, i);
+  }
+  EXPECT_EQ(0, it->first);
+  for (int i = 2; i < 3000; ++i) {
+    timeline.emplace_back(i, i);
+  }
+  EXPECT_EQ(0, it->first);
+  EXPECT_EQ(3010, timeline.size());
+  int i = -10;
+  for (auto const& pair : timeline) {
+    EXPECT_EQ(i, pair.first);
+    EXPECT_EQ(i, pair.second);
+    ++i;
+  }
+  timeline.erase(timeline.begin(), timeline.find(2000));
+  EXPECT_EQ(2000, timeline.front().first);
+  EXPECT_EQ(1000, timeline.size());
+  timeline.erase(timeline.find(2500), timeline.end());
+  EXPECT_EQ(2499, timeline.back().first);
+  EXPECT_EQ(500, timeline.size());
+}
+
+// Check that the container behaves like a map under a mix of operations.
+TEST_F(ChunkedTimelineTest, Map) {
+  std::map<int, double> map;
+  ChunkedTimeline<int, double> timeline;
+  int first = 0;
+  int last = 0;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 1500; ++i) {
+      map.emplace_hint(map.end(), last, last);
+      timeline.emplace_back(last, last);
+      ++last;
+    }
+    for (int i = 0; i < 100; ++i) {
+      --first;
+      map.emplace_hint(map.begin(), first, first);
+      timeline.emplace_front(first, first);
+    }
+    int const forget_before = first + 1100;
+    map.erase(map.begin(), map.lower_bound(forget_before));
+    timeline.erase(timeline.begin(), timeline.lower_bound(forget_before));
+    first = forget_before;
+    int const forget_after = last - 300;
+    map.erase(map.upper_bound(forget_after), map.end());
+    timeline.erase(timeline.upper_bound(forget_after), timeline.end());
+    last = forget_after + 1;
+    ASSERT_EQ(map.size(), timeline.size());
+    EXPECT_TRUE(std::equal(map.begin(),
+                           map.end(),
+                           timeline.begin(),
+                           [](auto const& left, auto const& right) {
+                             return left.first == right.first &&
+                                    left.second == right.second;
+                           }));
+  }
+}
+
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,103 @@
+﻿
+#include "base/cpuid.hpp"
+
+#include <cstdint>
+
+#include "base/macros.hpp"
+#include "glog/logging.h"
+
+#if PRINCIPIA_COMPILER_MSVC || PRINCIPIA_COMPILER_CLANG_CL
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace principia {
+namespace base {
+
+namespace {
+
+struct CPUIDResult {
+  std::uint32_t eax;
+  std::uint32_t ebx;
+  std::uint32_t ecx;
+  std::uint32_t edx;
+};
+
+CPUIDResult CPUID(std::uint32_t const leaf, std::uint32_t const subleaf) {
+#if PRINCIPIA_COMPILER_MSVC || PRINCIPIA_COMPILER_CLANG_CL
+  int registers[4];
+  __cpuidex(registers, leaf, subleaf);
+  return {static_cast<std::uint32_t>(registers[0]),
+          static_cast<std::uint32_t>(registers[1]),
+          static_cast<std::uint32_t>(registers[2]),
+          static_cast<std::uint32_t>(registers[3])};
+#else
+  CPUIDResult result;
+  __cpuid_count(leaf, subleaf, result.eax, result.ebx, result.ecx, result.edx);
+  return result;
+#endif
+}
+
+// Returns the extended control register XCR0, which tells us which register
+// states the operating system saves on context switches.  Must only be called
+// if CPUID reports OSXSAVE.
+std::uint64_t ExtendedControlRegister0() {
+#if PRINCIPIA_COMPILER_MSVC || PRINCIPIA_COMPILER_CLANG_CL
+  return _xgetbv(0);
+#else
+  std::uint32_t eax;
+  std::uint32_t edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<std::uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+struct Features {
+  bool avx2 = false;
+  bool avx512f = false;
+};
+
+Features ComputeFeatures() {
+  Features features;
+  if (CPUID(/*leaf=*/0, /*subleaf=*/0).eax < 7) {
+    return features;
+  }
+
+  // Leaf 1, ECX: bit 27 is OSXSAVE, bit 28 is AVX.
+  CPUIDResult const leaf1 = CPUID(/*leaf=*/1, /*subleaf=*/0);
+  bool const has_osxsave = (leaf1.ecx & (1u << 27)) != 0;
+  bool const has_avx = (leaf1.ecx & (1u << 28)) != 0;
+  if (!has_osxsave || !has_avx) {
+    return features;
+  }
+
+  // XCR0: bits 1 and 2 are the XMM and YMM states; bits 5 to 7 are the opmask
+  // and ZMM states.
+  std::uint64_t const xcr0 = ExtendedControlRegister0();
+  bool const ymm_enabled = (xcr0 & 0b0000'0110) == 0b0000'0110;
+  bool const zmm_enabled = (xcr0 & 0b1110'0110) == 0b1110'0110;
+
+  // Leaf 7, EBX: bit 5 is AVX2, bit 16 is AVX-512F.
+  CPUIDResult const leaf7 = CPUID(/*leaf=*/7, /*subleaf=*/0);
+  features.avx2 = ymm_enabled && (leaf7.ebx & (1u << 5)) != 0;
+  features.avx512f = zmm_enabled && (leaf7.ebx & (1u << 16)) != 0;
+  return features;
+}
+
+}  // namespace
+
+bool HasCPUFeature(CPUFeature const feature) {
+  static Features const features = ComputeFeatures();
+  switch (feature) {
+    case CPUFeature::AVX2:
+      return features.avx2;
+    case CPUFeature::AVX512F:
+      return features.avx512f;
+  }
+  LOG(FATAL) << "Unexpected feature " << static_cast<int>(feature);
+  base::noreturn();
+}
+
+}  // namespace base
+}  // namespace principia
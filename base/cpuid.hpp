@@ -0,0 +1,18 @@
+﻿#pragma once
+
+namespace principia {
+namespace base {
+
+// The instruction set extensions for which we have specialized kernels.
+enum class CPUFeature {
+  AVX2,
+  AVX512F,
+};
+
+// Returns true iff both the processor and the operating system support the
+// given |feature|.  The result is computed on the first call and cached.  This
+// function is thread-safe.
+bool HasCPUFeature(CPUFeature feature);
+
+}  // namespace base
+}  // namespace principia
@@ -163,6 +163,19 @@ inline void noreturn() { std::exit(0); }
 // 64-bit architectures.
 #define PRINCIPIA_USE_SSE3_INTRINSICS !_DEBUG
 
+// Used to compile a function for an instruction set extension that the
+// processor may not support, e.g., AVX2.  Such a function must only be called
+// after checking for support at runtime, see base/cpuid.hpp.
+#if PRINCIPIA_COMPILER_CLANG    ||  \
+    PRINCIPIA_COMPILER_CLANG_CL ||  \
+    PRINCIPIA_COMPILER_GCC
+#  define PRINCIPIA_TARGET(isa) __attribute__((target(isa)))
+#elif PRINCIPIA_COMPILER_MSVC
+#  define PRINCIPIA_TARGET(isa)
+#else
+#  error "What compiler is this?"
+#endif
+
 // Thread-safety analysis.
 #if PRINCIPIA_COMPILER_CLANG || PRINCIPIA_COMPILER_CLANG_CL
 #  define THREAD_ANNOTATION_ATTRIBUTE__(x) __attribute__((x))
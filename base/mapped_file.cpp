@@ -0,0 +1,117 @@
+﻿
+#include "base/mapped_file.hpp"
+
+#if OS_WIN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_mapped_file {
+
+#if OS_WIN
+
+MappedFile::MappedFile(std::filesystem::path const& path) {
+  HANDLE const file = CreateFileW(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  /*lpSecurityAttributes=*/nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  /*hTemplateFile=*/nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  file_ = file;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    return;
+  }
+  HANDLE const mapping = CreateFileMappingW(file,
+                                            /*lpFileMappingAttributes=*/nullptr,
+                                            PAGE_READONLY,
+                                            /*dwMaximumSizeHigh=*/0,
+                                            /*dwMaximumSizeLow=*/0,
+                                            /*lpName=*/nullptr);
+  if (mapping == nullptr) {
+    return;
+  }
+  mapping_ = mapping;
+  void* const data = MapViewOfFile(mapping,
+                                   FILE_MAP_READ,
+                                   /*dwFileOffsetHigh=*/0,
+                                   /*dwFileOffsetLow=*/0,
+                                   /*dwNumberOfBytesToMap=*/0);
+  if (data == nullptr) {
+    return;
+  }
+  data_ = static_cast<std::uint8_t const*>(data);
+  size_ = size.QuadPart;
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    CloseHandle(mapping_);
+  }
+  if (file_ != nullptr) {
+    CloseHandle(file_);
+  }
+}
+
+#else
+
+MappedFile::MappedFile(std::filesystem::path const& path) {
+  int const file = open(path.c_str(), O_RDONLY);
+  if (file < 0) {
+    return;
+  }
+  struct stat status;
+  if (fstat(file, &status) == 0 && status.st_size > 0) {
+    void* const data = mmap(/*addr=*/nullptr,
+                            status.st_size,
+                            PROT_READ,
+                            MAP_PRIVATE,
+                            file,
+                            /*offset=*/0);
+    if (data != MAP_FAILED) {
+      data_ = static_cast<std::uint8_t const*>(data);
+      size_ = status.st_size;
+    }
+  }
+  // The mapping remains valid after the file is closed.
+  close(file);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<std::uint8_t*>(data_), size_);
+  }
+}
+
+#endif
+
+bool MappedFile::is_open() const {
+  return data_ != nullptr;
+}
+
+Array<std::uint8_t const> MappedFile::contents() const {
+  CHECK(is_open());
+  return Array<std::uint8_t const>(data_, size_);
+}
+
+}  // namespace internal_mapped_file
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,46 @@
+﻿
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include "base/array.hpp"
+#include "base/macros.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_mapped_file {
+
+// A RAII wrapper for a read-only memory mapping of an entire file.  The pages
+// of the file are only read when they are first accessed.
+class MappedFile final {
+ public:
+  // Maps the file at |path|.  If the file doesn't exist, is empty, or cannot be
+  // mapped, |is_open()| is false.
+  explicit MappedFile(std::filesystem::path const& path);
+  ~MappedFile();
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+
+  bool is_open() const;
+
+  // The contents of the file.  Must only be called if |is_open()|.
+  Array<std::uint8_t const> contents() const;
+
+ private:
+  std::uint8_t const* data_ = nullptr;
+  std::size_t size_ = 0;
+#if OS_WIN
+  void* file_ = nullptr;
+  void* mapping_ = nullptr;
+#endif
+};
+
+}  // namespace internal_mapped_file
+
+using internal_mapped_file::MappedFile;
+
+}  // namespace base
+}  // namespace principia
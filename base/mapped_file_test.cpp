@@ -0,0 +1,52 @@
+
+#include "base/mapped_file.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+class MappedFileTest : public ::testing::Test {
+ protected:
+  MappedFileTest()
+      : path_(std::filesystem::temp_directory_path() /
+              "mapped_file_test.bin") {}
+
+  ~MappedFileTest() override {
+    std::filesystem::remove(path_);
+  }
+
+  std::filesystem::path const path_;
+};
+
+TEST_F(MappedFileTest, Missing) {
+  MappedFile const file(path_);
+  EXPECT_FALSE(file.is_open());
+}
+
+TEST_F(MappedFileTest, Empty) {
+  std::ofstream(path_, std::ios::binary).close();
+  MappedFile const file(path_);
+  EXPECT_FALSE(file.is_open());
+}
+
+TEST_F(MappedFileTest, Contents) {
+  std::string const contents = "Lorem ipsum dolor sit amet";
+  {
+    std::ofstream stream(path_, std::ios::binary);
+    stream << contents;
+  }
+  MappedFile const file(path_);
+  ASSERT_TRUE(file.is_open());
+  auto const mapped = file.contents();
+  EXPECT_EQ(contents,
+            std::string(reinterpret_cast<char const*>(mapped.data),
+                        mapped.size));
+}
+
+}  // namespace base
+}  // namespace principia
@@ -2,15 +2,19 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <memory>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "base/array.hpp"
 #include "base/macros.hpp"
 #include "base/not_null.hpp"
+#include "base/thread_pool.hpp"
 #include "gipfeli/compression.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/io/zero_copy_stream.h"
@@ -68,6 +72,16 @@ class PullSerializer final {
   PullSerializer(int chunk_size,
                  int number_of_chunks,
                  std::unique_ptr<Compressor> compressor);
+
+  // Same as above, but the chunks are compressed in parallel, using one thread
+  // for each element of |compressors| (compressors are not thread-safe).  The
+  // chunks are returned by |Pull| in the order of the stream.  Each compression
+  // in progress holds two chunks, so at most |(number_of_chunks - 2) / 2|
+  // compressions may proceed in parallel, and the memory bound above still
+  // holds.  No compression takes place if |compressors| is empty.
+  PullSerializer(int chunk_size,
+                 int number_of_chunks,
+                 std::vector<std::unique_ptr<Compressor>> compressors);
   ~PullSerializer();
 
   // Starts the serializer, which will proceed to serialize |message|.  This
@@ -76,6 +90,18 @@ class PullSerializer final {
       not_null<std::unique_ptr<google::protobuf::Message const>> message);
   void Start(not_null<google::protobuf::Message const*> message);
 
+  // Starts the serializer, which will proceed to serialize the messages
+  // returned by successive calls to |next_message| until it returns null.  A
+  // message must remain valid until the next call.  The serializations are
+  // concatenated, so if the messages all have the same type, parsing the
+  // resulting stream yields their merge.  Therefore, the messages may lack
+  // required fields as long as their merge has them.  |next_message| is called
+  // on the serialization thread, so the messages may be built lazily while the
+  // client pulls the data of the previous ones.  This method must be called at
+  // most once for each serializer object.
+  void Start(
+      std::function<google::protobuf::Message const*()> next_message);
+
   // Obtain the next chunk of data from the serializer.  Blocks if no data is
   // available.  Returns a |Array<std::uint8_t>| object of |size| 0 at the end
   // of the serialization.  The returned object may become invalid the next time
@@ -90,15 +116,25 @@ class PullSerializer final {
  private:
   // Enqueues the chunk of data to be returned to |Pull| and returns a free
   // chunk.  Blocks if there are no free chunks.  Used as a callback for the
-  // underlying |DelegatingArrayOutputStream|.
+  // underlying |DelegatingArrayOutputStream|.  In the presence of compression,
+  // |bytes| is compressed asynchronously, and the chunk is returned to the
+  // |free_| queue once the compression has completed.
   Array<std::uint8_t> Push(Array<std::uint8_t> bytes);
 
+  // Compresses |bytes| into |compressed_bytes| using one of the
+  // |idle_compressors_|.  Runs on the |compression_pool_|.
+  Array<std::uint8_t> Compress(Array<std::uint8_t> bytes,
+                               Array<std::uint8_t> compressed_bytes);
+
+  // Pushes the empty chunk that indicates the end of the serialization.
+  void PushEndOfStream();
+
   // |owned_message_| is null if this object doesn't own the message.
   // |message_| is non-null after Start.
   std::unique_ptr<google::protobuf::Message const> owned_message_;
   google::protobuf::Message const* message_ = nullptr;
 
-  std::unique_ptr<Compressor> const compressor_;
+  std::vector<std::unique_ptr<Compressor>> const compressors_;
 
   // The chunk size passed at construction.  The stream outputs chunks of that
   // size.
@@ -112,8 +148,8 @@ class PullSerializer final {
   // The number of chunks passed at construction, used to size |data_|.
   int const number_of_chunks_;
 
-  // How many of the |number_of_chunks_| chunks in |data_| are reserved for
-  // compression.
+  // How many of the |number_of_chunks_| chunks in |data_| are reserved for the
+  // output of each compression.
   int const number_of_compression_chunks_;
 
   // The array supporting the stream and the stream itself.
@@ -123,19 +159,34 @@ class PullSerializer final {
   // The thread doing the actual serialization.
   std::unique_ptr<std::thread> thread_;
 
+  // The chunk last returned by |Pull|.  It is freed by the next call to
+  // |Pull|, to make sure that the pointer is not reused while the caller
+  // processes it.  Only accessed by |Pull|.
+  Array<std::uint8_t> pulled_;
+
   absl::Mutex lock_;
 
-  // The |queue_| contains the |Array<std::uint8_t>| objects filled by |Push|
-  // and not yet consumed by |Pull|.  If a |Array<std::uint8_t>| object has been
-  // handed over to the caller by |Pull| it stays in the queue until the next
-  // call to |Pull|, to make sure that the pointer is not reused while the
-  // caller processes it.
-  std::queue<Array<std::uint8_t>> queue_ GUARDED_BY(lock_);
+  // The |queue_| contains the (future) |Array<std::uint8_t>| objects filled by
+  // |Push| and not yet consumed by |Pull|, in the order of the stream.  The
+  // futures are not ready while the corresponding chunks are being
+  // compressed.
+  std::queue<std::future<Array<std::uint8_t>>> queue_ GUARDED_BY(lock_);
 
   // The |free_| queue contains the start addresses of chunks that are not yet
   // ready to be returned by |Pull|.  That includes the chunk currently being
-  // filled by the stream.
+  // filled by the stream, which is always at the front.
   std::queue<not_null<std::uint8_t*>> free_ GUARDED_BY(lock_);
+
+  // The compressors that are not in use by a compression.
+  std::vector<not_null<Compressor*>> idle_compressors_ GUARDED_BY(lock_);
+
+  // The number of compressions in progress, each of which holds an
+  // uncompressed chunk that is neither in |queue_| nor in |free_|.
+  int compressions_in_progress_ GUARDED_BY(lock_) = 0;
+
+  // The threads that compress the chunks.  Null in the absence of compression.
+  // Declared last so that it is destroyed first.
+  std::unique_ptr<ThreadPool<Array<std::uint8_t>>> compression_pool_;
 };
 
 }  // namespace internal_pull_serializer
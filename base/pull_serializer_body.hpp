@@ -6,6 +6,7 @@
 #include <algorithm>
 
 #include "base/sink_source.hpp"
+#include "google/protobuf/io/coded_stream.h"
 
 namespace principia {
 namespace base {
@@ -65,14 +66,26 @@ inline std::int64_t DelegatingArrayOutputStream::ByteCount() const {
 inline PullSerializer::PullSerializer(int const chunk_size,
                                       int const number_of_chunks,
                                       std::unique_ptr<Compressor> compressor)
-    : compressor_(std::move(compressor)),
+    : PullSerializer(chunk_size, number_of_chunks, [&compressor]() {
+        std::vector<std::unique_ptr<Compressor>> compressors;
+        if (compressor != nullptr) {
+          compressors.push_back(std::move(compressor));
+        }
+        return compressors;
+      }()) {}
+
+inline PullSerializer::PullSerializer(
+    int const chunk_size,
+    int const number_of_chunks,
+    std::vector<std::unique_ptr<Compressor>> compressors)
+    : compressors_(std::move(compressors)),
       chunk_size_(chunk_size),
       compressed_chunk_size_(
-          compressor_ == nullptr
+          compressors_.empty()
               ? chunk_size_
-              : compressor_->MaxCompressedLength(chunk_size_)),
+              : compressors_.front()->MaxCompressedLength(chunk_size_)),
       number_of_chunks_(number_of_chunks),
-      number_of_compression_chunks_(compressor_ == nullptr ? 0 : 1),
+      number_of_compression_chunks_(compressors_.empty() ? 0 : 1),
       data_(std::make_unique<std::uint8_t[]>(compressed_chunk_size_ *
                                              number_of_chunks_)),
       stream_(Array<std::uint8_t>(data_.get(), chunk_size_),
@@ -80,16 +93,24 @@ inline PullSerializer::PullSerializer(int const chunk_size,
   // Check the compatibility of the wait conditions in Push and Pull.
   CHECK_GT(number_of_chunks_ - number_of_compression_chunks_ - 1, 1);
 
-  // Mark all the chunks as free except the last one which is a sentinel for the
-  // |queue_|.  The 0th chunk has been passed to the stream, but it's still free
-  // until the first call to |on_full|.  Note that the last
-  // |compressed_chunk_size_ - chunk_size_| bytes of each chunk are not
-  // considered as free.
+  // Mark all the chunks as free except the last one which is considered as
+  // pulled, so that the first call to |Pull| frees it.  The 0th chunk has been
+  // passed to the stream, but it's still free until the first call to
+  // |on_full|.  Note that the last |compressed_chunk_size_ - chunk_size_| bytes
+  // of each chunk are not considered as free.
   for (int i = 0; i < number_of_chunks_ - 1; ++i) {
     free_.push(data_.get() + i * compressed_chunk_size_);
   }
-  queue_.push(Array<std::uint8_t>(
-      data_.get() + (number_of_chunks_ - 1) * compressed_chunk_size_, 0));
+  pulled_ = Array<std::uint8_t>(
+      data_.get() + (number_of_chunks_ - 1) * compressed_chunk_size_, 0);
+
+  if (!compressors_.empty()) {
+    for (auto const& compressor : compressors_) {
+      idle_compressors_.push_back(compressor.get());
+    }
+    compression_pool_ = std::make_unique<ThreadPool<Array<std::uint8_t>>>(
+        compressors_.size());
+  }
 }
 
 inline PullSerializer::~PullSerializer() {
@@ -110,80 +131,118 @@ inline void PullSerializer::Start(
   message_ = message;
   thread_ = std::make_unique<std::thread>([this](){
     CHECK(message_->SerializeToZeroCopyStream(&stream_));
-    // Put a sentinel at the end of the serialized stream so that the client
-    // knows that this is the end.
-    Array<std::uint8_t> bytes;
-    {
-      absl::MutexLock l(&lock_);
-      CHECK(!free_.empty());
-      bytes = Array<std::uint8_t>(free_.front(), 0);
-    }
-    Push(bytes);
+    PushEndOfStream();
   });
 }
 
+inline void PullSerializer::Start(
+    std::function<google::protobuf::Message const*()> next_message) {
+  CHECK(thread_ == nullptr);
+  thread_ = std::make_unique<std::thread>(
+      [this, next_message = std::move(next_message)]() {
+        {
+          // A single coded stream is used for all the messages so that we
+          // don't produce a short chunk at the end of each of them.
+          google::protobuf::io::CodedOutputStream coded_stream(&stream_);
+          for (auto* message = next_message();
+               message != nullptr;
+               message = next_message()) {
+            CHECK(message->SerializePartialToCodedStream(&coded_stream));
+          }
+        }
+        PushEndOfStream();
+      });
+}
+
 inline Array<std::uint8_t> PullSerializer::Pull() {
-  Array<std::uint8_t> result;
+  std::future<Array<std::uint8_t>> next;
   {
     absl::MutexLock l(&lock_);
 
-    // The element at the front of the queue is the one that was last returned
-    // by |Pull| and must be dropped and freed.
-    auto const queue_has_elements = [this]() { return queue_.size() > 1; };
+    // The chunk that was last returned by |Pull| must be freed.
+    free_.push(pulled_.data);
+
+    auto const queue_has_elements = [this]() { return !queue_.empty(); };
     lock_.Await(absl::Condition(&queue_has_elements));
 
-    CHECK_LE(2, queue_.size());
-    free_.push(queue_.front().data);
+    next = std::move(queue_.front());
     queue_.pop();
-    result = queue_.front();
-    CHECK_EQ(number_of_chunks_, queue_.size() + free_.size());
+    CHECK_EQ(number_of_chunks_,
+             queue_.size() + free_.size() + compressions_in_progress_ + 1);
   }
-  return result;
+  // Wait for the compression of the chunk, if any, without holding the lock as
+  // the compression needs it to complete.
+  pulled_ = next.get();
+  return pulled_;
 }
 
 inline Array<std::uint8_t> PullSerializer::Push(Array<std::uint8_t> bytes) {
-  Array<std::uint8_t> result;
   CHECK_GE(chunk_size_, bytes.size);
-  if (bytes.size > 0 && compressor_ != nullptr) {
-    Array<std::uint8_t> compressed_bytes;
-    {
-      absl::MutexLock l(&lock_);
-      CHECK_LE(1 + number_of_compression_chunks_, free_.size());
-      free_.pop();
-      compressed_bytes =
-          Array<std::uint8_t>(free_.front(), compressed_chunk_size_);
-      free_.push(bytes.data);
-    }
-    // We maintain the invariant that the chunk being filled is at the front of
-    // the |free_| queue.
-    ArraySource<std::uint8_t> source(bytes);
-    ArraySink<std::uint8_t> sink(compressed_bytes);
-    compressor_->CompressStream(&source, &sink);
-    {
-      absl::MutexLock l(&lock_);
-      bytes = sink.array();
-    }
+  bool const must_compress = bytes.size > 0 && !compressors_.empty();
+  absl::MutexLock l(&lock_);
+
+  // We need a free entry for |result|, in addition to the chunk being filled
+  // and to the chunk that receives the output of the compression (if
+  // needed).
+  auto const has_free_chunks = [this, must_compress]() {
+    return free_.size() >= static_cast<std::size_t>(
+                               2 + (must_compress ? 1 : 0));
+  };
+  lock_.Await(absl::Condition(&has_free_chunks));
+
+  // We maintain the invariant that the chunk being filled is at the front of
+  // the |free_| queue.
+  CHECK_EQ(free_.front(), bytes.data);
+  free_.pop();
+  if (must_compress) {
+    Array<std::uint8_t> const compressed_bytes(free_.front(),
+                                               compressed_chunk_size_);
+    free_.pop();
+    ++compressions_in_progress_;
+    queue_.push(compression_pool_->Add(
+        std::bind(&PullSerializer::Compress, this, bytes, compressed_bytes)));
+  } else {
+    std::promise<Array<std::uint8_t>> promise;
+    promise.set_value(bytes);
+    queue_.push(promise.get_future());
   }
+  return Array<std::uint8_t>(free_.front(), chunk_size_);
+}
+
+inline Array<std::uint8_t> PullSerializer::Compress(
+    Array<std::uint8_t> const bytes,
+    Array<std::uint8_t> const compressed_bytes) {
+  // There are as many compressors as threads in the |compression_pool_|, so one
+  // must be idle.
+  Compressor* compressor;
+  {
+    absl::MutexLock l(&lock_);
+    CHECK(!idle_compressors_.empty());
+    compressor = idle_compressors_.back();
+    idle_compressors_.pop_back();
+  }
+  ArraySource<std::uint8_t> source(bytes);
+  ArraySink<std::uint8_t> sink(compressed_bytes);
+  compressor->CompressStream(&source, &sink);
   {
     absl::MutexLock l(&lock_);
+    idle_compressors_.push_back(compressor);
+    free_.push(bytes.data);
+    --compressions_in_progress_;
+  }
+  return sink.array();
+}
 
-    auto const queue_has_room = [this]() {
-      // -1 here is because we want to ensure that there is an entry in the
-      // free list, in addition to |result| and to
-      // |number_of_compression_chunks_| (if present).
-      return queue_.size() < static_cast<std::size_t>(number_of_chunks_) -
-                                 number_of_compression_chunks_ - 1;
-    };
-    lock_.Await(absl::Condition(&queue_has_room));
-
-    queue_.emplace(bytes.data, bytes.size);
-    CHECK_LE(2 + number_of_compression_chunks_, free_.size());
-    CHECK_EQ(free_.front(), bytes.data);
-    free_.pop();
-    result = Array<std::uint8_t>(free_.front(), chunk_size_);
-    CHECK_EQ(number_of_chunks_, queue_.size() + free_.size());
+inline void PullSerializer::PushEndOfStream() {
+  // Put a sentinel at the end of the serialized stream so that the client
+  // knows that this is the end.
+  Array<std::uint8_t> bytes;
+  {
+    absl::MutexLock l(&lock_);
+    CHECK(!free_.empty());
+    bytes = Array<std::uint8_t>(free_.front(), 0);
   }
-  return result;
+  Push(bytes);
 }
 
 }  // namespace internal_pull_serializer
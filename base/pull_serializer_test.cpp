@@ -124,6 +124,45 @@ TEST_F(PullSerializerTest, SerializationSizes) {
   EXPECT_THAT(actual_sizes, ElementsAreArray(expected_sizes));
 }
 
+TEST_F(PullSerializerTest, SerializationOfSeveralMessages) {
+  std::vector<not_null<std::unique_ptr<DiscreteTrajectory const>>>
+      trajectories;
+  for (int i = 0; i < 3; ++i) {
+    trajectories.push_back(BuildTrajectory());
+  }
+  int next_trajectory = 0;
+  pull_serializer_->Start(
+      [&next_trajectory, &trajectories]() -> google::protobuf::Message const* {
+        if (next_trajectory == trajectories.size()) {
+          return nullptr;
+        }
+        return trajectories[next_trajectory++].get();
+      });
+
+  // The chunks are full, irrespective of the boundaries between messages.
+  std::vector<std::int64_t> actual_sizes;
+  std::vector<std::int64_t> expected_sizes(160, chunk_size);
+  expected_sizes.push_back(60);
+  std::string serialized;
+  for (;;) {
+    Array<std::uint8_t> const bytes = pull_serializer_->Pull();
+    if (bytes.size == 0) {
+      break;
+    }
+    actual_sizes.push_back(bytes.size);
+    serialized.append(reinterpret_cast<char const*>(bytes.data),
+                      static_cast<std::size_t>(bytes.size));
+  }
+  EXPECT_THAT(actual_sizes, ElementsAreArray(expected_sizes));
+
+  // Parsing the stream merges the messages.
+  DiscreteTrajectory read_trajectory;
+  EXPECT_TRUE(read_trajectory.ParseFromString(serialized));
+  EXPECT_EQ(300, read_trajectory.timeline_size());
+  EXPECT_EQ(3 * 99,
+            read_trajectory.timeline(299).instant().scalar().magnitude());
+}
+
 TEST_F(PullSerializerTest, SerializationGipfeli) {
   std::string uncompressed1;
   std::string uncompressed2;
@@ -2,15 +2,19 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <memory>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "base/array.hpp"
 #include "base/macros.hpp"
 #include "base/not_null.hpp"
+#include "base/thread_pool.hpp"
 #include "gipfeli/compression.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/io/zero_copy_stream.h"
@@ -63,6 +67,16 @@ class PushDeserializer final {
   PushDeserializer(int chunk_size,
                    int number_of_chunks,
                    std::unique_ptr<Compressor> compressor);
+
+  // Same as above, but the chunks are uncompressed in parallel as soon as they
+  // are pushed, using one thread for each element of |compressors|
+  // (compressors are not thread-safe).  The uncompressed chunks are consumed in
+  // the order in which they were pushed.  No uncompression takes place if
+  // |compressors| is empty.  The uncompressed data use
+  // |(compressors.size() + 1) * chunk_size| bytes.
+  PushDeserializer(int chunk_size,
+                   int number_of_chunks,
+                   std::vector<std::unique_ptr<Compressor>> compressors);
   ~PushDeserializer();
 
   // Starts the deserializer, which will proceed to deserialize data into
@@ -93,12 +107,17 @@ class PushDeserializer final {
   // |DelegatingArrayOutputStream|.
   Array<std::uint8_t> Pull();
 
+  // Uncompresses |bytes| into |uncompressed_bytes| using one of the
+  // |idle_compressors_|.  Runs on the |uncompression_pool_|.
+  Array<std::uint8_t> Uncompress(Array<std::uint8_t> bytes,
+                                 Array<std::uint8_t> uncompressed_bytes);
+
   // |owned_message_| is null if this object doesn't own the message.
   // |message_| is non-null after Start.
   std::unique_ptr<google::protobuf::Message> owned_message_;
   google::protobuf::Message* message_ = nullptr;
 
-  std::unique_ptr<Compressor> const compressor_;
+  std::vector<std::unique_ptr<Compressor>> const compressors_;
 
   // The chunk size passed at construction.  The stream consumes chunks of that
   // size.
@@ -109,23 +128,47 @@ class PushDeserializer final {
   // maximum size of the chunks passed to |Push| by the client.
   int const compressed_chunk_size_;
 
-  // The number of chunks passed at construction, used to size |data_|.
+  // The number of chunks passed at construction, used to bound the size of
+  // |queue_|.
   int const number_of_chunks_;
 
+  // The chunks of size |chunk_size_| that receive the uncompressed data, one
+  // for each element of |compressors_| plus one for the chunk being
+  // deserialized.  Empty in the absence of compression.  A chunk to be
+  // uncompressed is only pushed once one of these is free, so this bounds the
+  // number of chunks in flight independently of |number_of_chunks_|.
   UniqueArray<std::uint8_t> uncompressed_data_;
 
   DelegatingArrayInputStream stream_;
   std::unique_ptr<std::thread> thread_;
 
+  // The uncompressed chunk last returned by |Pull|, if any.  It is freed by the
+  // next call to |Pull|, once the stream is done with it.  Only accessed by
+  // |Pull|.
+  std::uint8_t* pulled_ = nullptr;
+
   absl::Mutex lock_;
 
-  // The |queue_| contains the |Array<std::uint8_t>| object filled by |Push| and
-  // not yet consumed by |Pull|.  The |done_| queue contains the callbacks.  The
-  // two queues are out of step: an element is removed from |queue_| by |Pull|
-  // when it returns a chunk to the stream, but the corresponding callback is
-  // removed from |done_| (and executed) when |Pull| returns.
-  std::queue<Array<std::uint8_t>> queue_ GUARDED_BY(lock_);
+  // The |queue_| contains the (future) |Array<std::uint8_t>| object filled by
+  // |Push| and not yet consumed by |Pull|.  The futures are not ready while the
+  // corresponding chunks are being uncompressed.  The |done_| queue contains
+  // the callbacks.  The two queues are out of step: an element is removed from
+  // |queue_| by |Pull| when it returns a chunk to the stream, but the
+  // corresponding callback is removed from |done_| (and executed) when |Pull|
+  // returns.
+  std::queue<std::future<Array<std::uint8_t>>> queue_ GUARDED_BY(lock_);
   std::queue<std::function<void()>> done_ GUARDED_BY(lock_);
+
+  // The start addresses of the chunks of |uncompressed_data_| that are neither
+  // being uncompressed nor in |queue_| nor being deserialized.
+  std::queue<not_null<std::uint8_t*>> free_ GUARDED_BY(lock_);
+
+  // The compressors that are not in use by an uncompression.
+  std::vector<not_null<Compressor*>> idle_compressors_ GUARDED_BY(lock_);
+
+  // The threads that uncompress the chunks.  Null in the absence of
+  // compression.  Declared last so that it is destroyed first.
+  std::unique_ptr<ThreadPool<Array<std::uint8_t>>> uncompression_pool_;
 };
 
 }  // namespace internal_push_deserializer
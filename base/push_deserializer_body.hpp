@@ -79,17 +79,44 @@ inline PushDeserializer::PushDeserializer(
     int const chunk_size,
     int const number_of_chunks,
     std::unique_ptr<Compressor> compressor)
-    : compressor_(std::move(compressor)),
+    : PushDeserializer(chunk_size, number_of_chunks, [&compressor]() {
+        std::vector<std::unique_ptr<Compressor>> compressors;
+        if (compressor != nullptr) {
+          compressors.push_back(std::move(compressor));
+        }
+        return compressors;
+      }()) {}
+
+inline PushDeserializer::PushDeserializer(
+    int const chunk_size,
+    int const number_of_chunks,
+    std::vector<std::unique_ptr<Compressor>> compressors)
+    : compressors_(std::move(compressors)),
       chunk_size_(chunk_size),
       compressed_chunk_size_(
-          compressor_ == nullptr
+          compressors_.empty()
               ? chunk_size_
-              : compressor_->MaxCompressedLength(chunk_size_)),
+              : compressors_.front()->MaxCompressedLength(chunk_size_)),
       number_of_chunks_(number_of_chunks),
-      uncompressed_data_(chunk_size_),
+      uncompressed_data_(
+          compressors_.empty() ? 0
+                               : chunk_size_ * (compressors_.size() + 1)),
       stream_(std::bind(&PushDeserializer::Pull, this)) {
   // This sentinel ensures that the two queue are correctly out of step.
   done_.push(nullptr);
+
+  if (!compressors_.empty()) {
+    // One chunk for each uncompression in flight, plus the one being
+    // deserialized.
+    for (int i = 0; i <= compressors_.size(); ++i) {
+      free_.push(&uncompressed_data_.data[i * chunk_size_]);
+    }
+    for (auto const& compressor : compressors_) {
+      idle_compressors_.push_back(compressor.get());
+    }
+    uncompression_pool_ = std::make_unique<ThreadPool<Array<std::uint8_t>>>(
+        compressors_.size());
+  }
 }
 
 inline PushDeserializer::~PushDeserializer() {
@@ -150,7 +177,7 @@ inline void PushDeserializer::Push(Array<std::uint8_t> const bytes,
   // absence of compression we have a stream so we can cut into as many chunks
   // as we like.
   int queued_chunk_size;
-  if (compressor_ == nullptr) {
+  if (compressors_.empty()) {
     queued_chunk_size = chunk_size_;
   } else {
     CHECK_LE(bytes.size, compressed_chunk_size_);
@@ -161,16 +188,31 @@ inline void PushDeserializer::Push(Array<std::uint8_t> const bytes,
   do {
     {
       is_last = current.size <= queued_chunk_size;
+      Array<std::uint8_t> const chunk(
+          current.data,
+          std::min(current.size, static_cast<std::int64_t>(queued_chunk_size)));
+      bool const must_uncompress = chunk.size > 0 && !compressors_.empty();
       absl::MutexLock l(&lock_);
 
-      auto const queue_has_room = [this]() {
-        return queue_.size() < static_cast<std::size_t>(number_of_chunks_);
+      // A chunk to be uncompressed also needs a free chunk for the output of
+      // the uncompression.
+      auto const queue_has_room = [this, must_uncompress]() {
+        return queue_.size() < static_cast<std::size_t>(number_of_chunks_) &&
+               !(must_uncompress && free_.empty());
       };
       lock_.Await(absl::Condition(&queue_has_room));
 
-      queue_.emplace(current.data,
-                     std::min(current.size,
-                              static_cast<std::int64_t>(queued_chunk_size)));
+      if (must_uncompress) {
+        Array<std::uint8_t> const uncompressed_chunk(free_.front(),
+                                                     chunk_size_);
+        free_.pop();
+        queue_.push(uncompression_pool_->Add(std::bind(
+            &PushDeserializer::Uncompress, this, chunk, uncompressed_chunk)));
+      } else {
+        std::promise<Array<std::uint8_t>> promise;
+        promise.set_value(chunk);
+        queue_.push(promise.get_future());
+      }
       done_.emplace(is_last ? std::move(done) : nullptr);
     }
     current.data = &current.data[queued_chunk_size];
@@ -186,10 +228,16 @@ inline void PushDeserializer::Push(UniqueArray<std::uint8_t> bytes) {
 }
 
 inline Array<std::uint8_t> PushDeserializer::Pull() {
-  Array<std::uint8_t> result;
+  std::future<Array<std::uint8_t>> next;
   {
     absl::MutexLock l(&lock_);
 
+    // The stream is done with the chunk that was last returned by |Pull|.
+    if (pulled_ != nullptr) {
+      free_.push(pulled_);
+      pulled_ = nullptr;
+    }
+
     auto const queue_has_elements =  [this]() { return !queue_.empty(); };
     lock_.Await(absl::Condition(&queue_has_elements));
 
@@ -202,21 +250,41 @@ inline Array<std::uint8_t> PushDeserializer::Pull() {
     }
     done_.pop();
     // Get the next |Array<std::uint8_t>| object to process and remove it from
-    // |queue_|.  Uncompress it if needed.
-    auto const& front = queue_.front();
-    if (front.size == 0 || compressor_ == nullptr) {
-      result = front;
-    } else {
-      ArraySource<std::uint8_t> source(front);
-      ArraySink<std::uint8_t> sink(uncompressed_data_.get());
-      CHECK(compressor_->UncompressStream(&source, &sink));
-      result = sink.array();
-    }
+    // |queue_|.
+    next = std::move(queue_.front());
     queue_.pop();
   }
+  // Wait for the uncompression of the chunk, if any, without holding the lock
+  // as the uncompression needs it to complete.
+  Array<std::uint8_t> const result = next.get();
+  if (result.size > 0 && !compressors_.empty()) {
+    pulled_ = result.data;
+  }
   return result;
 }
 
+inline Array<std::uint8_t> PushDeserializer::Uncompress(
+    Array<std::uint8_t> const bytes,
+    Array<std::uint8_t> const uncompressed_bytes) {
+  // There are as many compressors as threads in the |uncompression_pool_|, so
+  // one must be idle.
+  Compressor* compressor;
+  {
+    absl::MutexLock l(&lock_);
+    CHECK(!idle_compressors_.empty());
+    compressor = idle_compressors_.back();
+    idle_compressors_.pop_back();
+  }
+  ArraySource<std::uint8_t> source(bytes);
+  ArraySink<std::uint8_t> sink(uncompressed_bytes);
+  CHECK(compressor->UncompressStream(&source, &sink));
+  {
+    absl::MutexLock l(&lock_);
+    idle_compressors_.push_back(compressor);
+  }
+  return sink.array();
+}
+
 }  // namespace internal_push_deserializer
 }  // namespace base
 }  // namespace principia
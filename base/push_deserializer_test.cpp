@@ -303,6 +303,58 @@ TEST_F(PushDeserializerTest, SerializationDeserialization) {
       /*deserializer_compressor=*/google::compression::NewGipfeliCompressor());
 }
 
+// Compression and uncompression on several threads must preserve the order of
+// the chunks.
+TEST_F(PushDeserializerTest, ParallelCompression) {
+  for (int i = 0; i < runs_per_test; ++i) {
+    std::vector<std::unique_ptr<Compressor>> serializer_compressors;
+    std::vector<std::unique_ptr<Compressor>> deserializer_compressors;
+    for (int j = 0; j < 3; ++j) {
+      serializer_compressors.push_back(
+          google::compression::NewGipfeliCompressor());
+      deserializer_compressors.push_back(
+          google::compression::NewGipfeliCompressor());
+    }
+    auto read_trajectory = make_not_null_unique<DiscreteTrajectory>();
+    auto written_trajectory = BuildTrajectory();
+    std::list<std::string> compressed_chunks;
+
+    pull_serializer_ =
+        std::make_unique<PullSerializer>(serializer_chunk_size,
+                                         /*number_of_chunks=*/8,
+                                         std::move(serializer_compressors));
+    push_deserializer_ =
+        std::make_unique<PushDeserializer>(
+            deserializer_chunk_size,
+            number_of_chunks,
+            std::move(deserializer_compressors));
+
+    pull_serializer_->Start(std::move(written_trajectory));
+    push_deserializer_->Start(std::move(read_trajectory),
+                              PushDeserializerTest::CheckSerialization);
+    for (;;) {
+      Array<std::uint8_t> const bytes = pull_serializer_->Pull();
+      compressed_chunks.emplace_back(reinterpret_cast<char const*>(bytes.data),
+                                     static_cast<std::size_t>(bytes.size));
+      auto& chunk = compressed_chunks.back();
+      Array<std::uint8_t> const chunk_bytes(
+          reinterpret_cast<std::uint8_t*>(&chunk[0]),
+          static_cast<std::int64_t>(chunk.size()));
+      push_deserializer_->Push(chunk_bytes,
+                               std::bind(&PushDeserializerTest::Stomp,
+                                         chunk_bytes));
+      if (bytes.size == 0) {
+        break;
+      }
+    }
+
+    // Destroying the deserializer waits until deserialization is done.  It is
+    // important that this happens before |compressed_chunks| is destroyed.
+    pull_serializer_.reset();
+    push_deserializer_.reset();
+  }
+}
+
 // Check that deserialization fails if we stomp on one extra byte.
 TEST_F(PushDeserializerDeathTest, Stomp) {
   EXPECT_DEATH({
@@ -0,0 +1,81 @@
+﻿
+// .\Release\x64\benchmarks.exe --benchmark_repetitions=3 --benchmark_filter=DiscreteTrajectory  // NOLINT(whitespace/line_length)
+
+#include "physics/discrete_trajectory.hpp"
+
+#include "benchmark/benchmark.h"
+#include "geometry/frame.hpp"
+#include "geometry/named_quantities.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "serialization/geometry.pb.h"
+
+namespace principia {
+namespace physics {
+
+using geometry::Frame;
+using geometry::Instant;
+using geometry::Velocity;
+using quantities::Length;
+using quantities::si::Metre;
+using quantities::si::Second;
+
+namespace {
+
+using World = Frame<serialization::Frame::TestTag,
+                    serialization::Frame::TEST, true>;
+
+// Appends |size| points to |trajectory|, one second apart, on a straight line.
+void Fill(std::int64_t const size, DiscreteTrajectory<World>& trajectory) {
+  Velocity<World> const v({1 * Metre / Second,
+                           2 * Metre / Second,
+                           3 * Metre / Second});
+  for (std::int64_t i = 0; i < size; ++i) {
+    Instant const t = Instant() + i * Second;
+    trajectory.Append(t,
+                      {World::origin + v * (t - Instant()), v});
+  }
+}
+
+}  // namespace
+
+void BM_DiscreteTrajectoryAppend(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    DiscreteTrajectory<World> trajectory;
+    Fill(state.range_x(), trajectory);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+void BM_DiscreteTrajectoryIterate(benchmark::State& state) {
+  DiscreteTrajectory<World> trajectory;
+  Fill(state.range_x(), trajectory);
+  while (state.KeepRunning()) {
+    Length sum;
+    for (auto it = trajectory.Begin(); it != trajectory.End(); ++it) {
+      sum += (it.degrees_of_freedom().position() - World::origin).Norm();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+
+void BM_DiscreteTrajectoryEvaluatePosition(benchmark::State& state) {
+  DiscreteTrajectory<World> trajectory;
+  Fill(state.range_x(), trajectory);
+  Instant const t_min = trajectory.t_min();
+  Instant const t_max = trajectory.t_max();
+  while (state.KeepRunning()) {
+    for (Instant t = t_min; t < t_max; t += (t_max - t_min) / 1000) {
+      benchmark::DoNotOptimize(trajectory.EvaluatePosition(t));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+BENCHMARK(BM_DiscreteTrajectoryAppend)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_DiscreteTrajectoryIterate)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_DiscreteTrajectoryEvaluatePosition)->Range(1 << 10, 1 << 20);
+
+}  // namespace physics
+}  // namespace principia
@@ -83,10 +83,12 @@ double HarmonicOscillatorToleranceRatio3D(
 }  // namespace
 
 template<typename Integrator>
-void SolveHarmonicOscillatorAndComputeError1D(benchmark::State& state,
-                                              Length& q_error,
-                                              Speed& v_error,
-                                              Integrator const& integrator) {
+void SolveHarmonicOscillatorAndComputeError1D(
+    benchmark::State& state,
+    Length& q_error,
+    Speed& v_error,
+    Integrator const& integrator,
+    bool const inline_right_hand_side) {
   using ODE = SpecialSecondOrderDifferentialEquation<Length>;
 
   Length const q_initial = 1 * Metre;
@@ -98,9 +100,14 @@ void SolveHarmonicOscillatorAndComputeError1D(benchmark::State& state,
 
   std::vector<ODE::SystemState> solution;
   ODE harmonic_oscillator;
-  harmonic_oscillator.compute_acceleration =
-      std::bind(ComputeHarmonicOscillatorAcceleration1D,
-                _1, _2, _3, /*evaluations=*/nullptr);
+  auto const compute_acceleration =
+      [](Instant const& t,
+         std::vector<typename ODE::Position> const& q,
+         std::vector<typename ODE::Acceleration>& result) {
+        return ComputeHarmonicOscillatorAcceleration1D(
+            t, q, result, /*evaluations=*/nullptr);
+      };
+  harmonic_oscillator.compute_acceleration = compute_acceleration;
   IntegrationProblem<ODE> problem;
   problem.equation = harmonic_oscillator;
   problem.initial_state = {{q_initial}, {v_initial}, t_initial};
@@ -115,10 +122,17 @@ void SolveHarmonicOscillatorAndComputeError1D(benchmark::State& state,
       std::bind(HarmonicOscillatorToleranceRatio1D<ODE>,
                 _1, _2, length_tolerance, speed_tolerance);
 
-  auto const instance = integrator.NewInstance(problem,
-                                               append_state,
-                                               tolerance_to_error_ratio,
-                                               parameters);
+  auto const instance =
+      inline_right_hand_side
+          ? integrator.NewInstance(problem,
+                                   compute_acceleration,
+                                   append_state,
+                                   tolerance_to_error_ratio,
+                                   parameters)
+          : integrator.NewInstance(problem,
+                                   append_state,
+                                   tolerance_to_error_ratio,
+                                   parameters);
   instance->Solve(t_final);
 
   state.PauseTiming();
@@ -144,7 +158,8 @@ void SolveHarmonicOscillatorAndComputeError3D(
     benchmark::State& state,
     Length& q_error,
     Speed& v_error,
-    Integrator const& integrator) {
+    Integrator const& integrator,
+    bool const inline_right_hand_side) {
   using ODE = SpecialSecondOrderDifferentialEquation<Position<World>>;
 
   Displacement<World> const q_initial({1 * Metre, 0 * Metre, 0 * Metre});
@@ -157,9 +172,14 @@ void SolveHarmonicOscillatorAndComputeError3D(
 
   std::vector<ODE::SystemState> solution;
   ODE harmonic_oscillator;
-  harmonic_oscillator.compute_acceleration =
-      std::bind(ComputeHarmonicOscillatorAcceleration3D<World>,
-                _1, _2, _3, /*evaluations=*/nullptr);
+  auto const compute_acceleration =
+      [](Instant const& t,
+         std::vector<typename ODE::Position> const& q,
+         std::vector<typename ODE::Acceleration>& result) {
+        return ComputeHarmonicOscillatorAcceleration3D<World>(
+            t, q, result, /*evaluations=*/nullptr);
+      };
+  harmonic_oscillator.compute_acceleration = compute_acceleration;
   IntegrationProblem<ODE> problem;
   problem.equation = harmonic_oscillator;
   problem.initial_state = {{World::origin + q_initial}, {v_initial}, t_initial};
@@ -174,10 +194,17 @@ void SolveHarmonicOscillatorAndComputeError3D(
       std::bind(HarmonicOscillatorToleranceRatio3D<ODE>,
                 _1, _2, length_tolerance, speed_tolerance);
 
-  auto const instance = integrator.NewInstance(problem,
-                                               append_state,
-                                               tolerance_to_error_ratio,
-                                               parameters);
+  auto const instance =
+      inline_right_hand_side
+          ? integrator.NewInstance(problem,
+                                   compute_acceleration,
+                                   append_state,
+                                   tolerance_to_error_ratio,
+                                   parameters)
+          : integrator.NewInstance(problem,
+                                   append_state,
+                                   tolerance_to_error_ratio,
+                                   parameters);
   instance->Solve(t_final);
 
   state.PauseTiming();
@@ -201,6 +228,9 @@ void SolveHarmonicOscillatorAndComputeError3D(
 template<typename Method, typename Position>
 void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator1D(
     benchmark::State& state) {
+  // 0 to call the right-hand side through an |std::function|, 1 to have it
+  // inlined in the integration loop.
+  bool const inline_right_hand_side = state.range(0) != 0;
   Length q_error;
   Speed v_error;
   while (state.KeepRunning()) {
@@ -208,7 +238,8 @@ void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator1D(
         state,
         q_error,
         v_error,
-        EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>());
+        EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>(),
+        inline_right_hand_side);
   }
   std::stringstream ss;
   ss << q_error << ", " << v_error;
@@ -218,6 +249,9 @@ void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator1D(
 template<typename Method, typename Position>
 void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D(
     benchmark::State& state) {
+  // 0 to call the right-hand side through an |std::function|, 1 to have it
+  // inlined in the integration loop.
+  bool const inline_right_hand_side = state.range(0) != 0;
   Length q_error;
   Speed v_error;
   while (state.KeepRunning()) {
@@ -225,7 +259,8 @@ void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D(
         state,
         q_error,
         v_error,
-        EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>());
+        EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>(),
+        inline_right_hand_side);
   }
   std::stringstream ss;
   ss << q_error << ", " << v_error;
@@ -236,11 +271,12 @@ void BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D(
 
 BENCHMARK_TEMPLATE2(
     BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator1D,
-    methods::DormandالمكاوىPrince1986RKN434FM, Length);
+    methods::DormandالمكاوىPrince1986RKN434FM, Length)->Arg(0)->Arg(1);
 
 BENCHMARK_TEMPLATE2(
     BM_EmbeddedExplicitRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D,
-    methods::DormandالمكاوىPrince1986RKN434FM, Position<World>);
+    methods::DormandالمكاوىPrince1986RKN434FM, Position<World>)
+    ->Arg(0)->Arg(1);
 
 }  // namespace integrators
 }  // namespace principia
@@ -2,15 +2,19 @@
 // .\Release\x64\benchmarks.exe --benchmark_repetitions=3 --benchmark_filter=Ephemeris                                                                     // NOLINT(whitespace/line_length)
 
 #include <cmath>
+#include <cstdint>
+#include <filesystem>
 #include <limits>
 #include <list>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "astronomy/frames.hpp"
 #include "astronomy/stabilize_ksp.hpp"
 #include "base/not_null.hpp"
+#include "base/status.hpp"
 #include "base/thread_pool.hpp"
 #include "benchmark/benchmark.h"
 #include "geometry/named_quantities.hpp"
@@ -22,9 +26,11 @@
 #include "integrators/symmetric_linear_multistep_integrator.hpp"
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
 #include "ksp_plugin/frames.hpp"
+#include "physics/continuous_trajectory.hpp"
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
+#include "physics/ephemeris_cache.hpp"
 #include "physics/massless_body.hpp"
 #include "quantities/astronomy.hpp"
 #include "quantities/bipm.hpp"
@@ -39,6 +45,7 @@ namespace principia {
 using astronomy::ICRS;
 using base::make_not_null_unique;
 using base::not_null;
+using base::Status;
 using base::ThreadPool;
 using geometry::Bivector;
 using geometry::DefinesFrame;
@@ -395,6 +402,175 @@ void BM_EphemerisMultithreadingBenchmark(benchmark::State& state) {
   state.SetLabel(ss.str());
 }
 
+// Integrates |state.range(0)| probes in a single fixed-step instance.  If
+// |state.range(1)| is positive, the accelerations on the probes are computed on
+// a thread pool of that size.
+void BM_EphemerisManyProbes(benchmark::State& state) {
+  auto const at_спутник_1_launch =
+      SolarSystemAtСпутник1Launch(
+          SolarSystemFactory::Accuracy::MajorBodiesOnly);
+  Instant const epoch = at_спутник_1_launch->epoch();
+  auto const ephemeris =
+      at_спутник_1_launch->MakeEphemeris(1 * Milli(Metre),
+                                         EphemerisParameters());
+  std::string const& earth_name =
+      SolarSystemFactory::name(SolarSystemFactory::Earth);
+  auto const earth_massive_body =
+      at_спутник_1_launch->massive_body(*ephemeris, earth_name);
+  auto const earth_degrees_of_freedom =
+      at_спутник_1_launch->degrees_of_freedom(earth_name);
+
+  MasslessBody probe;
+  std::list<DiscreteTrajectory<Barycentric>> trajectories;
+  std::vector<not_null<DiscreteTrajectory<Barycentric>*>> unowned_trajectories;
+  for (int i = 0; i < state.range(0); ++i) {
+    KeplerianElements<Barycentric> elements;
+    elements.eccentricity = 0;
+    elements.semimajor_axis = 7'000 * Kilo(Metre) + i * 10 * Kilo(Metre);
+    elements.inclination = 0 * Radian;
+    elements.longitude_of_ascending_node = 0 * Radian;
+    elements.argument_of_periapsis = 0 * Radian;
+    elements.true_anomaly = i * Radian;
+    KeplerOrbit<Barycentric> const orbit(
+        *earth_massive_body, probe, elements, epoch);
+    trajectories.emplace_back();
+    auto& trajectory = trajectories.back();
+    trajectory.Append(epoch,
+                      earth_degrees_of_freedom + orbit.StateVectors(epoch));
+    unowned_trajectories.push_back(&trajectory);
+  }
+
+  std::optional<ThreadPool<void>> pool;
+  if (state.range(1) > 0) {
+    pool.emplace(/*pool_size=*/state.range(1));
+  }
+  Ephemeris<Barycentric>::FixedStepParameters const parameters(
+      SymmetricLinearMultistepIntegrator<Quinlan1999Order8A,
+                                         Position<Barycentric>>(),
+      /*step=*/10 * Second);
+  auto const instance =
+      pool ? ephemeris->NewInstance(unowned_trajectories,
+                                    Ephemeris<Barycentric>::
+                                        NoIntrinsicAccelerations,
+                                    parameters,
+                                    &*pool)
+           : ephemeris->NewInstance(unowned_trajectories,
+                                    Ephemeris<Barycentric>::
+                                        NoIntrinsicAccelerations,
+                                    parameters);
+
+  Instant final_time = epoch;
+  while (state.KeepRunning()) {
+    final_time += 10 * Minute;
+    ephemeris->FlowWithFixedStep(final_time, *instance);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Evaluates the positions of all the bodies of the solar system at times 10
+// seconds apart, as is done when computing the accelerations on a vessel.  If
+// |state.range(0)| is 0, the trajectories are evaluated one by one, otherwise
+// they are evaluated together.
+void BM_EphemerisEvaluateAllPositions(benchmark::State& state) {
+  auto const at_спутник_1_launch =
+      SolarSystemAtСпутник1Launch(
+          SolarSystemFactory::Accuracy::MajorBodiesOnly);
+  Instant const epoch = at_спутник_1_launch->epoch();
+  auto const ephemeris =
+      at_спутник_1_launch->MakeEphemeris(1 * Milli(Metre),
+                                         EphemerisParameters());
+  ephemeris->Prolong(epoch + 1 * JulianYear);
+  std::vector<not_null<ContinuousTrajectory<Barycentric> const*>> trajectories;
+  for (auto const body : ephemeris->bodies()) {
+    trajectories.push_back(ephemeris->trajectory(body));
+  }
+
+  Instant t = epoch;
+  std::vector<Position<Barycentric>> positions;
+  while (state.KeepRunning()) {
+    t += 10 * Second;
+    if (t > ephemeris->t_max()) {
+      t = epoch;
+    }
+    if (state.range(0) == 0) {
+      positions.clear();
+      for (auto const trajectory : trajectories) {
+        positions.push_back(trajectory->EvaluatePosition(t));
+      }
+    } else {
+      positions = ephemeris->EvaluateAllPositions(t);
+    }
+    benchmark::DoNotOptimize(positions);
+  }
+  state.SetItemsProcessed(state.iterations() * trajectories.size());
+}
+
+// Restores an ephemeris of the solar system covering 10 years and evaluates
+// the position of each body at the end.  If |state.range(0)| is 0, the
+// ephemeris is deserialized from a protocol buffer, otherwise it is read from
+// an |EphemerisCache|.
+void BM_EphemerisCacheLoad(benchmark::State& state) {
+  std::uint64_t const fingerprint = 0xCAC4E;
+  std::filesystem::path const path =
+      std::filesystem::temp_directory_path() / "benchmark_ephemeris_cache.bin";
+  auto const at_спутник_1_launch =
+      SolarSystemAtСпутник1Launch(
+          SolarSystemFactory::Accuracy::MajorBodiesOnly);
+  Instant const final_time = at_спутник_1_launch->epoch() + 10 * JulianYear;
+  auto const ephemeris =
+      at_спутник_1_launch->MakeEphemeris(1 * Milli(Metre),
+                                         EphemerisParameters());
+  ephemeris->Prolong(final_time);
+  serialization::Ephemeris message;
+  ephemeris->WriteToMessage(&message);
+  CHECK_OK(EphemerisCache<Barycentric>::Write(*ephemeris, fingerprint, path));
+
+  Position<Barycentric> position;
+  while (state.KeepRunning()) {
+    if (state.range(0) == 0) {
+      auto const deserialized_ephemeris =
+          Ephemeris<Barycentric>::ReadFromMessage(message);
+      for (auto const body : deserialized_ephemeris->bodies()) {
+        position =
+            deserialized_ephemeris->trajectory(body)->EvaluatePosition(
+                final_time);
+      }
+    } else {
+      std::unique_ptr<EphemerisCache<Barycentric>> cache;
+      CHECK_OK(EphemerisCache<Barycentric>::Open(path, fingerprint, &cache));
+      for (int i = 0; i < cache->number_of_bodies(); ++i) {
+        position = cache->EvaluatePosition(i, final_time);
+      }
+    }
+    benchmark::DoNotOptimize(position);
+  }
+  std::filesystem::remove(path);
+}
+
+// Prolongs the ephemeris of the solar system by 10 years.  If |state.range(0)|
+// is positive, the polynomials are fitted on a thread pool of that size.
+void BM_EphemerisPipelinedFitting(benchmark::State& state) {
+  std::optional<ThreadPool<Status>> pool;
+  if (state.range(0) > 0) {
+    pool.emplace(/*pool_size=*/state.range(0));
+  }
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    auto const at_спутник_1_launch =
+        SolarSystemAtСпутник1Launch(
+            SolarSystemFactory::Accuracy::MajorBodiesOnly);
+    Instant const final_time = at_спутник_1_launch->epoch() + 10 * JulianYear;
+    auto const ephemeris =
+        at_спутник_1_launch->MakeEphemeris(1 * Milli(Metre),
+                                           EphemerisParameters());
+    if (pool) {
+      ephemeris->SetFittingThreadPool(&*pool);
+    }
+    state.ResumeTiming();
+    ephemeris->Prolong(final_time);
+  }
+}
+
 template<SolarSystemFactory::Accuracy accuracy, Flow* flow>
 void EphemerisL4ProbeBenchmark(Time const integration_duration,
                                benchmark::State& state) {
@@ -584,6 +760,18 @@ BENCHMARK(BM_EphemerisMultithreadingBenchmark)
     ->ArgPair(3, 3)
     ->ArgPair(3, 4)
     ->ArgPair(3, 5);
+BENCHMARK(BM_EphemerisManyProbes)
+    ->ArgPair(1, 0)
+    ->ArgPair(10, 0)
+    ->ArgPair(100, 0)
+    ->ArgPair(1000, 0)
+    ->ArgPair(1, 4)
+    ->ArgPair(10, 4)
+    ->ArgPair(100, 4)
+    ->ArgPair(1000, 4);
+BENCHMARK(BM_EphemerisEvaluateAllPositions)->Arg(0)->Arg(1);
+BENCHMARK(BM_EphemerisCacheLoad)->Arg(0)->Arg(1);
+BENCHMARK(BM_EphemerisPipelinedFitting)->Arg(0)->Arg(2)->Arg(4)->Arg(8);
 BENCHMARK(BM_EphemerisKSPSystem)->Arg(-3);
 BENCHMARK_TEMPLATE(BM_EphemerisSolarSystem,
                    SolarSystemFactory::Accuracy::MajorBodiesOnly)
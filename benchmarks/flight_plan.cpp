@@ -0,0 +1,186 @@
+﻿
+// .\Release\x64\benchmarks.exe --benchmark_repetitions=3 --benchmark_filter=FlightPlan  // NOLINT(whitespace/line_length)
+
+#include "ksp_plugin/flight_plan.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "integrators/embedded_explicit_generalized_runge_kutta_nyström_integrator.hpp"
+#include "integrators/embedded_explicit_runge_kutta_nyström_integrator.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "physics/body_centred_non_rotating_dynamic_frame.hpp"
+#include "physics/massive_body.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+
+using base::make_not_null_unique;
+using base::not_null;
+using geometry::Displacement;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Velocity;
+using integrators::EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator;
+using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
+using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
+using integrators::methods::Fine1987RKNG34;
+using integrators::methods::QuinlanTremaine1990Order12;
+using physics::BodyCentredNonRotatingDynamicFrame;
+using physics::DegreesOfFreedom;
+using physics::Ephemeris;
+using physics::Frenet;
+using physics::MassiveBody;
+using quantities::GravitationalParameter;
+using quantities::Length;
+using quantities::Pow;
+using quantities::Speed;
+using quantities::Sqrt;
+using quantities::Time;
+using quantities::si::Kilo;
+using quantities::si::Kilogram;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Minute;
+using quantities::si::Newton;
+using quantities::si::Second;
+
+namespace {
+
+using EarthCentredNonRotating =
+    BodyCentredNonRotatingDynamicFrame<Barycentric, Navigation>;
+
+// A vessel in low orbit around an Earth-like body, with a flight plan that
+// performs one prograde burn per orbit.
+class FlightPlanWithBurns {
+ public:
+  explicit FlightPlanWithBurns(int const number_of_burns)
+      : ephemeris_(MakeEphemeris()),
+        navigation_frame_(ephemeris_.get(), ephemeris_->bodies().back()) {
+    GravitationalParameter const μ =
+        ephemeris_->bodies().back()->gravitational_parameter();
+    Length const r = 7000 * Kilo(Metre);
+    period_ = 2 * π * Sqrt(Pow<3>(r) / μ);
+    flight_plan_ = std::make_unique<FlightPlan>(
+        /*initial_mass=*/1000 * Kilogram,
+        t0_,
+        DegreesOfFreedom<Barycentric>(
+            Barycentric::origin +
+                Displacement<Barycentric>({r, 0 * Metre, 0 * Metre}),
+            Velocity<Barycentric>(
+                {0 * Metre / Second, Sqrt(μ / r), 0 * Metre / Second})),
+        /*desired_final_time=*/t0_ + (number_of_burns + 1) * period_,
+        ephemeris_.get(),
+        Ephemeris<Barycentric>::AdaptiveStepParameters(
+            EmbeddedExplicitRungeKuttaNyströmIntegrator<
+                DormandالمكاوىPrince1986RKN434FM,
+                Position<Barycentric>>(),
+            /*max_steps=*/1000,
+            /*length_integration_tolerance=*/1 * Metre,
+            /*speed_integration_tolerance=*/1 * Metre / Second),
+        GeneralizedAdaptiveStepParameters(
+            /*length_integration_tolerance=*/1 * Metre));
+    for (int i = 0; i < number_of_burns; ++i) {
+      // Only the last burn uses the generalized parameters.
+      CHECK(flight_plan_->Append(
+          MakeBurn(i,
+                   /*Δv=*/1 * Metre / Second,
+                   /*is_inertially_fixed=*/i + 1 < number_of_burns)));
+    }
+  }
+
+  FlightPlan& flight_plan() {
+    return *flight_plan_;
+  }
+
+  Burn MakeBurn(int const index,
+                Speed const& Δv,
+                bool const is_inertially_fixed) const {
+    return {/*thrust=*/1 * Kilo(Newton),
+            /*specific_impulse=*/3000 * Newton * Second / Kilogram,
+            make_not_null_unique<EarthCentredNonRotating>(navigation_frame_),
+            /*initial_time=*/t0_ + (index + 0.5) * period_,
+            Velocity<Frenet<Navigation>>(
+                {Δv, 0 * Metre / Second, 0 * Metre / Second}),
+            is_inertially_fixed};
+  }
+
+  static Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters
+  GeneralizedAdaptiveStepParameters(
+      Length const& length_integration_tolerance) {
+    return Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters(
+        EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
+            Fine1987RKNG34,
+            Position<Barycentric>>(),
+        /*max_steps=*/1000,
+        length_integration_tolerance,
+        /*speed_integration_tolerance=*/length_integration_tolerance / Second);
+  }
+
+ private:
+  static not_null<std::unique_ptr<Ephemeris<Barycentric>>> MakeEphemeris() {
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    bodies.emplace_back(make_not_null_unique<MassiveBody>(
+        398600.4418 * Pow<3>(Kilo(Metre)) / Pow<2>(Second)));
+    std::vector<DegreesOfFreedom<Barycentric>> const initial_state{
+        {Barycentric::origin, Velocity<Barycentric>()}};
+    return make_not_null_unique<Ephemeris<Barycentric>>(
+        std::move(bodies),
+        initial_state,
+        /*initial_time=*/Instant(),
+        /*fitting_tolerance=*/1 * Milli(Metre),
+        Ephemeris<Barycentric>::FixedStepParameters(
+            SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                               Position<Barycentric>>(),
+            /*step=*/10 * Minute));
+  }
+
+  Instant const t0_;
+  not_null<std::unique_ptr<Ephemeris<Barycentric>>> const ephemeris_;
+  EarthCentredNonRotating const navigation_frame_;
+  Time period_;
+  std::unique_ptr<FlightPlan> flight_plan_;
+};
+
+}  // namespace
+
+// Edits the last burn of a plan with |state.range(0)| burns.
+void BM_FlightPlanReplaceLastBurn(benchmark::State& state) {
+  int const number_of_burns = state.range(0);
+  FlightPlanWithBurns flight_plan_with_burns(number_of_burns);
+  FlightPlan& flight_plan = flight_plan_with_burns.flight_plan();
+  Speed Δv = 1 * Metre / Second;
+  while (state.KeepRunning()) {
+    Δv = 3 * Metre / Second - Δv;
+    CHECK(flight_plan.ReplaceLast(flight_plan_with_burns.MakeBurn(
+        number_of_burns - 1, Δv, /*is_inertially_fixed=*/false)));
+  }
+}
+
+// Changes the parameters used by the last burn of a plan with |state.range(0)|
+// burns.
+void BM_FlightPlanSetGeneralizedAdaptiveStepParameters(
+    benchmark::State& state) {
+  FlightPlanWithBurns flight_plan_with_burns(state.range(0));
+  FlightPlan& flight_plan = flight_plan_with_burns.flight_plan();
+  Length length_integration_tolerance = 1 * Metre;
+  while (state.KeepRunning()) {
+    length_integration_tolerance = 3 * Metre - length_integration_tolerance;
+    CHECK(flight_plan.SetAdaptiveStepParameters(
+        flight_plan.adaptive_step_parameters(),
+        FlightPlanWithBurns::GeneralizedAdaptiveStepParameters(
+            length_integration_tolerance)));
+  }
+}
+
+BENCHMARK(BM_FlightPlanReplaceLastBurn)->Arg(1)->Arg(2)->Arg(5)->Arg(10);
+BENCHMARK(BM_FlightPlanSetGeneralizedAdaptiveStepParameters)
+    ->Arg(1)->Arg(2)->Arg(5)->Arg(10);
+
+}  // namespace ksp_plugin
+}  // namespace principia
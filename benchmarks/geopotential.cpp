@@ -3,6 +3,7 @@
 
 #include "physics/geopotential_body.hpp"
 
+#include <algorithm>
 #include <random>
 #include <vector>
 
@@ -95,6 +96,25 @@ OblateBody<ICRS> MakeEarthBody(SolarSystem<ICRS>& solar_system,
   solar_system.LimitOblatenessToDegree("Earth", max_degree);
   auto earth_message = solar_system.gravity_model_message("Earth");
 
+  // Beyond the degree of the model, use random coefficients following Kaula's
+  // rule so that high degrees may be benchmarked.
+  int model_degree = 0;
+  for (auto const& row : earth_message.geopotential().row()) {
+    model_degree = std::max(model_degree, row.degree());
+  }
+  std::mt19937_64 random(42);
+  std::normal_distribution<> distribution;
+  for (int n = model_degree + 1; n <= max_degree; ++n) {
+    auto* const row = earth_message.mutable_geopotential()->add_row();
+    row->set_degree(n);
+    for (int m = 0; m <= n; ++m) {
+      auto* const column = row->add_column();
+      column->set_order(m);
+      column->set_cos(1e-5 / (n * n) * distribution(random));
+      column->set_sin(m == 0 ? 0 : 1e-5 / (n * n) * distribution(random));
+    }
+  }
+
   Angle const earth_right_ascension_of_pole = 0 * Degree;
   Angle const earth_declination_of_pole = 90 * Degree;
   auto const earth_μ = solar_system.gravitational_parameter("Earth");
@@ -241,13 +261,16 @@ void BM_ComputeGeopotentialF90(benchmark::State& state) {
     PRINCIPIA_CASE_COMPUTE_GEOPOTENTIAL_F90(8);
     PRINCIPIA_CASE_COMPUTE_GEOPOTENTIAL_F90(9);
     PRINCIPIA_CASE_COMPUTE_GEOPOTENTIAL_F90(10);
+    PRINCIPIA_CASE_COMPUTE_GEOPOTENTIAL_F90(20);
   }
 }
 
 #undef PRINCIPIA_CASE_COMPUTE_GEOPOTENTIAL_F90
 
-BENCHMARK(BM_ComputeGeopotentialCpp)->Arg(2)->Arg(3)->Arg(5)->Arg(10);
-BENCHMARK(BM_ComputeGeopotentialF90)->Arg(2)->Arg(3)->Arg(5)->Arg(10);
+BENCHMARK(BM_ComputeGeopotentialCpp)
+    ->Arg(2)->Arg(3)->Arg(5)->Arg(10)->Arg(20)->Arg(50);
+BENCHMARK(BM_ComputeGeopotentialF90)
+    ->Arg(2)->Arg(3)->Arg(5)->Arg(10)->Arg(20);
 BENCHMARK(BM_ComputeGeopotentialDistance)
     ->Arg(150'000)     // C₂₂, S₂₂, J₂.
     ->Arg(500'000)     // J₂.
@@ -136,6 +136,8 @@ void BM_VisibleSegmentsOrbit(benchmark::State& state) {
                                 static_cast<double>(visible_segments_count)));
 }
 
+// If |state.range(2)| is nonzero, a |SphereHierarchy| is built at each
+// iteration, as would be done once per frame, and used to cull the spheres.
 void BM_VisibleSegmentsOrbitMultipleSpheres(benchmark::State& state) {
   // The camera is slightly above the x-y plane and looks towards the positive
   // x-axis.
@@ -183,14 +185,25 @@ void BM_VisibleSegmentsOrbitMultipleSpheres(benchmark::State& state) {
                                  0 * Metre})));
   }
 
+  bool const use_hierarchy = state.range(2) != 0;
   int visible_segments_count = 0;
   int visible_segments_size = 0;
   while (state.KeepRunning()) {
-    for (auto const& segment : segments) {
-      auto const visible_segments =
-          perspective.VisibleSegments(segment, spheres);
-      ++visible_segments_count;
-      visible_segments_size += visible_segments.size();
+    if (use_hierarchy) {
+      SphereHierarchy<World, Camera> const hierarchy(perspective, spheres);
+      for (auto const& segment : segments) {
+        auto const visible_segments =
+            perspective.VisibleSegments(segment, hierarchy);
+        ++visible_segments_count;
+        visible_segments_size += visible_segments.size();
+      }
+    } else {
+      for (auto const& segment : segments) {
+        auto const visible_segments =
+            perspective.VisibleSegments(segment, spheres);
+        ++visible_segments_count;
+        visible_segments_size += visible_segments.size();
+      }
     }
   }
 
@@ -219,7 +232,11 @@ void BM_VisibleSegmentsRandomNoIntersection(benchmark::State& state) {
 BENCHMARK(BM_VisibleSegmentsOrbit)->Arg(10)->Arg(100)->Arg(1000);
 BENCHMARK(BM_VisibleSegmentsRandomEverywhere)->Arg(1000);
 BENCHMARK(BM_VisibleSegmentsRandomNoIntersection)->Arg(1000);
-BENCHMARK(BM_VisibleSegmentsOrbitMultipleSpheres)->Args({1000, 20});
+BENCHMARK(BM_VisibleSegmentsOrbitMultipleSpheres)
+    ->Args({1000, 20, 0})
+    ->Args({1000, 20, 1})
+    ->Args({1000, 200, 0})
+    ->Args({1000, 200, 1});
 
 }  // namespace geometry
 }  // namespace principia
@@ -4,10 +4,12 @@
 #include "ksp_plugin/planetarium.hpp"
 
 #include <algorithm>
+#include <memory>
 
 #include "astronomy/time_scales.hpp"
 #include "benchmark/benchmark.h"
 #include "physics/body_centred_non_rotating_dynamic_frame.hpp"
+#include "physics/frame_motion_cache.hpp"
 #include "physics/solar_system.hpp"
 #include "testing_utilities/solar_system_factory.hpp"
 
@@ -36,6 +38,7 @@ using physics::BodyCentredNonRotatingDynamicFrame;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
+using physics::FrameMotionCache;
 using physics::KeplerianElements;
 using physics::KeplerOrbit;
 using physics::MassiveBody;
@@ -110,7 +113,11 @@ class Satellites {
             make_not_null_unique<
                 BodyCentredNonRotatingDynamicFrame<Barycentric, Navigation>>(
                 ephemeris_.get(),
-                earth_)) {
+                earth_)),
+        earth_centred_inertial_motion_cache_(
+            std::make_shared<FrameMotionCache<Barycentric, Navigation>>(
+                earth_centred_inertial_.get(),
+                /*step=*/10 * Minute)) {
     // Two-line elements for GOES-8:
     // 1 23051U 94022A   00004.06628221 -.00000243  00000-0  00000-0 0  9630
     // 2 23051   0.4232  97.7420 0004776 192.8349 121.5613  1.00264613 28364
@@ -142,17 +149,22 @@ class Satellites {
     return goes_8_trajectory_;
   }
 
+  // If |cached| is true, the planetarium uses a cache of the motion of the
+  // plotting frame.
   Planetarium MakePlanetarium(
-      Perspective<Navigation, Camera> const& perspective) const {
+      Perspective<Navigation, Camera> const& perspective,
+      bool const cached) const {
     // No dark area, human visual acuity, wide field of view.
     Planetarium::Parameters parameters(
         /*sphere_radius_multiplier=*/1,
         /*angular_resolution=*/0.4 * ArcMinute,
         /*field_of_view=*/90 * Degree);
-    return Planetarium(parameters,
-                       perspective,
-                       ephemeris_.get(),
-                       earth_centred_inertial_.get());
+    return Planetarium(
+        parameters,
+        perspective,
+        ephemeris_.get(),
+        earth_centred_inertial_.get(),
+        cached ? earth_centred_inertial_motion_cache_ : nullptr);
   }
 
  private:
@@ -174,6 +186,8 @@ class Satellites {
   not_null<std::unique_ptr<Ephemeris<Barycentric>>> const ephemeris_;
   not_null<MassiveBody const*> const earth_;
   not_null<std::unique_ptr<NavigationFrame>> const earth_centred_inertial_;
+  std::shared_ptr<FrameMotionCache<Barycentric, Navigation> const> const
+      earth_centred_inertial_motion_cache_;
   DiscreteTrajectory<Barycentric> goes_8_trajectory_;
 };
 
@@ -182,7 +196,8 @@ class Satellites {
 void RunBenchmark(benchmark::State& state,
                   Perspective<Navigation, Camera> const& perspective) {
   Satellites satellites;
-  Planetarium planetarium = satellites.MakePlanetarium(perspective);
+  Planetarium planetarium =
+      satellites.MakePlanetarium(perspective, /*cached=*/state.range(0) != 0);
   RP2Lines<Length, Camera> lines;
   int total_lines = 0;
   int iterations = 0;
@@ -234,10 +249,11 @@ void BM_PlanetariumPlotMethod2FarEquatorialPerspective(
   RunBenchmark(state, EquatorialPerspective(far));
 }
 
-BENCHMARK(BM_PlanetariumPlotMethod2NearPolarPerspective);
-BENCHMARK(BM_PlanetariumPlotMethod2FarPolarPerspective);
-BENCHMARK(BM_PlanetariumPlotMethod2NearEquatorialPerspective);
-BENCHMARK(BM_PlanetariumPlotMethod2FarEquatorialPerspective);
+// The argument is 1 if the motion of the plotting frame is cached.
+BENCHMARK(BM_PlanetariumPlotMethod2NearPolarPerspective)->Arg(0)->Arg(1);
+BENCHMARK(BM_PlanetariumPlotMethod2FarPolarPerspective)->Arg(0)->Arg(1);
+BENCHMARK(BM_PlanetariumPlotMethod2NearEquatorialPerspective)->Arg(0)->Arg(1);
+BENCHMARK(BM_PlanetariumPlotMethod2FarEquatorialPerspective)->Arg(0)->Arg(1);
 
 }  // namespace geometry
 }  // namespace principia
@@ -0,0 +1,129 @@
+
+// .\Release\x64\benchmarks.exe --benchmark_repetitions=3 --benchmark_filter=(PullSerializer|PushDeserializer)  // NOLINT(whitespace/line_length)
+
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "base/array.hpp"
+#include "base/hexadecimal.hpp"
+#include "base/not_null.hpp"
+#include "base/pull_serializer.hpp"
+#include "base/push_deserializer.hpp"
+#include "benchmark/benchmark.h"
+#include "gipfeli/gipfeli.h"
+#include "glog/logging.h"
+#include "serialization/physics.pb.h"
+
+namespace principia {
+namespace base {
+
+using google::compression::Compressor;
+using serialization::DiscreteTrajectory;
+
+namespace {
+
+// Same values as in the plugin interface.
+constexpr int chunk_size = 64 << 10;
+constexpr int number_of_chunks = 8;
+
+// A trajectory with enough points to make many chunks, sampled on a circle so
+// that the data is not trivially compressible.
+not_null<std::unique_ptr<DiscreteTrajectory const>> BuildTrajectory() {
+  auto trajectory = make_not_null_unique<DiscreteTrajectory>();
+  for (int i = 0; i < 100'000; ++i) {
+    auto* const idof = trajectory->add_timeline();
+    auto* const instant = idof->mutable_instant()->mutable_scalar();
+    instant->set_dimensions(3);
+    instant->set_magnitude(10 * i);
+    auto* const dof = idof->mutable_degrees_of_freedom();
+    auto* const q = dof->mutable_t1()->mutable_point()->mutable_scalar();
+    auto* const v = dof->mutable_t2()->mutable_point()->mutable_scalar();
+    q->set_dimensions(1);
+    q->set_magnitude(7e6 * std::cos(1e-3 * i));
+    v->set_dimensions(2);
+    v->set_magnitude(7e3 * std::sin(1e-3 * i));
+  }
+  return std::move(trajectory);
+}
+
+std::vector<std::unique_ptr<Compressor>> NewCompressors(
+    std::int64_t const number_of_compressors) {
+  std::vector<std::unique_ptr<Compressor>> compressors;
+  for (int i = 0; i < number_of_compressors; ++i) {
+    compressors.push_back(google::compression::NewGipfeliCompressor());
+  }
+  return compressors;
+}
+
+// Serializes |message| and returns the hexadecimal encoding of the chunks, as
+// the plugin does when saving.
+std::list<UniqueArray<char>> SerializeHexadecimal(
+    google::protobuf::Message const& message,
+    std::int64_t const number_of_compressors) {
+  std::list<UniqueArray<char>> hexadecimal_chunks;
+  PullSerializer serializer(chunk_size,
+                            number_of_chunks,
+                            NewCompressors(number_of_compressors));
+  serializer.Start(&message);
+  for (;;) {
+    Array<std::uint8_t> const bytes = serializer.Pull();
+    if (bytes.size == 0) {
+      break;
+    }
+    hexadecimal_chunks.push_back(
+        HexadecimalEncode(bytes, /*null_terminated=*/false));
+  }
+  return hexadecimal_chunks;
+}
+
+}  // namespace
+
+// Saves a large message with |state.range(0)| compression threads (0 means no
+// compression).  The throughput is measured on the uncompressed data, in real
+// time since most of the work happens on other threads.
+void BM_PullSerializer(benchmark::State& state) {
+  auto const trajectory = BuildTrajectory();
+  std::int64_t const byte_size = trajectory->ByteSizeLong();
+  for (auto _ : state) {
+    auto const hexadecimal_chunks =
+        SerializeHexadecimal(*trajectory, state.range(0));
+    benchmark::DoNotOptimize(hexadecimal_chunks);
+  }
+  state.SetBytesProcessed(state.iterations() * byte_size);
+}
+
+// Loads a large message with |state.range(0)| uncompression threads (0 means
+// no compression).  The throughput is measured as above.
+void BM_PushDeserializer(benchmark::State& state) {
+  auto const trajectory = BuildTrajectory();
+  std::int64_t const byte_size = trajectory->ByteSizeLong();
+  auto const hexadecimal_chunks =
+      SerializeHexadecimal(*trajectory, state.range(0));
+  for (auto _ : state) {
+    DiscreteTrajectory read_trajectory;
+    {
+      PushDeserializer deserializer(chunk_size,
+                                    number_of_chunks,
+                                    NewCompressors(state.range(0)));
+      deserializer.Start(&read_trajectory, /*done=*/nullptr);
+      for (auto const& hexadecimal : hexadecimal_chunks) {
+        deserializer.Push(HexadecimalDecode(hexadecimal.get()));
+      }
+      deserializer.Push(Array<std::uint8_t>(), /*done=*/nullptr);
+      // Destroying the deserializer waits until deserialization is done.
+    }
+    CHECK_EQ(trajectory->timeline_size(), read_trajectory.timeline_size());
+  }
+  state.SetBytesProcessed(state.iterations() * byte_size);
+}
+
+BENCHMARK(BM_PullSerializer)->Arg(0)->Arg(1)->Arg(2)->Arg(3)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_PushDeserializer)->Arg(0)->Arg(1)->Arg(2)->Arg(3)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace base
+}  // namespace principia
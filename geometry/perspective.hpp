@@ -19,6 +19,7 @@ namespace geometry {
 namespace internal_perspective {
 
 using base::BoundedArray;
+using quantities::Angle;
 using quantities::Length;
 
 template<typename Frame>
@@ -27,6 +28,9 @@ using Segment = std::pair<Position<Frame>, Position<Frame>>;
 template<typename Frame>
 using Segments = std::vector<Segment<Frame>>;
 
+template<typename FromFrame, typename ToFrame>
+class SphereHierarchy;
+
 // A perspective using the pinhole camera model.  It project a point of
 // |FromFrame| to an element of ℝP².  |ToFrame| is the frame of the camera.  In
 // that frame the camera is located at the origin and looking at the positive
@@ -78,11 +82,92 @@ class Perspective final {
       Segment<FromFrame> const& segment,
       std::vector<Sphere<FromFrame>> const& spheres) const;
 
+  // Same as above, but only tests the spheres of the |hierarchy| that may hide
+  // |segment|.  The |hierarchy| must have been built for this perspective.
+  // Returns the same segments as the above function applied to
+  // |hierarchy.spheres()|, possibly in a different order.
+  Segments<FromFrame> VisibleSegments(
+      Segment<FromFrame> const& segment,
+      SphereHierarchy<FromFrame, ToFrame> const& hierarchy) const;
+
  private:
+  // The implementation of the multiple spheres case.  The elements of
+  // |spheres| must be convertible to |Sphere<FromFrame> const&|.
+  template<typename Spheres>
+  Segments<FromFrame> VisibleSegmentsForSpheres(
+      Segment<FromFrame> const& segment,
+      Spheres const& spheres) const;
+
   RigidTransformation<ToFrame, FromFrame> const from_camera_;
   RigidTransformation<FromFrame, ToFrame> const to_camera_;
   Position<FromFrame> const camera_;
   Length const focal_;
+
+  friend class SphereHierarchy<FromFrame, ToFrame>;
+};
+
+// A bounding volume hierarchy for the cones under which a set of spheres are
+// seen from the camera of a perspective.  It is used to quickly eliminate the
+// spheres that cannot hide a segment: a sphere may only hide the points that
+// are in its cone.  It must be rebuilt when the camera or the spheres move,
+// typically once per frame.
+template<typename FromFrame, typename ToFrame>
+class SphereHierarchy final {
+ public:
+  SphereHierarchy(Perspective<FromFrame, ToFrame> const& perspective,
+                  std::vector<Sphere<FromFrame>> spheres);
+
+  std::vector<Sphere<FromFrame>> const& spheres() const;
+
+  // Appends to |indices| the indices in |spheres()| of the spheres that may
+  // hide part of |segment|, in increasing order.  This is conservative: it may
+  // return spheres that don't hide the segment.
+  void SpheresThatMayHide(Segment<FromFrame> const& segment,
+                          std::vector<int>& indices) const;
+
+ private:
+  // A cone with apex at the camera.  The half-angle is enlarged by a small
+  // tolerance to make the culling conservative in the face of rounding errors.
+  // Its cosine and sine are cached to make |Intersect| cheap.
+  struct Cone {
+    Cone() = default;
+    Cone(Vector<double, FromFrame> const& axis, Angle const& half_angle);
+
+    Vector<double, FromFrame> axis;
+    Angle half_angle;
+    double cos_half_angle = 1;
+    double sin_half_angle = 0;
+  };
+
+  // The children of a node that is not a leaf are at |first_child| and
+  // |first_child + 1|.  A leaf has the spheres at |permutation_[begin]| to
+  // |permutation_[end - 1]|.
+  struct Node {
+    Cone cone;
+    int begin;
+    int end;
+    int first_child = -1;
+  };
+
+  // Builds the subtree for |permutation_[begin]| to |permutation_[end - 1]|,
+  // with its root at |nodes_[node_index]|.
+  void Build(int begin, int end, int node_index);
+
+  void AppendSpheresThatMayHide(Cone const& segment_cone,
+                                Node const& node,
+                                std::vector<int>& indices) const;
+
+  // True if the cones have a direction in common.
+  static bool Intersect(Cone const& left, Cone const& right);
+
+  Position<FromFrame> const camera_;
+  std::vector<Sphere<FromFrame>> const spheres_;
+  // Indexed like |spheres_|.
+  std::vector<Cone> cones_;
+  // The spheres that contain the camera and may hide anything.
+  std::vector<int> spheres_containing_camera_;
+  std::vector<int> permutation_;
+  std::vector<Node> nodes_;
 };
 
 }  // namespace internal_perspective
@@ -90,6 +175,7 @@ class Perspective final {
 using internal_perspective::Perspective;
 using internal_perspective::Segment;
 using internal_perspective::Segments;
+using internal_perspective::SphereHierarchy;
 
 }  // namespace geometry
 }  // namespace principia
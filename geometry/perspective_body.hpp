@@ -5,12 +5,18 @@
 
 #include <algorithm>
 #include <deque>
+#include <functional>
 #include <limits>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 #include "geometry/barycentre_calculator.hpp"
 #include "numerics/root_finders.hpp"
+#include "quantities/elementary_functions.hpp"
 #include "quantities/named_quantities.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/si.hpp"
 
 namespace principia {
 namespace geometry {
@@ -18,9 +24,20 @@ namespace internal_perspective {
 
 using geometry::InnerProduct;
 using numerics::SolveQuadraticEquation;
+using quantities::ArcCos;
+using quantities::ArcSin;
+using quantities::Cos;
 using quantities::Pow;
 using quantities::Product;
+using quantities::Sin;
 using quantities::Square;
+using quantities::si::Radian;
+
+// The maximum number of spheres in a leaf of a |SphereHierarchy|.
+constexpr int max_spheres_per_leaf = 4;
+// An angular tolerance used to make the culling in |SphereHierarchy|
+// conservative in the face of rounding errors.
+constexpr Angle culling_tolerance = 1e-6 * Radian;
 
 template<typename FromFrame, typename ToFrame>
 Perspective<FromFrame, ToFrame>::Perspective(
@@ -359,6 +376,28 @@ template<typename FromFrame, typename ToFrame>
 Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
     Segment<FromFrame> const& segment,
     std::vector<Sphere<FromFrame>> const& spheres) const {
+  return VisibleSegmentsForSpheres(segment, spheres);
+}
+
+template<typename FromFrame, typename ToFrame>
+Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
+    Segment<FromFrame> const& segment,
+    SphereHierarchy<FromFrame, ToFrame> const& hierarchy) const {
+  std::vector<int> indices;
+  hierarchy.SpheresThatMayHide(segment, indices);
+  std::vector<std::reference_wrapper<Sphere<FromFrame> const>> spheres;
+  spheres.reserve(indices.size());
+  for (int const index : indices) {
+    spheres.push_back(std::cref(hierarchy.spheres()[index]));
+  }
+  return VisibleSegmentsForSpheres(segment, spheres);
+}
+
+template<typename FromFrame, typename ToFrame>
+template<typename Spheres>
+Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegmentsForSpheres(
+    Segment<FromFrame> const& segment,
+    Spheres const& spheres) const {
   // This algorithm takes the input segment, applies the hiding by the first
   // sphere (which can result in 0, 1, or 2 segments), applies the hiding by the
   // second sphere to the resulting segments, and so on.  To reduce memory
@@ -389,7 +428,7 @@ Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
   // are stored in a contiguous slice of the vector segments.  That slice
   // doesn't start at 0 iff at least one call to VisibleSegments returned 0
   // segments.
-  for (auto const& sphere : spheres) {
+  for (Sphere<FromFrame> const& sphere : spheres) {
     for (int i = in_end - 1; i >= in_begin; --i) {
       auto const& old_segment = segments[i];
       auto const new_segments_for_sphere = VisibleSegments(old_segment, sphere);
@@ -413,6 +452,187 @@ Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
   return segments;
 }
 
+template<typename FromFrame, typename ToFrame>
+SphereHierarchy<FromFrame, ToFrame>::SphereHierarchy(
+    Perspective<FromFrame, ToFrame> const& perspective,
+    std::vector<Sphere<FromFrame>> spheres)
+    : camera_(perspective.camera_),
+      spheres_(std::move(spheres)) {
+  cones_.reserve(spheres_.size());
+  for (int i = 0; i < spheres_.size(); ++i) {
+    auto const& sphere = spheres_[i];
+    Displacement<FromFrame> const KC = sphere.centre() - camera_;
+    auto const KC² = KC.Norm²();
+    if (KC² <= sphere.radius²()) {
+      // The camera is inside the sphere, which is not really a cone.
+      cones_.emplace_back(Vector<double, FromFrame>(), π * Radian);
+      spheres_containing_camera_.push_back(i);
+    } else {
+      cones_.emplace_back(Normalize(KC), ArcSin(sphere.radius() / KC.Norm()));
+      permutation_.push_back(i);
+    }
+  }
+  if (!permutation_.empty()) {
+    // A binary tree with leaves of at least one sphere has fewer than twice as
+    // many nodes as spheres.
+    nodes_.reserve(2 * permutation_.size());
+    nodes_.emplace_back();
+    Build(/*begin=*/0, /*end=*/permutation_.size(), /*node_index=*/0);
+  }
+}
+
+template<typename FromFrame, typename ToFrame>
+std::vector<Sphere<FromFrame>> const&
+SphereHierarchy<FromFrame, ToFrame>::spheres() const {
+  return spheres_;
+}
+
+template<typename FromFrame, typename ToFrame>
+void SphereHierarchy<FromFrame, ToFrame>::SpheresThatMayHide(
+    Segment<FromFrame> const& segment,
+    std::vector<int>& indices) const {
+  int const first_index = indices.size();
+  Displacement<FromFrame> const KA = segment.first - camera_;
+  Displacement<FromFrame> const KB = segment.second - camera_;
+  auto const uA = NormalizeOrZero(KA);
+  auto const uB = NormalizeOrZero(KB);
+  auto const uA_plus_uB = uA + uB;
+  // The segment is seen from the camera under an arc of great circle, which
+  // is enclosed in a cone whose axis goes through the middle of the arc.  If
+  // the segment goes through the camera or is seen under an angle close to π,
+  // the cone is not well-defined and we keep all the spheres.
+  if (uA == Vector<double, FromFrame>() ||
+      uB == Vector<double, FromFrame>() ||
+      uA_plus_uB.Norm²() < 1e-6) {
+    for (int i = 0; i < spheres_.size(); ++i) {
+      indices.push_back(i);
+    }
+    return;
+  }
+  auto const axis = Normalize(uA_plus_uB);
+  Cone const segment_cone(
+      axis, ArcCos(std::clamp(InnerProduct(axis, uA), -1.0, 1.0)));
+
+  std::copy(spheres_containing_camera_.begin(),
+            spheres_containing_camera_.end(),
+            std::back_inserter(indices));
+  if (!nodes_.empty()) {
+    AppendSpheresThatMayHide(segment_cone, nodes_.front(), indices);
+  }
+  std::sort(indices.begin() + first_index, indices.end());
+}
+
+template<typename FromFrame, typename ToFrame>
+void SphereHierarchy<FromFrame, ToFrame>::Build(int const begin,
+                                                int const end,
+                                                int const node_index) {
+  // The axis of the cone of this node is the normalized average of the axes of
+  // the cones of the spheres; its half-angle is large enough to enclose all
+  // the cones.
+  Vector<double, FromFrame> sum;
+  for (int i = begin; i < end; ++i) {
+    sum += cones_[permutation_[i]].axis;
+  }
+  auto const axis = sum.Norm²() < 1e-6 ? cones_[permutation_[begin]].axis
+                                       : Normalize(sum);
+  Angle half_angle;
+  for (int i = begin; i < end; ++i) {
+    Cone const& sphere_cone = cones_[permutation_[i]];
+    half_angle = std::max(
+        half_angle,
+        ArcCos(std::clamp(InnerProduct(axis, sphere_cone.axis), -1.0, 1.0)) +
+            sphere_cone.half_angle);
+  }
+
+  nodes_[node_index] = {Cone(axis, half_angle), begin, end};
+  if (end - begin <= max_spheres_per_leaf) {
+    return;
+  }
+
+  // Split at the median of the coordinate along which the axes are the most
+  // spread.
+  R3Element<double> min{std::numeric_limits<double>::infinity(),
+                        std::numeric_limits<double>::infinity(),
+                        std::numeric_limits<double>::infinity()};
+  R3Element<double> max = -min;
+  for (int i = begin; i < end; ++i) {
+    auto const& coordinates = cones_[permutation_[i]].axis.coordinates();
+    for (int j = 0; j < 3; ++j) {
+      min[j] = std::min(min[j], coordinates[j]);
+      max[j] = std::max(max[j], coordinates[j]);
+    }
+  }
+  R3Element<double> const spread = max - min;
+  int split_coordinate = 0;
+  for (int j = 1; j < 3; ++j) {
+    if (spread[j] > spread[split_coordinate]) {
+      split_coordinate = j;
+    }
+  }
+  int const middle = begin + (end - begin) / 2;
+  std::nth_element(permutation_.begin() + begin,
+                   permutation_.begin() + middle,
+                   permutation_.begin() + end,
+                   [this, split_coordinate](int const left, int const right) {
+                     return cones_[left].axis.coordinates()[split_coordinate] <
+                            cones_[right].axis.coordinates()[split_coordinate];
+                   });
+
+  // The children must be adjacent, so allocate their slots before building
+  // their subtrees.
+  int const first_child = nodes_.size();
+  nodes_[node_index].first_child = first_child;
+  nodes_.emplace_back();
+  nodes_.emplace_back();
+  Build(begin, middle, first_child);
+  Build(middle, end, first_child + 1);
+}
+
+template<typename FromFrame, typename ToFrame>
+void SphereHierarchy<FromFrame, ToFrame>::AppendSpheresThatMayHide(
+    Cone const& segment_cone,
+    Node const& node,
+    std::vector<int>& indices) const {
+  if (!Intersect(segment_cone, node.cone)) {
+    return;
+  }
+  if (node.first_child < 0) {
+    for (int i = node.begin; i < node.end; ++i) {
+      int const index = permutation_[i];
+      if (Intersect(segment_cone, cones_[index])) {
+        indices.push_back(index);
+      }
+    }
+  } else {
+    AppendSpheresThatMayHide(segment_cone, nodes_[node.first_child], indices);
+    AppendSpheresThatMayHide(
+        segment_cone, nodes_[node.first_child + 1], indices);
+  }
+}
+
+template<typename FromFrame, typename ToFrame>
+SphereHierarchy<FromFrame, ToFrame>::Cone::Cone(
+    Vector<double, FromFrame> const& axis,
+    Angle const& half_angle)
+    : axis(axis),
+      half_angle(std::min(half_angle + culling_tolerance, π * Radian)),
+      cos_half_angle(Cos(this->half_angle)),
+      sin_half_angle(Sin(this->half_angle)) {}
+
+template<typename FromFrame, typename ToFrame>
+bool SphereHierarchy<FromFrame, ToFrame>::Intersect(Cone const& left,
+                                                    Cone const& right) {
+  // The angle between the axes must not exceed the sum of the half-angles.
+  // Below π, this is equivalent to comparing the cosines, and the cosine of the
+  // sum is obtained without calling trigonometric functions.
+  if (left.half_angle + right.half_angle >= π * Radian) {
+    return true;
+  }
+  return InnerProduct(left.axis, right.axis) >=
+         left.cos_half_angle * right.cos_half_angle -
+             left.sin_half_angle * right.sin_half_angle;
+}
+
 }  // namespace internal_perspective
 }  // namespace geometry
 }  // namespace principia
@@ -1,5 +1,9 @@
 ﻿
+#include <algorithm>
 #include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
 
 #include "geometry/affine_map.hpp"
 #include "geometry/frame.hpp"
@@ -606,6 +610,60 @@ TEST_F(VisibleSegmentsTest, MultipleSpheres) {
   EXPECT_THAT(perspective_.VisibleSegments(segment, {sphere_, sphere2}),
               SizeIs(3));
 }
+
+// The hierarchy must give the same visible segments as the brute-force
+// computation, possibly in a different order.
+TEST_F(VisibleSegmentsTest, SphereHierarchy) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> coordinate(-10.0, 10.0);
+  std::uniform_real_distribution<> radius(0.1, 1.0);
+  auto const random_position = [&coordinate, &random]() {
+    return World::origin + Displacement<World>({coordinate(random) * Metre,
+                                                coordinate(random) * Metre,
+                                                coordinate(random) * Metre});
+  };
+
+  std::vector<Sphere<World>> spheres;
+  for (int i = 0; i < 50; ++i) {
+    spheres.emplace_back(random_position(), radius(random) * Metre);
+  }
+  // A sphere that contains the camera hides everything.
+  std::vector<Sphere<World>> spheres_with_camera = spheres;
+  spheres_with_camera.emplace_back(camera_origin_, /*radius=*/1 * Metre);
+
+  auto const lexicographic = [](Segment<World> const& left,
+                                Segment<World> const& right) {
+    auto const l = left.first - World::origin;
+    auto const r = right.first - World::origin;
+    return std::make_tuple(l.coordinates().x,
+                           l.coordinates().y,
+                           l.coordinates().z) <
+           std::make_tuple(r.coordinates().x,
+                           r.coordinates().y,
+                           r.coordinates().z);
+  };
+
+  SphereHierarchy<World, Camera> const hierarchy(perspective_, spheres);
+  SphereHierarchy<World, Camera> const hierarchy_with_camera(
+      perspective_, spheres_with_camera);
+  int hidden = 0;
+  for (int i = 0; i < 1000; ++i) {
+    Segment<World> const segment{random_position(), random_position()};
+    auto expected = perspective_.VisibleSegments(segment, spheres);
+    auto actual = perspective_.VisibleSegments(segment, hierarchy);
+    std::sort(expected.begin(), expected.end(), lexicographic);
+    std::sort(actual.begin(), actual.end(), lexicographic);
+    EXPECT_EQ(expected, actual) << i;
+    if (expected.size() != 1 || expected.front() != segment) {
+      ++hidden;
+    }
+
+    EXPECT_THAT(perspective_.VisibleSegments(segment, hierarchy_with_camera),
+                IsEmpty());
+  }
+  // Check that the test is not vacuous.
+  EXPECT_LT(100, hidden);
+}
 }  // namespace internal_perspective
 }  // namespace geometry
 }  // namespace principia
@@ -110,6 +110,15 @@ class EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator
              EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator const&
                  integrator);
 
+    // Workspace for |Solve|, kept across calls to avoid reallocating it.  The
+    // vectors are resized to the dimension of the problem on each call.
+    std::vector<typename ODE::Displacement> Δq̂_;
+    std::vector<typename ODE::Velocity> Δv̂_;
+    typename ODE::SystemStateError error_estimate_;
+    std::vector<Position> q_stage_;
+    std::vector<typename ODE::Velocity> v_stage_;
+    std::vector<std::vector<typename ODE::Acceleration>> g_;
+
     EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator const& integrator_;
     friend class EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator;
   };
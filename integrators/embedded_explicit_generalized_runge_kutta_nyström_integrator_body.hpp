@@ -90,9 +90,11 @@ Status EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
   DoublePrecision<Instant>& t = current_state.time;
 
   // Position increment (high-order).
-  std::vector<Displacement> Δq̂(dimension);
+  std::vector<Displacement>& Δq̂ = Δq̂_;
+  Δq̂.resize(dimension);
   // Velocity increment (high-order).
-  std::vector<Velocity> Δv̂(dimension);
+  std::vector<Velocity>& Δv̂ = Δv̂_;
+  Δv̂.resize(dimension);
   // Current position.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Position>>& q̂ = current_state.positions;
@@ -101,16 +103,19 @@ Status EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
   std::vector<DoublePrecision<Velocity>>& v̂ = current_state.velocities;
 
   // Difference between the low- and high-order approximations.
-  typename ODE::SystemStateError error_estimate;
+  typename ODE::SystemStateError& error_estimate = error_estimate_;
   error_estimate.position_error.resize(dimension);
   error_estimate.velocity_error.resize(dimension);
 
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
-  std::vector<Velocity> v_stage(dimension);
+  std::vector<Position>& q_stage = q_stage_;
+  q_stage.resize(dimension);
+  std::vector<Velocity>& v_stage = v_stage_;
+  v_stage.resize(dimension);
   // Accelerations at each stage.
   // TODO(egg): this is a rectangular container, use something more appropriate.
-  std::vector<std::vector<Acceleration>> g(stages_);
+  std::vector<std::vector<Acceleration>>& g = g_;
+  g.resize(stages_);
   for (auto& g_stage : g) {
     g_stage.resize(dimension);
   }
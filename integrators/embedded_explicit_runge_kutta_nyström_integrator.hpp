@@ -100,23 +100,72 @@ class EmbeddedExplicitRungeKuttaNyströmIntegrator
     void WriteToMessage(
         not_null<serialization::IntegratorInstance*> message) const override;
 
-   private:
+   protected:
     Instance(IntegrationProblem<ODE> const& problem,
              AppendState const& append_state,
              ToleranceToErrorRatio const& tolerance_to_error_ratio,
              Parameters const& adaptive_step_size,
              EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator);
 
+    // The implementation of |Solve|, which evaluates the right-hand side of the
+    // equation using |compute_acceleration|.
+    template<typename ComputeAcceleration>
+    Status SolveWith(Instant const& t_final,
+                     ComputeAcceleration const& compute_acceleration);
+
+   private:
+    // Workspace for |Solve|, kept across calls to avoid reallocating it.  The
+    // vectors are resized to the dimension of the problem on each call.
+    std::vector<typename ODE::Displacement> Δq̂_;
+    std::vector<typename ODE::Velocity> Δv̂_;
+    typename ODE::SystemStateError error_estimate_;
+    std::vector<Position> q_stage_;
+    std::vector<std::vector<typename ODE::Acceleration>> g_;
+
     EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator_;
     friend class EmbeddedExplicitRungeKuttaNyströmIntegrator;
   };
 
+  // An instance whose right-hand side is a functor of a type known at compile
+  // time, so that its calls may be inlined in the integration loop.
+  template<typename ComputeAcceleration>
+  class TypedInstance final : public Instance {
+   public:
+    Status Solve(Instant const& t_final) override;
+    not_null<std::unique_ptr<typename Integrator<ODE>::Instance>> Clone()
+        const override;
+
+   private:
+    TypedInstance(IntegrationProblem<ODE> const& problem,
+                  ComputeAcceleration const& compute_acceleration,
+                  AppendState const& append_state,
+                  ToleranceToErrorRatio const& tolerance_to_error_ratio,
+                  Parameters const& adaptive_step_size,
+                  EmbeddedExplicitRungeKuttaNyströmIntegrator const&
+                      integrator);
+
+    ComputeAcceleration const compute_acceleration_;
+    friend class EmbeddedExplicitRungeKuttaNyströmIntegrator;
+  };
+
   not_null<std::unique_ptr<typename Integrator<ODE>::Instance>> NewInstance(
       IntegrationProblem<ODE> const& problem,
       AppendState const& append_state,
       ToleranceToErrorRatio const& tolerance_to_error_ratio,
       Parameters const& parameters) const override;
 
+  // Same as above, but the right-hand side is |compute_acceleration|, which
+  // replaces |problem.equation.compute_acceleration|.  The results are
+  // identical; the difference is that the calls to |compute_acceleration| do
+  // not go through an |std::function|.
+  template<typename ComputeAcceleration>
+  not_null<std::unique_ptr<typename Integrator<ODE>::Instance>> NewInstance(
+      IntegrationProblem<ODE> const& problem,
+      ComputeAcceleration const& compute_acceleration,
+      AppendState const& append_state,
+      ToleranceToErrorRatio const& tolerance_to_error_ratio,
+      Parameters const& parameters) const;
+
   void WriteToMessage(
       not_null<serialization::AdaptiveStepSizeIntegrator*> message)
       const override;
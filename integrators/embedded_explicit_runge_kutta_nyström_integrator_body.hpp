@@ -24,6 +24,15 @@ using quantities::DebugString;
 using quantities::Difference;
 using quantities::Quotient;
 
+// Returns a copy of |problem| whose right-hand side is |compute_acceleration|.
+template<typename ODE, typename ComputeAcceleration>
+IntegrationProblem<ODE> WithRightHandSide(
+    IntegrationProblem<ODE> problem,
+    ComputeAcceleration const& compute_acceleration) {
+  problem.equation.compute_acceleration = compute_acceleration;
+  return problem;
+}
+
 template<typename Method, typename Position>
 EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
 EmbeddedExplicitRungeKuttaNyströmIntegrator() {
@@ -44,6 +53,14 @@ EmbeddedExplicitRungeKuttaNyströmIntegrator() {
 template<typename Method, typename Position>
 Status EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
 Instance::Solve(Instant const& t_final) {
+  return SolveWith(t_final, this->equation_.compute_acceleration);
+}
+
+template<typename Method, typename Position>
+template<typename ComputeAcceleration>
+Status EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
+Instance::SolveWith(Instant const& t_final,
+                    ComputeAcceleration const& compute_acceleration) {
   using Displacement = typename ODE::Displacement;
   using Velocity = typename ODE::Velocity;
   using Acceleration = typename ODE::Acceleration;
@@ -59,7 +76,6 @@ Instance::Solve(Instant const& t_final) {
   auto& current_state = this->current_state_;
   auto& first_use = this->first_use_;
   auto& parameters = this->parameters_;
-  auto const& equation = this->equation_;
 
   // |current_state| gets updated as the integration progresses to allow
   // restartability.
@@ -88,9 +104,11 @@ Instance::Solve(Instant const& t_final) {
   DoublePrecision<Instant>& t = current_state.time;
 
   // Position increment (high-order).
-  std::vector<Displacement> Δq̂(dimension);
+  std::vector<Displacement>& Δq̂ = Δq̂_;
+  Δq̂.resize(dimension);
   // Velocity increment (high-order).
-  std::vector<Velocity> Δv̂(dimension);
+  std::vector<Velocity>& Δv̂ = Δv̂_;
+  Δv̂.resize(dimension);
   // Current position.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Position>>& q̂ = current_state.positions;
@@ -99,15 +117,17 @@ Instance::Solve(Instant const& t_final) {
   std::vector<DoublePrecision<Velocity>>& v̂ = current_state.velocities;
 
   // Difference between the low- and high-order approximations.
-  typename ODE::SystemStateError error_estimate;
+  typename ODE::SystemStateError& error_estimate = error_estimate_;
   error_estimate.position_error.resize(dimension);
   error_estimate.velocity_error.resize(dimension);
 
   // Current Runge-Kutta-Nyström stage.
-  std::vector<Position> q_stage(dimension);
+  std::vector<Position>& q_stage = q_stage_;
+  q_stage.resize(dimension);
   // Accelerations at each stage.
   // TODO(egg): this is a rectangular container, use something more appropriate.
-  std::vector<std::vector<Acceleration>> g(stages_);
+  std::vector<std::vector<Acceleration>>& g = g_;
+  g.resize(stages_);
   for (auto& g_stage : g) {
     g_stage.resize(dimension);
   }
@@ -182,7 +202,7 @@ Instance::Solve(Instant const& t_final) {
           }
           q_stage[k] = q̂[k].value + h * c[i] * v̂[k].value + h² * Σj_a_ij_g_jk;
         }
-        status.Update(equation.compute_acceleration(t_stage, q_stage, g[i]));
+        status.Update(compute_acceleration(t_stage, q_stage, g[i]));
       }
 
       // Increment computation and step size control.
@@ -289,6 +309,39 @@ Instance::Instance(
           problem, append_state, tolerance_to_error_ratio, parameters),
       integrator_(integrator) {}
 
+template<typename Method, typename Position>
+template<typename ComputeAcceleration>
+Status EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
+TypedInstance<ComputeAcceleration>::Solve(Instant const& t_final) {
+  return this->SolveWith(t_final, compute_acceleration_);
+}
+
+template<typename Method, typename Position>
+template<typename ComputeAcceleration>
+not_null<std::unique_ptr<typename Integrator<
+    SpecialSecondOrderDifferentialEquation<Position>>::Instance>>
+EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
+TypedInstance<ComputeAcceleration>::Clone() const {
+  return std::unique_ptr<TypedInstance>(new TypedInstance(*this));
+}
+
+template<typename Method, typename Position>
+template<typename ComputeAcceleration>
+EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
+TypedInstance<ComputeAcceleration>::TypedInstance(
+    IntegrationProblem<ODE> const& problem,
+    ComputeAcceleration const& compute_acceleration,
+    AppendState const& append_state,
+    ToleranceToErrorRatio const& tolerance_to_error_ratio,
+    Parameters const& parameters,
+    EmbeddedExplicitRungeKuttaNyströmIntegrator const& integrator)
+    : Instance(WithRightHandSide(problem, compute_acceleration),
+               append_state,
+               tolerance_to_error_ratio,
+               parameters,
+               integrator),
+      compute_acceleration_(compute_acceleration) {}
+
 template<typename Method, typename Position>
 not_null<std::unique_ptr<typename Integrator<
     SpecialSecondOrderDifferentialEquation<Position>>::Instance>>
@@ -306,6 +359,27 @@ NewInstance(IntegrationProblem<ODE> const& problem,
                                                 *this));
 }
 
+template<typename Method, typename Position>
+template<typename ComputeAcceleration>
+not_null<std::unique_ptr<typename Integrator<
+    SpecialSecondOrderDifferentialEquation<Position>>::Instance>>
+EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
+NewInstance(IntegrationProblem<ODE> const& problem,
+            ComputeAcceleration const& compute_acceleration,
+            AppendState const& append_state,
+            ToleranceToErrorRatio const& tolerance_to_error_ratio,
+            Parameters const& parameters) const {
+  // Cannot use |make_not_null_unique| because the constructor of
+  // |TypedInstance| is private.
+  return std::unique_ptr<TypedInstance<ComputeAcceleration>>(
+      new TypedInstance<ComputeAcceleration>(problem,
+                                             compute_acceleration,
+                                             append_state,
+                                             tolerance_to_error_ratio,
+                                             parameters,
+                                             *this));
+}
+
 template<typename Method, typename Position>
 void EmbeddedExplicitRungeKuttaNyströmIntegrator<Method, Position>::
 WriteToMessage(not_null<serialization::AdaptiveStepSizeIntegrator*> message)
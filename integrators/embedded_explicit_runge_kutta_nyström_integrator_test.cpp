@@ -436,6 +436,72 @@ TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, Restart) {
   EXPECT_THAT(solution2, ElementsAreArray(solution1));
 }
 
+TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, TypedRightHandSide) {
+  auto const& integrator = EmbeddedExplicitRungeKuttaNyströmIntegrator<
+                               methods::DormandالمكاوىPrince1986RKN434FM,
+                               Length>();
+  Length const x_initial = 1 * Metre;
+  Speed const v_initial = 0 * Metre / Second;
+  Time const period = 2 * π * Second;
+  Instant const t_initial;
+  Instant const t_final = t_initial + 10 * period;
+  Length const length_tolerance = 1 * Milli(Metre);
+  Speed const speed_tolerance = 1 * Milli(Metre) / Second;
+
+  auto const step_size_callback = [](bool tolerable) {};
+
+  int evaluations1 = 0;
+  int evaluations2 = 0;
+  std::vector<ODE::SystemState> solution1;
+  std::vector<ODE::SystemState> solution2;
+  IntegrationProblem<ODE> problem;
+  problem.equation.compute_acceleration =
+      std::bind(ComputeHarmonicOscillatorAcceleration1D,
+                _1, _2, _3, &evaluations1);
+  problem.initial_state = {{x_initial}, {v_initial}, t_initial};
+  AdaptiveStepSizeIntegrator<ODE>::Parameters const parameters(
+      /*first_time_step=*/t_final - t_initial,
+      /*safety_factor=*/0.9);
+  auto const tolerance_to_error_ratio =
+      std::bind(HarmonicOscillatorToleranceRatio,
+                _1, _2,
+                length_tolerance,
+                speed_tolerance,
+                step_size_callback);
+
+  auto const instance1 = integrator.NewInstance(
+      problem,
+      [&solution1](ODE::SystemState const& state) {
+        solution1.push_back(state);
+      },
+      tolerance_to_error_ratio,
+      parameters);
+  EXPECT_EQ(termination_condition::Done,
+            instance1->Solve(t_final).error());
+
+  auto const instance2 = integrator.NewInstance(
+      problem,
+      [&evaluations2](Instant const& t,
+                      std::vector<Length> const& q,
+                      std::vector<Acceleration>& result) {
+        return ComputeHarmonicOscillatorAcceleration1D(
+            t, q, result, &evaluations2);
+      },
+      [&solution2](ODE::SystemState const& state) {
+        solution2.push_back(state);
+      },
+      tolerance_to_error_ratio,
+      parameters);
+  EXPECT_EQ(termination_condition::Done,
+            instance2->Solve(t_final).error());
+
+  // The results are bit-for-bit identical, and the right-hand side of
+  // |problem| is not used by the second instance.
+  EXPECT_THAT(solution2, ElementsAreArray(solution1));
+  EXPECT_EQ(evaluations1, evaluations2);
+  EXPECT_LT(0, evaluations2);
+}
+
 TEST_F(EmbeddedExplicitRungeKuttaNyströmIntegratorTest, Serialization) {
   AdaptiveStepSizeIntegrator<ODE> const& integrator =
       EmbeddedExplicitRungeKuttaNyströmIntegrator<
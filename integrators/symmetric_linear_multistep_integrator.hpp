@@ -95,6 +95,12 @@ class SymmetricLinearMultistepIntegrator
 
     int startup_step_index_ = 0;
     std::list<Step> previous_steps_;  // At most |order_| elements.
+
+    // Workspace for |Solve|, kept across calls to avoid reallocating it.
+    std::vector<Position> positions_;
+    std::vector<DoublePrecision<typename ODE::Displacement>> Σj_minus_ɑj_qj_;
+    std::vector<typename ODE::Acceleration> Σj_βj_numerator_aj_;
+
     SymmetricLinearMultistepIntegrator const& integrator_;
     friend class SymmetricLinearMultistepIntegrator;
   };
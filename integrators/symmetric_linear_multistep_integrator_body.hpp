@@ -61,10 +61,12 @@ Status SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
   int const k = order;
 
   Status status;
-  std::vector<Position> positions(dimension);
-
-  DoubleDisplacements Σj_minus_ɑj_qj(dimension);
-  std::vector<Acceleration> Σj_βj_numerator_aj(dimension);
+  std::vector<Position>& positions = positions_;
+  DoubleDisplacements& Σj_minus_ɑj_qj = Σj_minus_ɑj_qj_;
+  std::vector<Acceleration>& Σj_βj_numerator_aj = Σj_βj_numerator_aj_;
+  positions.resize(dimension);
+  Σj_minus_ɑj_qj.resize(dimension);
+  Σj_βj_numerator_aj.resize(dimension);
   while (h <= (t_final - t.value) - t.error) {
     // We take advantage of the symmetry to iterate on the list of previous
     // steps from both ends.
@@ -111,13 +113,17 @@ Status SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
       }
     }
 
-    // Create a new step in the instance.
+    // Create a new step in the instance.  The oldest step is not needed
+    // anymore, so we move it to the end of the list and overwrite it: this
+    // reuses its node and its vectors without allocating.
     t.Increment(h);
-    previous_steps_.emplace_back();
+    previous_steps_.splice(previous_steps_.end(),
+                           previous_steps_,
+                           previous_steps_.begin());
     Step& current_step = previous_steps_.back();
     current_step.time = t;
-    current_step.accelerations.resize(dimension);
-    current_step.displacements.reserve(dimension);
+    DCHECK_EQ(dimension, current_step.displacements.size());
+    DCHECK_EQ(dimension, current_step.accelerations.size());
 
     // Fill the new step.  We skip the division by ɑk as it is equal to 1.0.
     double const ɑk = ɑ[0];
@@ -126,7 +132,7 @@ Status SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
       DoubleDisplacement& current_displacement = Σj_minus_ɑj_qj[d];
       current_displacement.Increment(h * h *
                                      Σj_βj_numerator_aj[d] / β_denominator);
-      current_step.displacements.push_back(current_displacement);
+      current_step.displacements[d] = current_displacement;
       DoublePosition const current_position =
           DoublePosition() + current_displacement;
       positions[d] = current_position.value;
@@ -135,7 +141,6 @@ Status SymmetricLinearMultistepIntegrator<Method, Position>::Instance::Solve(
     status.Update(equation.compute_acceleration(t.value,
                                                 positions,
                                                 current_step.accelerations));
-    previous_steps_.pop_front();
 
     ComputeVelocityUsingCohenHubbardOesterwinter();
 
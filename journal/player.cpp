@@ -1,13 +1,21 @@
 ﻿
 #include "journal/player.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <iomanip>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/array.hpp"
 #include "base/get_line.hpp"
 #include "base/hexadecimal.hpp"
+#include "gipfeli/gipfeli.h"
 #include "journal/profiles.hpp"
 #include "glog/logging.h"
 
@@ -20,17 +28,60 @@ using base::UniqueArray;
 namespace journal {
 
 Player::Player(std::filesystem::path const& path)
-    : stream_(path, std::ios::in) {
+    : stream_(path, std::ios::in | std::ios::binary) {
   CHECK(!stream_.fail());
+  // A hexadecimal journal cannot start with the magic of a binary journal.
+  char header[Recorder::binary_header_size];
+  stream_.read(header, sizeof(header));
+  if (stream_.gcount() == sizeof(header) &&
+      std::memcmp(header,
+                  Recorder::binary_magic,
+                  sizeof(Recorder::binary_magic)) == 0) {
+    is_binary_ = true;
+    if (header[sizeof(Recorder::binary_magic)] != 0) {
+      compressor_ = google::compression::NewGipfeliCompressor();
+    }
+  } else {
+    // Reopen in text mode to read the lines.
+    stream_.close();
+    stream_.open(path, std::ios::in);
+    CHECK(!stream_.fail());
+  }
+}
+
+void Player::Convert(std::filesystem::path const& from,
+                     std::filesystem::path const& to,
+                     Recorder::Format const format) {
+  Player player(from);
+  Recorder recorder(to, format);
+  for (std::unique_ptr<serialization::Method> method_in = player.Read();
+       method_in != nullptr;
+       method_in = player.Read()) {
+    std::unique_ptr<serialization::Method> const method_out_return =
+        player.Read();
+    CHECK(method_out_return != nullptr)
+        << "Unpaired method:\n" << method_in->DebugString();
+    recorder.WriteAtConstruction(*method_in);
+    recorder.WriteAtDestruction(*method_out_return);
+  }
+}
+
+Player::~Player() {
+  if (reader_.joinable()) {
+    {
+      absl::MutexLock l(&lock_);
+      shutdown_ = true;
+    }
+    reader_.join();
+  }
 }
 
 bool Player::Play() {
-  std::unique_ptr<serialization::Method> method_in = Read();
+  auto [method_in, method_out_return] = NextMethodPair();
   if (method_in == nullptr) {
     // End of input file.
     return false;
   }
-  std::unique_ptr<serialization::Method> method_out_return = Read();
   if (method_out_return == nullptr) {
     LOG(ERROR) << "Unpaired method:\n" << method_in->DebugString();
     return false;
@@ -41,15 +92,33 @@ bool Player::Play() {
              << method_out_return->ShortDebugString();
 #endif
 
-  auto const before = std::chrono::system_clock::now();
+  auto const before = std::chrono::steady_clock::now();
 
 #include "journal/player.generated.cc"
 
-  auto const after = std::chrono::system_clock::now();
+  auto const after = std::chrono::steady_clock::now();
   if (after - before > std::chrono::milliseconds(100)) {
     LOG(ERROR) << "Long method:\n" << method_in->DebugString();
   }
 
+  // The name of the method is that of the only extension of |method_in|.
+  std::vector<google::protobuf::FieldDescriptor const*> fields;
+  method_in->GetReflection()->ListFields(*method_in, &fields);
+  CHECK_EQ(1, fields.size()) << method_in->DebugString();
+  auto const duration =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(after - before);
+  MethodStatistics& statistics = statistics_[fields[0]->message_type()->name()];
+  ++statistics.count;
+  statistics.total += duration;
+  statistics.max = std::max(statistics.max, duration);
+  int bucket = 0;
+  for (auto microseconds = duration.count() / 1000;
+       microseconds > 1 && bucket < statistics.histogram.size() - 1;
+       microseconds >>= 1) {
+    ++bucket;
+  }
+  ++statistics.histogram[bucket];
+
   last_method_in_.swap(method_in);
   last_method_out_return_.swap(method_out_return);
 
@@ -64,7 +133,96 @@ serialization::Method const& Player::last_method_out_return() const {
   return *last_method_out_return_;
 }
 
+std::map<std::string, Player::MethodStatistics> const&
+Player::statistics() const {
+  return statistics_;
+}
+
+void Player::LogStatistics() const {
+  std::stringstream table;
+  table << std::left << std::setw(50) << "Method" << std::right
+        << std::setw(12) << "Count" << std::setw(15) << "Total (ms)"
+        << std::setw(15) << "Mean (µs)" << std::setw(15) << "Max (µs)"
+        << "  Histogram (µs, powers of 2)\n";
+  for (auto const& [name, statistics] : statistics_) {
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    table << std::left << std::setw(50) << name << std::right
+          << std::setw(12) << statistics.count << std::setw(15)
+          << std::fixed << std::setprecision(3)
+          << Milliseconds(statistics.total).count() << std::setw(15)
+          << Microseconds(statistics.total).count() / statistics.count
+          << std::setw(15) << Microseconds(statistics.max).count() << " ";
+    // Only print the range of nonempty buckets.
+    int first = 0;
+    while (statistics.histogram[first] == 0) {
+      ++first;
+    }
+    int last = statistics.histogram.size() - 1;
+    while (statistics.histogram[last] == 0) {
+      --last;
+    }
+    table << " [2^" << first << "]";
+    for (int i = first; i <= last; ++i) {
+      table << " " << statistics.histogram[i];
+    }
+    table << "\n";
+  }
+  LOG(INFO) << "Replay statistics:\n" << table.str();
+}
+
+void Player::PrefetchMethods() {
+  // Enough to hide the latency of reading and parsing, without using too much
+  // memory if the plugin is slower than the reader.
+  constexpr int max_prefetched = 1000;
+  for (;;) {
+    MethodPair method_pair;
+    method_pair.first = Read();
+    if (method_pair.first != nullptr) {
+      method_pair.second = Read();
+    }
+    bool const end = method_pair.first == nullptr ||
+                     method_pair.second == nullptr;
+    {
+      absl::MutexLock l(&lock_);
+      auto const has_room_or_shutdown = [this]() {
+        return shutdown_ || prefetched_.size() < max_prefetched;
+      };
+      lock_.Await(absl::Condition(&has_room_or_shutdown));
+      if (shutdown_) {
+        return;
+      }
+      prefetched_.push_back(std::move(method_pair));
+    }
+    if (end) {
+      return;
+    }
+  }
+}
+
+Player::MethodPair Player::NextMethodPair() {
+  if (!reader_.joinable()) {
+    reader_ = std::thread(&Player::PrefetchMethods, this);
+  }
+  absl::MutexLock l(&lock_);
+  auto const has_methods = [this]() { return !prefetched_.empty(); };
+  lock_.Await(absl::Condition(&has_methods));
+  MethodPair method_pair = std::move(prefetched_.front());
+  // Leave the end-of-stream marker in the queue so that further calls return
+  // it again.
+  if (method_pair.first != nullptr && method_pair.second != nullptr) {
+    prefetched_.pop_front();
+  } else {
+    prefetched_.front().first.reset();
+  }
+  return method_pair;
+}
+
 std::unique_ptr<serialization::Method> Player::Read() {
+  return is_binary_ ? ReadBinary() : ReadHexadecimal();
+}
+
+std::unique_ptr<serialization::Method> Player::ReadHexadecimal() {
   std::string const line = GetLine(stream_);
   if (line.empty()) {
     return nullptr;
@@ -77,5 +235,32 @@ std::unique_ptr<serialization::Method> Player::Read() {
   return method;
 }
 
+std::unique_ptr<serialization::Method> Player::ReadBinary() {
+  // The size is written in little-endian order.
+  unsigned char size_bytes[sizeof(std::uint32_t)];
+  stream_.read(reinterpret_cast<char*>(size_bytes), sizeof(size_bytes));
+  if (stream_.gcount() == 0) {
+    return nullptr;
+  }
+  CHECK_EQ(sizeof(size_bytes), stream_.gcount()) << "Truncated journal";
+  std::uint32_t size = 0;
+  for (int i = 0; i < sizeof(size_bytes); ++i) {
+    size |= static_cast<std::uint32_t>(size_bytes[i]) << (8 * i);
+  }
+
+  std::string payload(size, '\0');
+  stream_.read(payload.data(), size);
+  CHECK_EQ(size, stream_.gcount()) << "Truncated journal";
+  if (compressor_ != nullptr) {
+    std::string uncompressed;
+    CHECK(compressor_->Uncompress(payload, &uncompressed));
+    payload.swap(uncompressed);
+  }
+
+  auto method = std::make_unique<serialization::Method>();
+  CHECK(method->ParseFromString(payload));
+  return method;
+}
+
 }  // namespace journal
 }  // namespace principia
@@ -1,21 +1,56 @@
 ﻿
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <map>
 #include <memory>
+#include <string>
+#include <thread>
+#include <utility>
 
+#include "absl/synchronization/mutex.h"
+#include "gipfeli/compression.h"
+#include "journal/recorder.hpp"
 #include "serialization/journal.pb.h"
 
 namespace principia {
 namespace journal {
 
+// The methods are read and parsed ahead of their execution on a separate
+// thread, so that replaying a journal is dominated by the time spent in the
+// plugin.  The time taken by each method is recorded, which makes it possible
+// to use a journal as a realistic benchmark.
 class Player final {
  public:
   using PointerMap = std::map<std::uint64_t, void*>;
 
+  // The wall-clock time taken by the replayed calls to a method.
+  struct MethodStatistics {
+    std::int64_t count = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds max{0};
+    // |histogram[i]| is the number of calls that took between 2^i and
+    // 2^(i + 1) µs.  The first bucket also counts the calls shorter than 1 µs,
+    // the last one those longer than 2^31 µs.
+    std::array<std::int64_t, 32> histogram{};
+  };
+
+  // The format of the journal, hexadecimal or binary, is detected
+  // automatically.
   explicit Player(std::filesystem::path const& path);
+  ~Player();
+
+  // Rewrites the journal at |from|, in any format, to |to| in the given
+  // |format|.  Useful to convert old hexadecimal journals to the binary
+  // format.
+  static void Convert(std::filesystem::path const& from,
+                      std::filesystem::path const& to,
+                      Recorder::Format format);
 
   // Replays the next message in the journal.  Returns false at end of journal.
   bool Play();
@@ -24,9 +59,30 @@ class Player final {
   serialization::Method const& last_method_in() const;
   serialization::Method const& last_method_out_return() const;
 
+  // The statistics of the replayed methods, indexed by the name of their
+  // message, e.g., "AdvanceTime".
+  std::map<std::string, MethodStatistics> const& statistics() const;
+
+  // Logs the |statistics()| as a table, one row per method.
+  void LogStatistics() const;
+
  private:
+  using MethodPair = std::pair<std::unique_ptr<serialization::Method>,
+                               std::unique_ptr<serialization::Method>>;
+
+  // Runs on |reader_| and pushes the pairs of methods read from the stream to
+  // |prefetched_| until the end of the stream or until |shutdown_| is set.
+  // The pair has a null first element at end of stream, and a null second
+  // element if the last method is unpaired.
+  void PrefetchMethods();
+
+  // Returns the next pair of methods, waiting for |reader_| if needed.
+  MethodPair NextMethodPair();
+
   // Reads one message from the stream.  Returns a |nullptr| at end of stream.
   std::unique_ptr<serialization::Method> Read();
+  std::unique_ptr<serialization::Method> ReadHexadecimal();
+  std::unique_ptr<serialization::Method> ReadBinary();
 
   template<typename Profile>
   bool RunIfAppropriate(serialization::Method const& method_in,
@@ -34,10 +90,22 @@ class Player final {
 
   PointerMap pointer_map_;
   std::ifstream stream_;
+  bool is_binary_ = false;
+  // Only set for a compressed binary journal.
+  std::unique_ptr<google::compression::Compressor> compressor_;
 
   std::unique_ptr<serialization::Method> last_method_in_;
   std::unique_ptr<serialization::Method> last_method_out_return_;
 
+  std::map<std::string, MethodStatistics> statistics_;
+
+  // Once |reader_| is started by the first call to |Play|, only it accesses
+  // |stream_|.
+  std::thread reader_;
+  absl::Mutex lock_;
+  std::deque<MethodPair> prefetched_ GUARDED_BY(lock_);
+  bool shutdown_ GUARDED_BY(lock_) = false;
+
   friend class PlayerTest;
   friend class RecorderTest;
 };
@@ -28,6 +28,7 @@ void BM_PlayForReal(benchmark::State& state) {
       LOG_IF(ERROR, (count % 100'000) == 0)
           << count << " journal entries replayed";
     }
+    player.LogStatistics();
   }
 }
 
@@ -82,6 +83,12 @@ TEST_F(PlayerTest, PlayTiny) {
     ++count;
   }
   EXPECT_EQ(2, count);
+
+  auto const& statistics = player.statistics();
+  EXPECT_EQ(2, statistics.size());
+  EXPECT_EQ(1, statistics.at("NewPlugin").count);
+  EXPECT_EQ(1, statistics.at("DeletePlugin").count);
+  player.LogStatistics();
 }
 
 TEST_F(PlayerTest, DISABLED_Benchmarks) {
@@ -1,27 +1,48 @@
 ﻿
 #include "journal/recorder.hpp"
 
+#include <cstdint>
+#include <cstdlib>
 #include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "base/array.hpp"
 #include "base/hexadecimal.hpp"
+#include "gipfeli/gipfeli.h"
 #include "glog/logging.h"
-#include "base/serialization.hpp"
 
 namespace principia {
 
+using base::Array;
 using base::HexadecimalEncode;
-using base::SerializeAsBytes;
-using base::UniqueArray;
 
 namespace journal {
 
-Recorder::Recorder(std::filesystem::path const& path)
-    : stream_(path, std::ios::out) {
+Recorder::Recorder(std::filesystem::path const& path, Format const format)
+    : format_(format),
+      compressor_(format == Format::GipfeliCompressedBinary
+                      ? google::compression::NewGipfeliCompressor()
+                      : nullptr),
+      stream_(path,
+              format == Format::Hexadecimal
+                  ? std::ios::out
+                  : std::ios::out | std::ios::binary) {
   CHECK(!stream_.fail()) << path;
+  if (format_ != Format::Hexadecimal) {
+    stream_.write(binary_magic, sizeof(binary_magic));
+    stream_.put(compressor_ == nullptr ? 0 : 1);
+  }
+  writer_ = std::thread(&Recorder::WriteQueuedMethods, this);
 }
 
 Recorder::~Recorder() {
+  {
+    absl::MutexLock l(&queue_lock_);
+    shutdown_ = true;
+  }
+  writer_.join();
   stream_.close();
 }
 
@@ -35,13 +56,25 @@ void Recorder::WriteAtDestruction(serialization::Method const& method) {
   lock_.Unlock();
 }
 
+void Recorder::Flush() {
+  absl::MutexLock l(&queue_lock_);
+  auto const all_written = [this]() { return written_ == enqueued_; };
+  queue_lock_.Await(absl::Condition(&all_written));
+}
+
 void Recorder::Activate(base::not_null<Recorder*> const journal) {
   CHECK(active_recorder_ == nullptr);
   active_recorder_ = journal;
+  failure_recorder_ = journal;
+  google::InstallFailureFunction(&FlushAndAbort);
 }
 
 void Recorder::Deactivate() {
   CHECK(active_recorder_ != nullptr);
+  // glog doesn't let us retrieve the previous failure function, and nothing
+  // else installs one, so reinstate the default.
+  google::InstallFailureFunction(&std::abort);
+  failure_recorder_ = nullptr;
   delete active_recorder_;
   active_recorder_ = nullptr;
 }
@@ -50,15 +83,91 @@ bool Recorder::IsActivated() {
   return active_recorder_ != nullptr;
 }
 
+void Recorder::FlushAndAbort() {
+  Recorder* const recorder = failure_recorder_;
+  // If the writer itself failed, there is nothing we can do to save the
+  // methods that it didn't write.
+  if (recorder != nullptr &&
+      std::this_thread::get_id() != recorder->writer_.get_id()) {
+    recorder->Flush();
+  }
+  std::abort();
+}
+
 void Recorder::WriteLocked(serialization::Method const& method) {
   CHECK_LT(0, method.ByteSize()) << method.DebugString();
-  auto const hexadecimal = HexadecimalEncode(SerializeAsBytes(method).get(),
-                                             /*null_terminated=*/true);
-  stream_ << hexadecimal.data.get() << "\n";
-  stream_.flush();
+  // Only serialize on the calling thread, the rest is done by |writer_|.
+  std::string bytes;
+  CHECK(method.SerializeToString(&bytes));
+  absl::MutexLock l(&queue_lock_);
+  queue_.push_back(std::move(bytes));
+  ++enqueued_;
+}
+
+void Recorder::WriteQueuedMethods() {
+  for (;;) {
+    std::vector<std::string> methods;
+    bool shutdown;
+    {
+      absl::MutexLock l(&queue_lock_);
+      auto const has_methods_or_shutdown = [this]() {
+        return shutdown_ || !queue_.empty();
+      };
+      queue_lock_.Await(absl::Condition(&has_methods_or_shutdown));
+      methods.swap(queue_);
+      shutdown = shutdown_;
+    }
+    for (auto const& bytes : methods) {
+      WriteSerializedMethod(bytes);
+    }
+    // Flush after each batch so that the journal is as complete as possible if
+    // the game crashes.
+    stream_.flush();
+    {
+      absl::MutexLock l(&queue_lock_);
+      written_ += methods.size();
+    }
+    if (shutdown) {
+      return;
+    }
+  }
+}
+
+void Recorder::WriteSerializedMethod(std::string const& bytes) {
+  switch (format_) {
+    case Format::Hexadecimal: {
+      auto const hexadecimal = HexadecimalEncode(
+          Array<std::uint8_t const>(
+              reinterpret_cast<std::uint8_t const*>(bytes.data()),
+              bytes.size()),
+          /*null_terminated=*/true);
+      stream_ << hexadecimal.data.get() << "\n";
+      break;
+    }
+    case Format::Binary:
+    case Format::GipfeliCompressedBinary: {
+      std::string compressed;
+      std::string const* payload = &bytes;
+      if (compressor_ != nullptr) {
+        compressor_->Compress(bytes, &compressed);
+        payload = &compressed;
+      }
+      // The size is written in little-endian order.
+      std::uint32_t const size = payload->size();
+      char size_bytes[sizeof(size)];
+      for (int i = 0; i < sizeof(size); ++i) {
+        size_bytes[i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+      }
+      stream_.write(size_bytes, sizeof(size_bytes));
+      stream_.write(payload->data(), payload->size());
+      break;
+    }
+  }
+  CHECK(!stream_.fail());
 }
 
 thread_local Recorder* Recorder::active_recorder_ = nullptr;
+std::atomic<Recorder*> Recorder::failure_recorder_ = nullptr;
 
 }  // namespace journal
 }  // namespace principia
@@ -1,11 +1,18 @@
 ﻿
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
 #include "base/not_null.hpp"
+#include "gipfeli/compression.h"
 #include "serialization/journal.pb.h"
 
 namespace principia {
@@ -13,26 +20,82 @@ namespace journal {
 
 FORWARD_DECLARE_FROM(method, template<typename Profile> class, Method);
 
+// The methods are serialized on the calling thread and written to the file by a
+// dedicated writer thread, so that the calling thread doesn't pay for encoding,
+// compression and I/O.  The destructor waits until all the methods have been
+// written.  So does a fatal error, e.g., a failed CHECK, while a recorder is
+// active, so that the journal includes the method that caused the crash.
 class Recorder final {
  public:
-  explicit Recorder(std::filesystem::path const& path);
+  enum class Format {
+    // One hexadecimal-encoded method per line.
+    Hexadecimal,
+    // A header followed by the serialized methods, each preceded by its size.
+    Binary,
+    // Same as |Binary|, but each method is compressed with gipfeli.
+    GipfeliCompressedBinary,
+  };
+
+  // The header of a binary journal.  The last byte is 1 if the methods are
+  // compressed, 0 otherwise.  It cannot be mistaken for the beginning of a
+  // hexadecimal journal.
+  static constexpr char binary_magic[] = "PRINCIPIA JOURNAL";
+  static constexpr int binary_header_size = sizeof(binary_magic) + 1;
+
+  explicit Recorder(std::filesystem::path const& path,
+                    Format format = Format::Hexadecimal);
   ~Recorder();
 
   // Locking is used to ensure that the pairs of writes don't get intermixed.
   void WriteAtConstruction(serialization::Method const& method);
   void WriteAtDestruction(serialization::Method const& method);
 
+  // Blocks until all the methods recorded so far have been written to the file
+  // and the file has been flushed.
+  void Flush();
+
+  // |Activate| installs a glog failure function that flushes the active
+  // recorder before aborting.  |Deactivate| reinstates the default failure
+  // function, which just aborts.
   static void Activate(base::not_null<Recorder*> recorder);
   static void Deactivate();
   static bool IsActivated();
 
  private:
+  // The glog failure function.  Flushes the |failure_recorder_|, if any, unless
+  // the failure happened on its |writer_|, and aborts.
+  [[noreturn]] static void FlushAndAbort();
+
   void WriteLocked(serialization::Method const& method);
 
+  // Runs on |writer_| and writes the methods from |queue_| to |stream_|
+  // until |shutdown_| is set and the queue is empty.
+  void WriteQueuedMethods();
+  // Writes one serialized method to |stream_|.
+  void WriteSerializedMethod(std::string const& bytes);
+
+  Format const format_;
+  std::unique_ptr<google::compression::Compressor> const compressor_;
+
+  // Held between |WriteAtConstruction| and |WriteAtDestruction|.
   absl::Mutex lock_;
+
+  absl::Mutex queue_lock_;
+  std::vector<std::string> queue_ GUARDED_BY(queue_lock_);
+  bool shutdown_ GUARDED_BY(queue_lock_) = false;
+  // The number of methods pushed to |queue_| and written to |stream_|.
+  std::int64_t enqueued_ GUARDED_BY(queue_lock_) = 0;
+  std::int64_t written_ GUARDED_BY(queue_lock_) = 0;
+
+  // Only accessed by |writer_|, except during construction.
   std::ofstream stream_;
 
+  std::thread writer_;
+
   static thread_local Recorder* active_recorder_;
+  // Same as |active_recorder_|, but visible from all threads, since a fatal
+  // error may happen on any thread.
+  static std::atomic<Recorder*> failure_recorder_;
 
   template<typename>
   friend class Method;
@@ -8,8 +8,10 @@
 
 #include "base/array.hpp"
 #include "base/hexadecimal.hpp"
+#include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "journal/method.hpp"
+#include "journal/player.hpp"
 #include "journal/profiles.hpp"
 #include "ksp_plugin/interface.hpp"
 #include "ksp_plugin/plugin.hpp"
@@ -44,7 +46,6 @@ class RecorderTest : public testing::Test {
     return methods;
   }
 
-
   std::string const test_name_;
   std::unique_ptr<ksp_plugin::Plugin> plugin_;
   Recorder* recorder_;
@@ -72,6 +73,26 @@ TEST_F(JournalDeathTest, Return) {
   "returned_");
 }
 
+TEST_F(JournalDeathTest, FlushOnFailure) {
+  // The recorder doesn't survive a fork, so the child must start from scratch.
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+  std::filesystem::path const path = test_name_ + ".crash.journal.hex";
+  EXPECT_DEATH({
+    Recorder::Deactivate();
+    Recorder::Activate(new Recorder(path));
+    Method<NewPlugin> m({"1 s", "2 s", 3});
+    LOG(FATAL) << "Crash while executing a method";
+  },
+  "Crash while executing a method");
+
+  // The method that caused the crash made it to the journal.
+  std::vector<serialization::Method> const methods = ReadAll(path);
+  ASSERT_EQ(1, methods.size());
+  EXPECT_TRUE(methods[0].HasExtension(serialization::NewPlugin::extension));
+  EXPECT_TRUE(
+      methods[0].GetExtension(serialization::NewPlugin::extension).has_in());
+}
+
 TEST_F(RecorderTest, Recording) {
   {
     const ksp_plugin::Plugin* plugin = plugin_.get();
@@ -83,6 +104,7 @@ TEST_F(RecorderTest, Recording) {
     m.Return(plugin_.get());
   }
 
+  recorder_->Flush();
   std::vector<serialization::Method> const methods =
       ReadAll(test_name_ + ".journal.hex");
   EXPECT_EQ(4, methods.size());
@@ -126,5 +148,42 @@ TEST_F(RecorderTest, Recording) {
   }
 }
 
+TEST_F(RecorderTest, Conversion) {
+  {
+    Method<NewPlugin> m({"1 s", "2 s", 3});
+    m.Return(plugin_.get());
+  }
+  {
+    const ksp_plugin::Plugin* plugin = plugin_.get();
+    Method<DeletePlugin> m({&plugin}, {&plugin});
+    m.Return();
+  }
+  recorder_->Flush();
+
+  std::filesystem::path const hexadecimal_path = test_name_ + ".journal.hex";
+  std::filesystem::path const binary_path = test_name_ + ".journal.bin";
+  std::filesystem::path const compressed_path = test_name_ + ".journal.gipfeli";
+  Player::Convert(hexadecimal_path, binary_path, Recorder::Format::Binary);
+  Player::Convert(binary_path,
+                  compressed_path,
+                  Recorder::Format::GipfeliCompressedBinary);
+
+  std::vector<serialization::Method> const hexadecimal_methods =
+      ReadAll(hexadecimal_path);
+  std::vector<serialization::Method> const binary_methods =
+      ReadAll(binary_path);
+  std::vector<serialization::Method> const compressed_methods =
+      ReadAll(compressed_path);
+  ASSERT_EQ(4, hexadecimal_methods.size());
+  ASSERT_EQ(4, binary_methods.size());
+  ASSERT_EQ(4, compressed_methods.size());
+  for (int i = 0; i < hexadecimal_methods.size(); ++i) {
+    EXPECT_EQ(hexadecimal_methods[i].SerializeAsString(),
+              binary_methods[i].SerializeAsString());
+    EXPECT_EQ(hexadecimal_methods[i].SerializeAsString(),
+              compressed_methods[i].SerializeAsString());
+  }
+}
+
 }  // namespace journal
 }  // namespace principia
@@ -0,0 +1,178 @@
+﻿
+#include "ksp_plugin/coasting_pile_ups.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "base/map_util.hpp"
+#include "physics/discrete_trajectory.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_coasting_pile_ups {
+
+using base::Contains;
+using physics::DiscreteTrajectory;
+
+CoastingPileUps::CoastingPileUps(
+    not_null<ThreadPool<void>*> const acceleration_thread_pool)
+    : acceleration_thread_pool_(acceleration_thread_pool) {}
+
+std::vector<PileUpFuture> CoastingPileUps::AdvanceTime(
+    std::vector<not_null<PileUp*>> const& pile_ups,
+    Instant const& t,
+    ThreadPool<Status>& thread_pool) {
+  // Deform the pile-ups that are lagging behind |t| and remove their
+  // psychohistories, which are going to be recomputed from the end of their
+  // histories.  Group the pile-ups by the last time of their histories.
+  std::map<Instant, std::vector<not_null<PileUp*>>> pile_ups_by_time;
+  std::map<not_null<PileUp*>, DiscreteTrajectory<Barycentric>::Iterator>
+      history_lasts;
+  for (not_null<PileUp*> const pile_up : pile_ups) {
+    CHECK(pile_up->is_coasting());
+    absl::MutexLock l(pile_up->lock_.get());
+    CHECK_NOTNULL(pile_up->psychohistory_);
+    if (pile_up->psychohistory_->last().time() < t) {
+      pile_up->DeformPileUpIfNeeded();
+      auto const history_last = pile_up->history_->last();
+      history_lasts.emplace(pile_up, history_last);
+      pile_up->history_->DeleteFork(pile_up->psychohistory_);
+      pile_ups_by_time[history_last.time()].push_back(pile_up);
+    }
+  }
+
+  // Find the batches of the groups of pile-ups, and forget the batches that
+  // are no longer used.
+  std::map<not_null<PileUp*>, std::int64_t> generations;
+  std::set<std::int64_t> used_generations;
+  for (auto const& pair : pile_ups_by_time) {
+    auto const& group = pair.second;
+    std::int64_t generation = 0;
+    if (group.size() > 1) {
+      generation = FindOrCreateBatch(group);
+      used_generations.insert(generation);
+    }
+    for (not_null<PileUp*> const pile_up : group) {
+      generations.emplace(pile_up, generation);
+    }
+  }
+  for (auto it = batches_.begin(); it != batches_.end();) {
+    if (Contains(used_generations, it->first)) {
+      ++it;
+    } else {
+      it = batches_.erase(it);
+    }
+  }
+
+  // Integrate the histories of the batches, and let each pile-up finish its
+  // advancement once its batch, if any, is done.
+  std::vector<PileUpFuture> pile_up_futures;
+  for (auto const& pair : pile_ups_by_time) {
+    auto const& group = pair.second;
+    std::int64_t const generation = generations.at(group.front());
+    std::shared_future<Status> batch_status;
+    if (generation != 0) {
+      batch_status =
+          FlowBatch(&batches_.at(generation), group, t, thread_pool);
+    }
+    for (not_null<PileUp*> const pile_up : group) {
+      auto const history_last = history_lasts.at(pile_up);
+      pile_up_futures.emplace_back(
+          pile_up,
+          thread_pool.Add([pile_up, history_last, batch_status, t]() {
+            // The batch was added to the |thread_pool| before this function,
+            // so it has started and waiting for it cannot deadlock.
+            bool flowed_by_batch = false;
+            if (batch_status.valid()) {
+              flowed_by_batch = batch_status.get().ok();
+            }
+            absl::MutexLock l(pile_up->lock_.get());
+            Status status;
+            if (!flowed_by_batch) {
+              // Either the pile-up is not in a batch, or some pile-up of its
+              // batch collided with a celestial, but we don't know which one.
+              // Let each pile-up finish the integration by itself to find out.
+              pile_up->coasting_generation_ = 0;
+              if (pile_up->history_->last().time() < t) {
+                status = pile_up->FlowHistoryWithFixedStep(t);
+              }
+            }
+            pile_up->ForkAndFlowPsychohistory(t);
+            pile_up->AppendToParts(history_last);
+            pile_up->NudgeParts();
+            return status;
+          }));
+    }
+  }
+  return pile_up_futures;
+}
+
+std::int64_t CoastingPileUps::FindOrCreateBatch(
+    std::vector<not_null<PileUp*>> const& pile_ups) {
+  // The pile-ups form an existing batch if they all have its generation and
+  // none is missing.  A pile-up that was advanced by itself has generation 0,
+  // and so does a new pile-up, even if it was allocated at the address of a
+  // destroyed one.
+  std::int64_t const generation = pile_ups.front()->coasting_generation_;
+  if (generation != 0) {
+    auto const it = batches_.find(generation);
+    if (it != batches_.end() && it->second.size == pile_ups.size() &&
+        std::all_of(pile_ups.begin(),
+                    pile_ups.end(),
+                    [generation](not_null<PileUp*> const pile_up) {
+                      return pile_up->coasting_generation_ == generation;
+                    })) {
+      return generation;
+    }
+  }
+
+  std::int64_t const new_generation = ++last_generation_;
+  for (not_null<PileUp*> const pile_up : pile_ups) {
+    absl::MutexLock l(pile_up->lock_.get());
+    pile_up->coasting_generation_ = new_generation;
+    // The |history_| is going to be advanced by the instance of the batch, so
+    // the |fixed_instance_| would be out of date.
+    pile_up->fixed_instance_ = nullptr;
+  }
+  batches_.emplace(new_generation,
+                   Batch{pile_ups.size(), /*instance=*/nullptr});
+  return new_generation;
+}
+
+std::shared_future<Status> CoastingPileUps::FlowBatch(
+    not_null<Batch*> const batch,
+    std::vector<not_null<PileUp*>> const& pile_ups,
+    Instant const& t,
+    ThreadPool<Status>& thread_pool) {
+  return thread_pool.Add([this, batch, pile_ups, t]() {
+    for (not_null<PileUp*> const pile_up : pile_ups) {
+      pile_up->lock_->Lock();
+    }
+    PileUp const& first_pile_up = *pile_ups.front();
+    if (batch->instance == nullptr) {
+      std::vector<not_null<DiscreteTrajectory<Barycentric>*>> histories;
+      for (not_null<PileUp*> const pile_up : pile_ups) {
+        histories.push_back(pile_up->history_.get());
+      }
+      batch->instance = first_pile_up.ephemeris_->NewInstance(
+          histories,
+          Ephemeris<Barycentric>::NoIntrinsicAccelerations,
+          first_pile_up.fixed_step_parameters_,
+          acceleration_thread_pool_);
+    }
+    CHECK_LT(first_pile_up.history_->last().time(), t);
+    Status const status =
+        first_pile_up.ephemeris_->FlowWithFixedStep(t, *batch->instance);
+    for (not_null<PileUp*> const pile_up : pile_ups) {
+      pile_up->lock_->Unlock();
+    }
+    return status;
+  }).share();
+}
+
+}  // namespace internal_coasting_pile_ups
+}  // namespace ksp_plugin
+}  // namespace principia
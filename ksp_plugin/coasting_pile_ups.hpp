@@ -0,0 +1,99 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "base/status.hpp"
+#include "base/thread_pool.hpp"
+#include "geometry/named_quantities.hpp"
+#include "integrators/integrators.hpp"
+#include "ksp_plugin/frames.hpp"
+#include "ksp_plugin/pile_up.hpp"
+#include "physics/ephemeris.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_coasting_pile_ups {
+
+using base::not_null;
+using base::Status;
+using base::ThreadPool;
+using geometry::Instant;
+using integrators::Integrator;
+using physics::Ephemeris;
+
+// A |CoastingPileUps| integrates with a fixed step the histories of all the
+// pile-ups that are not subject to an intrinsic force.  The pile-ups whose
+// histories end at the same time are on the same grid of fixed steps, and they
+// form a batch integrated by a single instance of the integrator.  This way the
+// trajectories of the celestials are evaluated once per step for the whole
+// batch, instead of once per pile-up.  The histories are never integrated with
+// an adaptive step to bring them to a common time, so a pile-up whose history
+// ends at a different time than any other is integrated by itself.
+// A batch is kept from one call to the next, and is rebuilt when its set of
+// pile-ups changes, e.g., because a pile-up was created or destroyed, or
+// because it was subject to an intrinsic force.
+class CoastingPileUps final {
+ public:
+  // The gravitational accelerations of the pile-ups are computed concurrently
+  // on the |acceleration_thread_pool|, which must outlive this object.
+  explicit CoastingPileUps(
+      not_null<ThreadPool<void>*> acceleration_thread_pool);
+
+  // Deforms the |pile_ups|, advances their time to |t|, and nudges their parts,
+  // like |PileUp::DeformAndAdvanceTime|.  All the |pile_ups| must be coasting.
+  // The integrations take place on the |thread_pool| and are tracked by the
+  // returned futures.  The pile-ups must not be used, and this function must
+  // not be called again, until the futures are ready.
+  std::vector<PileUpFuture> AdvanceTime(
+      std::vector<not_null<PileUp*>> const& pile_ups,
+      Instant const& t,
+      ThreadPool<Status>& thread_pool);
+
+ private:
+  using Instance = typename Integrator<
+      Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance;
+
+  // A set of pile-ups whose histories are integrated together.  The pile-ups
+  // are identified by their |PileUp::coasting_generation_|, which is the key of
+  // the batch in |batches_|.
+  struct Batch {
+    // The number of pile-ups in the batch.
+    std::size_t size;
+    // Built when the batch is first integrated.
+    std::unique_ptr<Instance> instance;
+  };
+
+  // Returns the generation of the batch made of exactly the |pile_ups|, all of
+  // which have histories ending at the same time.  If there is no such batch, a
+  // new one is created.
+  std::int64_t FindOrCreateBatch(
+      std::vector<not_null<PileUp*>> const& pile_ups);
+
+  // Integrates the histories of the |pile_ups| of the given |batch| up to |t|
+  // on the |thread_pool|.  The pile-ups are locked during the integration.
+  std::shared_future<Status> FlowBatch(
+      not_null<Batch*> batch,
+      std::vector<not_null<PileUp*>> const& pile_ups,
+      Instant const& t,
+      ThreadPool<Status>& thread_pool);
+
+  not_null<ThreadPool<void>*> const acceleration_thread_pool_;
+
+  // The generation of the last batch created.  Pile-ups that don't belong to a
+  // batch have generation 0.
+  std::int64_t last_generation_ = 0;
+  std::map<std::int64_t, Batch> batches_;
+};
+
+}  // namespace internal_coasting_pile_ups
+
+using internal_coasting_pile_ups::CoastingPileUps;
+
+}  // namespace ksp_plugin
+}  // namespace principia
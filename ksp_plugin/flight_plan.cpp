@@ -1,6 +1,7 @@
 ﻿
 #include "ksp_plugin/flight_plan.hpp"
 
+#include <algorithm>
 #include <optional>
 #include <vector>
 
@@ -26,6 +27,22 @@ using quantities::Acceleration;
 using quantities::si::Metre;
 using quantities::si::Second;
 
+namespace {
+
+// The integrators are static objects returned by factories, so they may be
+// compared by address.
+template<typename Parameters>
+bool SameParameters(Parameters const& left, Parameters const& right) {
+  return &left.integrator() == &right.integrator() &&
+         left.max_steps() == right.max_steps() &&
+         left.length_integration_tolerance() ==
+             right.length_integration_tolerance() &&
+         left.speed_integration_tolerance() ==
+             right.speed_integration_tolerance();
+}
+
+}  // namespace
+
 FlightPlan::FlightPlan(
     Mass const& initial_mass,
     Instant const& initial_time,
@@ -195,16 +212,19 @@ bool FlightPlan::SetAdaptiveStepParameters(
   auto const original_adaptive_step_parameters = adaptive_step_parameters_;
   auto const original_generalized_adaptive_step_parameters =
       generalized_adaptive_step_parameters_;
+  int const first_manœuvre =
+      FirstManœuvreAffectedBy(adaptive_step_parameters,
+                              generalized_adaptive_step_parameters);
   adaptive_step_parameters_ = adaptive_step_parameters;
   generalized_adaptive_step_parameters_ = generalized_adaptive_step_parameters;
-  if (RecomputeSegments()) {
+  if (RecomputeSegments(first_manœuvre)) {
     return true;
   } else {
     // If the recomputation fails, leave this place as clean as we found it.
     adaptive_step_parameters_ = original_adaptive_step_parameters;
     generalized_adaptive_step_parameters_ =
         original_generalized_adaptive_step_parameters;
-    CHECK(RecomputeSegments());
+    CHECK(RecomputeSegments(first_manœuvre));
     return false;
   }
 }
@@ -333,14 +353,23 @@ void FlightPlan::Append(NavigationManœuvre manœuvre) {
   }
 }
 
-bool FlightPlan::RecomputeSegments() {
+bool FlightPlan::RecomputeSegments(int first_manœuvre) {
+  CHECK_LE(0, first_manœuvre);
+  CHECK_LE(first_manœuvre, number_of_manœuvres());
+  // The coast preceding |first_manœuvre| is at index |2 * first_manœuvre| in
+  // |segments_|.  We can only reuse the segments before it if none of them is
+  // anomalous.
+  first_manœuvre = std::min<int>(
+      first_manœuvre,
+      (segments_.size() - anomalous_segments_) / 2);
   // It is important that the segments be destroyed in (reverse chronological)
   // order of the forks.
-  while (segments_.size() > 1) {
+  while (segments_.size() > 2 * first_manœuvre + 1) {
     PopLastSegment();
   }
   ResetLastSegment();
-  for (auto& manœuvre : manœuvres_) {
+  for (int i = first_manœuvre; i < manœuvres_.size(); ++i) {
+    auto& manœuvre = manœuvres_[i];
     CoastLastSegment(manœuvre.initial_time());
     manœuvre.set_coasting_trajectory(segments_.back());
     AddSegment();
@@ -351,6 +380,27 @@ bool FlightPlan::RecomputeSegments() {
   return anomalous_segments_ <= 2;
 }
 
+int FlightPlan::FirstManœuvreAffectedBy(
+    Ephemeris<Barycentric>::AdaptiveStepParameters const&
+        adaptive_step_parameters,
+    Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters const&
+        generalized_adaptive_step_parameters) const {
+  // All the coasts and the inertially-fixed burns use the
+  // |adaptive_step_parameters_|, so changing them affects everything.
+  if (!SameParameters(adaptive_step_parameters, adaptive_step_parameters_)) {
+    return 0;
+  }
+  if (!SameParameters(generalized_adaptive_step_parameters,
+                      generalized_adaptive_step_parameters_)) {
+    for (int i = 0; i < manœuvres_.size(); ++i) {
+      if (!manœuvres_[i].is_inertially_fixed()) {
+        return i;
+      }
+    }
+  }
+  return number_of_manœuvres();
+}
+
 void FlightPlan::BurnLastSegment(NavigationManœuvre const& manœuvre) {
   if (anomalous_segments_ > 0) {
     return;
@@ -127,9 +127,21 @@ class FlightPlan {
   // |manœuvre.initial_time()|.
   void Append(NavigationManœuvre manœuvre);
 
-  // Recomputes all trajectories in |segments_|.  Returns false if the
+  // Recomputes the trajectories in |segments_| starting with the coast that
+  // precedes the manœuvre at index |first_manœuvre| (or with the last coast if
+  // |first_manœuvre| is |number_of_manœuvres()|).  The earlier segments are
+  // kept as they are, unless they are anomalous.  Returns false if the
   // recomputation resulted in more than 2 anomalous segments.
-  bool RecomputeSegments();
+  bool RecomputeSegments(int first_manœuvre = 0);
+
+  // Returns the index of the first manœuvre whose coast or burn would be
+  // affected by changing the parameters to the ones given, or
+  // |number_of_manœuvres()| if only the last coast would be affected.
+  int FirstManœuvreAffectedBy(
+      Ephemeris<Barycentric>::AdaptiveStepParameters const&
+          adaptive_step_parameters,
+      Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters const&
+          generalized_adaptive_step_parameters) const;
 
   // Flows the last segment for the duration of |manœuvre| using its intrinsic
   // acceleration.
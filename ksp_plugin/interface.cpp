@@ -21,6 +21,7 @@
 #include "astronomy/epoch.hpp"
 #include "astronomy/time_scales.hpp"
 #include "base/array.hpp"
+#include "base/base32768.hpp"
 #include "base/fingerprint2011.hpp"
 #include "base/hexadecimal.hpp"
 #include "base/macros.hpp"
@@ -52,6 +53,8 @@ namespace interface {
 using astronomy::J2000;
 using astronomy::ParseTT;
 using base::Array;
+using base::Base32768Decode;
+using base::Base32768Encode;
 using base::check_not_null;
 using base::Fingerprint2011;
 using base::HexadecimalDecode;
@@ -107,6 +110,9 @@ namespace {
 constexpr char gipfeli[] = "gipfeli";
 constexpr int chunk_size = 64 << 10;
 constexpr int number_of_chunks = 8;
+// Each compression in progress holds two chunks, and one chunk is filled by the
+// serializer while another is transcoded by the client.
+constexpr int number_of_compression_threads = (number_of_chunks - 2) / 2;
 
 static not_null<Arena*> arena = []() {
   ArenaOptions options;
@@ -244,6 +250,95 @@ std::unique_ptr<google::compression::Compressor> NewCompressor(
   }
 }
 
+// One compressor per compression thread, or none if |compressor| doesn't
+// designate a compressor.
+std::vector<std::unique_ptr<google::compression::Compressor>> NewCompressors(
+    const char* const compressor) {
+  std::vector<std::unique_ptr<google::compression::Compressor>> compressors;
+  for (int i = 0; i < number_of_compression_threads; ++i) {
+    auto new_compressor = NewCompressor(compressor);
+    if (new_compressor == nullptr) {
+      break;
+    }
+    compressors.push_back(std::move(new_compressor));
+  }
+  return compressors;
+}
+
+// Pushes the chunk |bytes| to |*deserializer|, which is created and started if
+// it is null.  At the end of the stream, i.e., when |bytes| is empty, deletes
+// |*deserializer|, which ensures that |*plugin| is filled.
+void PushPluginSerialization(UniqueArray<std::uint8_t> bytes,
+                             PushDeserializer** const deserializer,
+                             Plugin const** const plugin,
+                             char const* const compressor) {
+  // Create and start a deserializer if the caller didn't provide one.
+  if (*deserializer == nullptr) {
+    LOG(INFO) << "Begin plugin deserialization";
+    *deserializer = new PushDeserializer(chunk_size,
+                                         number_of_chunks,
+                                         NewCompressors(compressor));
+    not_null<serialization::Plugin*> const message =
+        Arena::CreateMessage<serialization::Plugin>(arena);
+    (*deserializer)->Start(
+        message,
+        [plugin](google::protobuf::Message const& message) {
+          *plugin = Plugin::ReadFromMessage(
+              static_cast<serialization::Plugin const&>(message)).release();
+        });
+  }
+
+  auto const bytes_size = bytes.size;
+  (*deserializer)->Push(std::move(bytes));
+
+  // If the data was empty, delete the deserializer.
+  if (bytes_size == 0) {
+    LOG(INFO) << "End plugin deserialization";
+    TakeOwnership(deserializer);
+    arena->Reset();
+  }
+}
+
+// Pulls the next chunk of the serialization of |plugin| from |*serializer|,
+// which is created and started if it is null.  At the end of the stream,
+// deletes |*serializer| and returns an empty array.
+Array<std::uint8_t> PullPluginSerialization(
+    Plugin const* const plugin,
+    PullSerializer** const serializer,
+    char const* const compressor) {
+  // Create and start a serializer if the caller didn't provide one.
+  if (*serializer == nullptr) {
+    LOG(INFO) << "Begin plugin serialization";
+    *serializer = new PullSerializer(chunk_size,
+                                     number_of_chunks,
+                                     NewCompressors(compressor));
+    // The parts of the message are built on the thread of the serializer,
+    // each in turn, while we return the chunks of the previous parts.
+    (*serializer)->Start(
+        [write_next_part = plugin->SerializeInParts()]()
+            -> google::protobuf::Message const* {
+          arena->Reset();
+          not_null<serialization::Plugin*> const message =
+              Arena::CreateMessage<serialization::Plugin>(arena);
+          if (write_next_part(message)) {
+            return message;
+          }
+          arena->Reset();
+          return nullptr;
+        });
+  }
+
+  // Pull a chunk.
+  Array<std::uint8_t> const bytes = (*serializer)->Pull();
+
+  // If this is the end of the serialization, delete the serializer.
+  if (bytes.size == 0) {
+    LOG(INFO) << "End plugin serialization";
+    TakeOwnership(serializer);
+  }
+  return bytes;
+}
+
 }  // namespace
 
 // If |activate| is true and there is no active journal, create one and
@@ -261,8 +356,10 @@ void principia__ActivateRecorder(bool const activate) {
     std::tm* const localtime = std::localtime(&time);
     std::stringstream name;
     name << std::put_time(localtime, "JOURNAL.%Y%m%d-%H%M%S");
+    // The compressed binary format is cheap enough to leave recording on.
     journal::Recorder* const recorder = new journal::Recorder(
-        std::filesystem::path("glog") / "Principia" / name.str());
+        std::filesystem::path("glog") / "Principia" / name.str(),
+        journal::Recorder::Format::GipfeliCompressedBinary);
     journal::Recorder::Activate(recorder);
   } else if (!activate && journal::Recorder::IsActivated()) {
     journal::Recorder::Deactivate();
@@ -395,6 +492,36 @@ void principia__DeleteU16String(char16_t const** const native_string) {
   return m.Return();
 }
 
+// Same as |principia__DeserializePluginHexadecimal| below, but |serialization|
+// is the null-terminated base 32768 encoding of a chunk produced by
+// |principia__SerializePluginBase32768|.  The caller must perform an extra call
+// with an empty |serialization| to indicate the end of the input stream.
+void principia__DeserializePluginBase32768(
+    char16_t const* const serialization,
+    PushDeserializer** const deserializer,
+    Plugin const** const plugin,
+    char const* const compressor) {
+  journal::Method<journal::DeserializePluginBase32768> m({serialization,
+                                                          deserializer,
+                                                          plugin,
+                                                          compressor},
+                                                         {deserializer,
+                                                          plugin});
+  CHECK_NOTNULL(serialization);
+  CHECK_NOTNULL(deserializer);
+  CHECK_NOTNULL(plugin);
+
+  // Decode the base 32768 representation.
+  PushPluginSerialization(
+      Base32768Decode({serialization,
+                       static_cast<std::int64_t>(
+                           std::char_traits<char16_t>::length(serialization))}),
+      deserializer,
+      plugin,
+      compressor);
+  return m.Return();
+}
+
 // The caller takes ownership of |**plugin| when it is not null.  No transfer of
 // ownership of |*serialization| or |**deserializer|.  |*deserializer| and
 // |*plugin| must be null on the first call and must be passed unchanged to the
@@ -418,34 +545,12 @@ void principia__DeserializePluginHexadecimal(
   CHECK_NOTNULL(deserializer);
   CHECK_NOTNULL(plugin);
 
-  // Create and start a deserializer if the caller didn't provide one.
-  if (*deserializer == nullptr) {
-    LOG(INFO) << "Begin plugin deserialization";
-    *deserializer = new PushDeserializer(chunk_size,
-                                         number_of_chunks,
-                                         NewCompressor(compressor));
-    not_null<serialization::Plugin*> const message =
-        Arena::CreateMessage<serialization::Plugin>(arena);
-    (*deserializer)->Start(
-        message,
-        [plugin](google::protobuf::Message const& message) {
-          *plugin = Plugin::ReadFromMessage(
-              static_cast<serialization::Plugin const&>(message)).release();
-        });
-  }
-
   // Decode the hexadecimal representation.
-  auto bytes = HexadecimalDecode({serialization, serialization_size});
-  auto const bytes_size = bytes.size;
-  (*deserializer)->Push(std::move(bytes));
-
-  // If the data was empty, delete the deserializer.  This ensures that
-  // |*plugin| is filled.
-  if (bytes_size == 0) {
-    LOG(INFO) << "End plugin deserialization";
-    TakeOwnership(deserializer);
-    arena->Reset();
-  }
+  PushPluginSerialization(
+      HexadecimalDecode({serialization, serialization_size}),
+      deserializer,
+      plugin,
+      compressor);
   return m.Return();
 }
 
@@ -886,6 +991,31 @@ char const* principia__SayHello() {
   return m.Return("Hello from native C++!");
 }
 
+// Same as |principia__SerializePluginHexadecimal| below, but the chunks are
+// returned as null-terminated base 32768 strings, which are about half as long
+// as their hexadecimal counterparts.
+char16_t const* principia__SerializePluginBase32768(
+    Plugin const* const plugin,
+    PullSerializer** const serializer,
+    char const* const compressor) {
+  journal::Method<journal::SerializePluginBase32768> m({plugin, serializer},
+                                                       {serializer});
+  CHECK_NOTNULL(plugin);
+  CHECK_NOTNULL(serializer);
+
+  Array<std::uint8_t> const bytes =
+      PullPluginSerialization(plugin, serializer, compressor);
+
+  // If this is the end of the serialization, return a nullptr.
+  if (bytes.size == 0) {
+    return m.Return(nullptr);
+  }
+
+  // Convert to base 32768 and return to the client.
+  auto base32768 = Base32768Encode(bytes, /*null_terminated=*/true);
+  return m.Return(base32768.data.release());
+}
+
 // |plugin| must not be null.  The caller takes ownership of the result, except
 // when it is null (at the end of the stream).  No transfer of ownership of
 // |*plugin|.  |*serializer| must be null on the first call and must be passed
@@ -899,28 +1029,11 @@ char const* principia__SerializePluginHexadecimal(
   CHECK_NOTNULL(plugin);
   CHECK_NOTNULL(serializer);
 
-  // Create and start a serializer if the caller didn't provide one.
-  if (*serializer == nullptr) {
-    LOG(INFO) << "Begin plugin serialization";
-    *serializer = new PullSerializer(chunk_size,
-                                     number_of_chunks,
-                                     NewCompressor(compressor));
-    not_null<serialization::Plugin*> const message =
-        Arena::CreateMessage<serialization::Plugin>(arena);
-    plugin->WriteToMessage(message);
-    (*serializer)->Start(message);
-  }
-
-  // Pull a chunk.
-  Array<std::uint8_t> bytes;
-  bytes = (*serializer)->Pull();
+  Array<std::uint8_t> const bytes =
+      PullPluginSerialization(plugin, serializer, compressor);
 
-  // If this is the end of the serialization, delete the serializer and return a
-  // nullptr.
+  // If this is the end of the serialization, return a nullptr.
   if (bytes.size == 0) {
-    LOG(INFO) << "End plugin serialization";
-    TakeOwnership(serializer);
-    arena->Reset();
     return m.Return(nullptr);
   }
 
@@ -1028,5 +1141,13 @@ void principia__UpdatePrediction(Plugin const* const plugin,
   return m.Return();
 }
 
+void principia__RequestPrediction(Plugin* const plugin,
+                                  char const* const vessel_guid) {
+  journal::Method<journal::RequestPrediction> m({plugin, vessel_guid});
+  CHECK_NOTNULL(plugin);
+  plugin->RequestPrediction(vessel_guid);
+  return m.Return();
+}
+
 }  // namespace interface
 }  // namespace principia
@@ -50,6 +50,23 @@ QP principia__IteratorGetDiscreteTrajectoryQP(Iterator const* const iterator) {
       }));
 }
 
+int principia__IteratorGetDiscreteTrajectoryQPs(Iterator* const iterator,
+                                                QP* const qps,
+                                                int const capacity) {
+  journal::Method<journal::IteratorGetDiscreteTrajectoryQPs> m(
+      {iterator, qps, capacity});
+  CHECK_NOTNULL(iterator);
+  CHECK_NOTNULL(qps);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<DiscreteTrajectory<World>>*>(iterator));
+  return m.Return(typed_iterator->Fill<QP>(
+      qps,
+      capacity,
+      [](DiscreteTrajectory<World>::Iterator const& iterator) -> QP {
+        return ToQP(iterator.degrees_of_freedom());
+      }));
+}
+
 double principia__IteratorGetDiscreteTrajectoryTime(
     Iterator const* const iterator) {
   journal::Method<journal::IteratorGetDiscreteTrajectoryTime> m({iterator});
@@ -75,6 +92,23 @@ XYZ principia__IteratorGetDiscreteTrajectoryXYZ(
       }));
 }
 
+int principia__IteratorGetDiscreteTrajectoryXYZs(Iterator* const iterator,
+                                                 XYZ* const xyzs,
+                                                 int const capacity) {
+  journal::Method<journal::IteratorGetDiscreteTrajectoryXYZs> m(
+      {iterator, xyzs, capacity});
+  CHECK_NOTNULL(iterator);
+  CHECK_NOTNULL(xyzs);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<DiscreteTrajectory<World>>*>(iterator));
+  return m.Return(typed_iterator->Fill<XYZ>(
+      xyzs,
+      capacity,
+      [](DiscreteTrajectory<World>::Iterator const& iterator) -> XYZ {
+        return ToXYZ(iterator.degrees_of_freedom().position());
+      }));
+}
+
 Iterator* principia__IteratorGetRP2LinesIterator(
     Iterator const* const iterator) {
   journal::Method<journal::IteratorGetRP2LinesIterator> m({iterator});
@@ -87,6 +121,19 @@ Iterator* principia__IteratorGetRP2LinesIterator(
       }));
 }
 
+Iterator* principia__IteratorGetRP2LinesVectorIterator(
+    Iterator const* const iterator) {
+  journal::Method<journal::IteratorGetRP2LinesVectorIterator> m({iterator});
+  CHECK_NOTNULL(iterator);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<std::vector<RP2Lines<Length, Camera>>> const*>(
+          iterator));
+  return m.Return(typed_iterator->Get<Iterator*>(
+      [](RP2Lines<Length, Camera> const& rp2_lines) -> Iterator* {
+        return new TypedIterator<RP2Lines<Length, Camera>>(rp2_lines);
+      }));
+}
+
 XY principia__IteratorGetRP2LineXY(Iterator const* const iterator) {
   journal::Method<journal::IteratorGetRP2LineXY> m({iterator});
   CHECK_NOTNULL(iterator);
@@ -98,6 +145,22 @@ XY principia__IteratorGetRP2LineXY(Iterator const* const iterator) {
       }));
 }
 
+int principia__IteratorGetRP2LineXYs(Iterator* const iterator,
+                                     XY* const xys,
+                                     int const capacity) {
+  journal::Method<journal::IteratorGetRP2LineXYs> m({iterator, xys, capacity});
+  CHECK_NOTNULL(iterator);
+  CHECK_NOTNULL(xys);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<RP2Line<Length, Camera>>*>(iterator));
+  return m.Return(typed_iterator->Fill<XY>(
+      xys,
+      capacity,
+      [](RP2Point<Length, Camera> const& rp2_point) -> XY {
+        return ToXY(rp2_point);
+      }));
+}
+
 char const* principia__IteratorGetVesselGuid(Iterator const* const iterator) {
   journal::Method<journal::IteratorGetVesselGuid> m({iterator});
   auto const typed_iterator = check_not_null(
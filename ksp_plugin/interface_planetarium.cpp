@@ -1,6 +1,9 @@
 
 #include "ksp_plugin/interface.hpp"
 
+#include <utility>
+#include <vector>
+
 #include "geometry/affine_map.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
@@ -202,7 +205,9 @@ Iterator* principia__PlanetariumPlotPsychohistory(
   if (plugin->renderer().HasTargetVessel()) {
     return m.Return(new TypedIterator<RP2Lines<Length, Camera>>({}));
   } else {
-    auto const& psychohistory = plugin->GetVessel(vessel_guid)->psychohistory();
+    Vessel& vessel = *plugin->GetVessel(vessel_guid);
+    vessel.UnpackHistory();
+    auto const& psychohistory = vessel.psychohistory();
     auto const rp2_lines = PlotMethodN(*planetarium,
                                        method,
                                        psychohistory.Begin(),
@@ -213,5 +218,74 @@ Iterator* principia__PlanetariumPlotPsychohistory(
   }
 }
 
+Iterator* principia__PlanetariumPlotVesselTrajectories(
+    Planetarium const* const planetarium,
+    Plugin const* const plugin,
+    int const method,
+    char const* const vessel_guid) {
+  journal::Method<journal::PlanetariumPlotVesselTrajectories> m({planetarium,
+                                                                 plugin,
+                                                                 method,
+                                                                 vessel_guid});
+  CHECK_NOTNULL(plugin);
+  CHECK_NOTNULL(planetarium);
+  Vessel& vessel = *plugin->GetVessel(vessel_guid);
+  // Unpack before taking iterators into the psychohistory and the prediction.
+  vessel.UnpackHistory();
+  std::vector<Planetarium::TrajectoryRange> ranges;
+
+  // The psychohistory, with the same special case as in
+  // |principia__PlanetariumPlotPsychohistory|.
+  auto const& psychohistory = vessel.psychohistory();
+  if (plugin->renderer().HasTargetVessel()) {
+    ranges.push_back({psychohistory.End(),
+                      psychohistory.End(),
+                      /*reverse=*/true});
+  } else {
+    ranges.push_back({psychohistory.Begin(),
+                      psychohistory.End(),
+                      /*reverse=*/true});
+  }
+
+  auto const& prediction = vessel.prediction();
+  ranges.push_back({prediction.Fork(), prediction.End(), /*reverse=*/false});
+
+  // The segments of the flight plan, with the same special case as in
+  // |principia__PlanetariumPlotFlightPlanSegment|.
+  if (vessel.has_flight_plan()) {
+    auto const& flight_plan = vessel.flight_plan();
+    for (int index = 0; index < flight_plan.number_of_segments(); ++index) {
+      DiscreteTrajectory<Barycentric>::Iterator segment_begin;
+      DiscreteTrajectory<Barycentric>::Iterator segment_end;
+      flight_plan.GetSegment(index, segment_begin, segment_end);
+      if (index % 2 == 0 ||
+          segment_begin == segment_end ||
+          segment_begin.time() >=
+              plugin->renderer().GetPlottingFrame()->t_min()) {
+        ranges.push_back({segment_begin, segment_end, /*reverse=*/false});
+      } else {
+        ranges.push_back({segment_end, segment_end, /*reverse=*/false});
+      }
+    }
+  }
+
+  // Only |PlotMethod2| knows how to plot multiple ranges in parallel.
+  std::vector<RP2Lines<Length, Camera>> rp2_lines_vector;
+  if (method == 2) {
+    rp2_lines_vector = planetarium->PlotMethod2(ranges, plugin->CurrentTime());
+  } else {
+    for (auto const& range : ranges) {
+      rp2_lines_vector.push_back(PlotMethodN(*planetarium,
+                                             method,
+                                             range.begin,
+                                             range.end,
+                                             plugin->CurrentTime(),
+                                             range.reverse));
+    }
+  }
+  return m.Return(new TypedIterator<std::vector<RP2Lines<Length, Camera>>>(
+      std::move(rp2_lines_vector)));
+}
+
 }  // namespace interface
 }  // namespace principia
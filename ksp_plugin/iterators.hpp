@@ -37,6 +37,17 @@ class TypedIterator : public Iterator {
       std::function<Interchange(typename Container::value_type const&)> const&
           convert) const;
 
+  // Converts the elements starting at the one denoted by this iterator to some
+  // |Interchange| type using |convert| and stores them in |buffer|, which has
+  // room for |capacity| elements.  Advances this iterator past the elements
+  // that were stored and returns their number.
+  template<typename Interchange>
+  int Fill(
+      Interchange* buffer,
+      int capacity,
+      std::function<Interchange(typename Container::value_type const&)> const&
+          convert);
+
   bool AtEnd() const override;
   void Increment() override;
   void Reset() override;
@@ -61,6 +72,16 @@ class TypedIterator<DiscreteTrajectory<World>> : public Iterator {
       std::function<Interchange(
           DiscreteTrajectory<World>::Iterator const&)> const& convert) const;
 
+  // Converts the points starting at the one denoted by this iterator to some
+  // |Interchange| type using |convert| and stores them in |buffer|, which has
+  // room for |capacity| elements.  Advances this iterator past the points that
+  // were stored and returns their number.
+  template<typename Interchange>
+  int Fill(Interchange* buffer,
+           int capacity,
+           std::function<Interchange(
+               DiscreteTrajectory<World>::Iterator const&)> const& convert);
+
   bool AtEnd() const override;
   void Increment() override;
   void Reset() override;
@@ -20,6 +20,22 @@ Interchange TypedIterator<Container>::Get(
   return convert(*iterator_);
 }
 
+template<typename Container>
+template<typename Interchange>
+int TypedIterator<Container>::Fill(
+    Interchange* const buffer,
+    int const capacity,
+    std::function<Interchange(typename Container::value_type const&)> const&
+        convert) {
+  CHECK_LE(0, capacity);
+  int size = 0;
+  for (; size < capacity && iterator_ != container_.end();
+       ++size, ++iterator_) {
+    buffer[size] = convert(*iterator_);
+  }
+  return size;
+}
+
 template<typename Container>
 bool TypedIterator<Container>::AtEnd() const {
   return iterator_ == container_.end();
@@ -57,6 +73,21 @@ Interchange TypedIterator<DiscreteTrajectory<World>>::Get(
   return convert(iterator_);
 }
 
+template<typename Interchange>
+int TypedIterator<DiscreteTrajectory<World>>::Fill(
+    Interchange* const buffer,
+    int const capacity,
+    std::function<Interchange(
+        DiscreteTrajectory<World>::Iterator const&)> const& convert) {
+  CHECK_LE(0, capacity);
+  int size = 0;
+  for (; size < capacity && iterator_ != trajectory_->End();
+       ++size, ++iterator_) {
+    buffer[size] = convert(iterator_);
+  }
+  return size;
+}
+
 inline bool TypedIterator<DiscreteTrajectory<World>>::AtEnd() const {
   return iterator_ == trajectory_->End();
 }
@@ -94,6 +94,10 @@ std::list<not_null<Part*>> const& PileUp::parts() const {
   return parts_;
 }
 
+bool PileUp::is_coasting() const {
+  return intrinsic_force_ == Vector<Force, Barycentric>{};
+}
+
 void PileUp::SetPartApparentDegreesOfFreedom(
     not_null<Part*> const part,
     DegreesOfFreedom<ApparentBubble> const& degrees_of_freedom) {
@@ -127,6 +131,9 @@ Status PileUp::DeformAndAdvanceTime(Instant const& t) {
   absl::MutexLock l(lock_.get());
   Status status;
   if (psychohistory_->last().time() < t) {
+    // The |history_| will not be at the time of the instance of the batch of
+    // the |CoastingPileUps|, if any, when we are done.
+    coasting_generation_ = 0;
     DeformPileUpIfNeeded();
     status = AdvanceTime(t);
     NudgeParts();
@@ -322,32 +329,11 @@ Status PileUp::AdvanceTime(Instant const& t) {
 
   Status status;
   auto const history_last = history_->last();
-  if (intrinsic_force_ == Vector<Force, Barycentric>{}) {
+  if (is_coasting()) {
     // Remove the fork.
     history_->DeleteFork(psychohistory_);
-    if (fixed_instance_ == nullptr) {
-      fixed_instance_ = ephemeris_->NewInstance(
-          {history_.get()},
-          Ephemeris<Barycentric>::NoIntrinsicAccelerations,
-          fixed_step_parameters_);
-    }
-    CHECK_LT(history_->last().time(), t);
-    status = ephemeris_->FlowWithFixedStep(t, *fixed_instance_);
-    psychohistory_ = history_->NewForkAtLast();
-    if (history_->last().time() < t) {
-      // Do not clear the |fixed_instance_| here, we will use it for the next
-      // fixed-step integration.
-      // TODO(phl): Consider not setting |last_point_only| below as we would be
-      // fine with multiple points in the |psychohistory_| once all the classes
-      // have been changed.
-      CHECK_OK(ephemeris_->FlowWithAdaptiveStep(
-                   psychohistory_,
-                   Ephemeris<Barycentric>::NoIntrinsicAcceleration,
-                   t,
-                   adaptive_step_parameters_,
-                   Ephemeris<Barycentric>::unlimited_max_ephemeris_steps,
-                   /*last_point_only=*/true));
-    }
+    status = FlowHistoryWithFixedStep(t);
+    ForkAndFlowPsychohistory(t);
   } else {
     // Destroy the fixed instance, it wouldn't be correct to use it the next
     // time we go through this function.  It will be re-created as needed.
@@ -379,6 +365,42 @@ Status PileUp::AdvanceTime(Instant const& t) {
     psychohistory_ = history_->NewForkAtLast();
   }
 
+  AppendToParts(history_last);
+
+  return status;
+}
+
+Status PileUp::FlowHistoryWithFixedStep(Instant const& t) {
+  if (fixed_instance_ == nullptr) {
+    fixed_instance_ = ephemeris_->NewInstance(
+        {history_.get()},
+        Ephemeris<Barycentric>::NoIntrinsicAccelerations,
+        fixed_step_parameters_);
+  }
+  CHECK_LT(history_->last().time(), t);
+  return ephemeris_->FlowWithFixedStep(t, *fixed_instance_);
+}
+
+void PileUp::ForkAndFlowPsychohistory(Instant const& t) {
+  psychohistory_ = history_->NewForkAtLast();
+  if (history_->last().time() < t) {
+    // Do not clear the |fixed_instance_| here, we will use it for the next
+    // fixed-step integration.
+    // TODO(phl): Consider not setting |last_point_only| below as we would be
+    // fine with multiple points in the |psychohistory_| once all the classes
+    // have been changed.
+    CHECK_OK(ephemeris_->FlowWithAdaptiveStep(
+                 psychohistory_,
+                 Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+                 t,
+                 adaptive_step_parameters_,
+                 Ephemeris<Barycentric>::unlimited_max_ephemeris_steps,
+                 /*last_point_only=*/true));
+  }
+}
+
+void PileUp::AppendToParts(
+    DiscreteTrajectory<Barycentric>::Iterator const history_last) {
   CHECK_NOTNULL(psychohistory_);
 
   // Append the |history_| authoritatively to the parts' tails and the
@@ -394,8 +416,6 @@ Status PileUp::AdvanceTime(Instant const& t) {
     AppendToPart<&Part::AppendToPsychohistory>(it);
   }
   history_->ForgetBefore(psychohistory_->Fork().time());
-
-  return status;
 }
 
 template<PileUp::AppendToPartTrajectory append_to_part_trajectory>
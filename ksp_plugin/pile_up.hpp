@@ -21,6 +21,7 @@
 namespace principia {
 namespace ksp_plugin {
 
+FORWARD_DECLARE_FROM(coasting_pile_ups, class, CoastingPileUps);
 FORWARD_DECLARE_FROM(part, class, Part);
 
 namespace internal_pile_up {
@@ -64,6 +65,11 @@ class PileUp {
 
   std::list<not_null<Part*>> const& parts() const;
 
+  // True if the pile-up is not subject to an intrinsic force, in which case its
+  // history may be integrated by a |CoastingPileUps| together with that of
+  // other pile-ups.
+  bool is_coasting() const;
+
   // Set the |degrees_of_freedom| for the given |part|.  These degrees of
   // freedom are *apparent* in the sense that they were reported by the game but
   // we know better since we are doing science.
@@ -127,6 +133,21 @@ class PileUp {
   // and of its parts have a (possibly ahistorical) final point exactly at |t|.
   Status AdvanceTime(Instant const& t);
 
+  // The steps of |AdvanceTime| in the absence of intrinsic force.  They are
+  // also used by |CoastingPileUps| for the part of the work that is specific to
+  // each pile-up.
+
+  // Flows the |history_| with a fixed step using |fixed_instance_|.  The
+  // |psychohistory_| must have been deleted.
+  Status FlowHistoryWithFixedStep(Instant const& t);
+  // Forks the |psychohistory_| at the end of the |history_| and flows it up to
+  // |t| if needed.
+  void ForkAndFlowPsychohistory(Instant const& t);
+
+  // Appends the points of the |history_| after |history_last| to the histories
+  // of the parts, and those of the |psychohistory_| to their psychohistories.
+  void AppendToParts(DiscreteTrajectory<Barycentric>::Iterator history_last);
+
   // Adjusts the degrees of freedom of all parts in this pile up based on the
   // degrees of freedom of the pile-up computed by |AdvanceTime| and on the
   // |RigidPileUp| degrees of freedom of the parts, as set by
@@ -173,6 +194,13 @@ class PileUp {
       Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance>
       fixed_instance_;
 
+  // The generation of the batch of the |CoastingPileUps| whose instance
+  // integrates the |history_| of this pile-up, or 0 if none.  Reset when the
+  // pile-up is advanced by itself, which tells the |CoastingPileUps| that the
+  // instance of the batch is no longer usable.  While it is not 0, the
+  // |fixed_instance_| is null.
+  std::int64_t coasting_generation_ = 0;
+
   // The |PileUp| is seen as a (currently non-rotating) rigid body; the degrees
   // of freedom of the parts in the frame of that body can be set, however their
   // motion is not integrated; this is simply applied as an offset from the
@@ -190,6 +218,7 @@ class PileUp {
   // Called in the destructor.
   std::function<void()> deletion_callback_;
 
+  friend class internal_coasting_pile_ups::CoastingPileUps;
   friend class TestablePileUp;
 };
 
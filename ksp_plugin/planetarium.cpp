@@ -2,7 +2,9 @@
 #include "ksp_plugin/planetarium.hpp"
 
 #include <algorithm>
+#include <future>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "geometry/point.hpp"
@@ -40,17 +42,25 @@ Planetarium::Planetarium(
     Parameters const& parameters,
     Perspective<Navigation, Camera> const& perspective,
     not_null<Ephemeris<Barycentric> const*> const ephemeris,
-    not_null<NavigationFrame const*> const plotting_frame)
+    not_null<NavigationFrame const*> const plotting_frame,
+    std::shared_ptr<FrameMotionCache<Barycentric, Navigation> const>
+        plotting_frame_motion_cache,
+    ThreadPool<void>* const plotting_thread_pool)
     : parameters_(parameters),
       perspective_(perspective),
       ephemeris_(ephemeris),
-      plotting_frame_(plotting_frame) {}
+      plotting_frame_(plotting_frame),
+      plotting_frame_motion_cache_(std::move(plotting_frame_motion_cache)),
+      plotting_thread_pool_(plotting_thread_pool) {}
 
 RP2Lines<Length, Camera> Planetarium::PlotMethod0(
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
     DiscreteTrajectory<Barycentric>::Iterator const& end,
     Instant const& now,
     bool const /*reverse*/) const {
+  if (begin == end) {
+    return {};
+  }
   auto const plottable_begin =
       begin.trajectory()->LowerBound(plotting_frame_->t_min());
   auto const plottable_end =
@@ -101,6 +111,9 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod1(
     DiscreteTrajectory<Barycentric>::Iterator const& end,
     Instant const& now,
     bool const reverse) const {
+  if (begin == end) {
+    return {};
+  }
   Length const focal_plane_tolerance =
       perspective_.focal() * parameters_.tan_angular_resolution_;
   auto const focal_plane_tolerance² =
@@ -138,6 +151,49 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
     DiscreteTrajectory<Barycentric>::Iterator const& end,
     Instant const& now,
     bool const reverse) const {
+  if (begin == end) {
+    return {};
+  }
+  return PlotMethod2(ComputePlottableSpheres(now), begin, end, reverse);
+}
+
+std::vector<RP2Lines<Length, Camera>> Planetarium::PlotMethod2(
+    std::vector<TrajectoryRange> const& ranges,
+    Instant const& now) const {
+  std::vector<RP2Lines<Length, Camera>> all_lines(ranges.size());
+  if (ranges.empty()) {
+    return all_lines;
+  }
+  auto const plottable_spheres = ComputePlottableSpheres(now);
+  if (plotting_thread_pool_ == nullptr) {
+    for (int i = 0; i < ranges.size(); ++i) {
+      auto const& range = ranges[i];
+      all_lines[i] = PlotMethod2(
+          plottable_spheres, range.begin, range.end, range.reverse);
+    }
+  } else {
+    // Each call writes to its own element of |all_lines|, so no
+    // synchronization is needed beyond waiting for the futures.
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < ranges.size(); ++i) {
+      futures.push_back(plotting_thread_pool_->Add(
+          [this, &all_lines, &plottable_spheres, &range = ranges[i], i]() {
+            all_lines[i] = PlotMethod2(
+                plottable_spheres, range.begin, range.end, range.reverse);
+          }));
+    }
+    for (auto& future : futures) {
+      future.wait();
+    }
+  }
+  return all_lines;
+}
+
+RP2Lines<Length, Camera> Planetarium::PlotMethod2(
+    SphereHierarchy<Navigation, Camera> const& plottable_spheres,
+    DiscreteTrajectory<Barycentric>::Iterator const& begin,
+    DiscreteTrajectory<Barycentric>::Iterator const& end,
+    bool const reverse) const {
   RP2Lines<Length, Camera> lines;
   if (begin == end) {
     return lines;
@@ -147,7 +203,6 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
 
   double const tan²_angular_resolution =
       Pow<2>(parameters_.tan_angular_resolution_);
-  auto const plottable_spheres = ComputePlottableSpheres(now);
   auto const& trajectory = *begin.trajectory();
   auto const begin_time = std::max(begin.time(), plotting_frame_->t_min());
   auto const last_time = std::min(last.time(), plotting_frame_->t_max());
@@ -158,7 +213,7 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
     return lines;
   }
   RigidMotion<Barycentric, Navigation> to_plotting_frame_at_t =
-      plotting_frame_->ToThisFrameAtTime(previous_time);
+      ToPlottingFrameAtTime(previous_time);
   DegreesOfFreedom<Navigation> const initial_degrees_of_freedom =
       to_plotting_frame_at_t(
           trajectory.EvaluateDegreesOfFreedom(previous_time));
@@ -196,7 +251,7 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
       }
       Position<Navigation> const extrapolated_position =
           previous_position + previous_velocity * Δt;
-      to_plotting_frame_at_t = plotting_frame_->ToThisFrameAtTime(t);
+      to_plotting_frame_at_t = ToPlottingFrameAtTime(t);
       degrees_of_freedom_in_barycentric =
           trajectory.EvaluateDegreesOfFreedom(t);
       position = to_plotting_frame_at_t.rigid_transformation()(
@@ -241,10 +296,17 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
   return lines;
 }
 
-std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
+RigidMotion<Barycentric, Navigation> Planetarium::ToPlottingFrameAtTime(
+    Instant const& t) const {
+  return plotting_frame_motion_cache_ == nullptr
+             ? plotting_frame_->ToThisFrameAtTime(t)
+             : plotting_frame_motion_cache_->ToThisFrameAtTime(t);
+}
+
+SphereHierarchy<Navigation, Camera> Planetarium::ComputePlottableSpheres(
     Instant const& now) const {
   RigidMotion<Barycentric, Navigation> const rigid_motion_at_now =
-      plotting_frame_->ToThisFrameAtTime(now);
+      ToPlottingFrameAtTime(now);
   std::vector<Sphere<Navigation>> plottable_spheres;
 
   auto const& bodies = ephemeris_->bodies();
@@ -263,11 +325,12 @@ std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
       plottable_spheres.emplace_back(std::move(plottable_sphere));
     }
   }
-  return plottable_spheres;
+  return SphereHierarchy<Navigation, Camera>(perspective_,
+                                             std::move(plottable_spheres));
 }
 
 Segments<Navigation> Planetarium::ComputePlottableSegments(
-    const std::vector<Sphere<Navigation>>& plottable_spheres,
+    SphereHierarchy<Navigation, Camera> const& plottable_spheres,
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
     DiscreteTrajectory<Barycentric>::Iterator const& end) const {
   Segments<Navigation> all_segments;
@@ -277,7 +340,7 @@ Segments<Navigation> Planetarium::ComputePlottableSegments(
   auto it1 = begin;
   Instant t1 = it1.time();
   RigidMotion<Barycentric, Navigation> rigid_motion_at_t1 =
-      plotting_frame_->ToThisFrameAtTime(t1);
+      ToPlottingFrameAtTime(t1);
   Position<Navigation> p1 =
       rigid_motion_at_t1(it1.degrees_of_freedom()).position();
 
@@ -288,7 +351,7 @@ Segments<Navigation> Planetarium::ComputePlottableSegments(
 
     // Transform the degrees of freedom to the plotting frame.
     RigidMotion<Barycentric, Navigation> const rigid_motion_at_t2 =
-        plotting_frame_->ToThisFrameAtTime(t2);
+        ToPlottingFrameAtTime(t2);
     Position<Navigation> const p2 =
         rigid_motion_at_t2(it2.degrees_of_freedom()).position();
 
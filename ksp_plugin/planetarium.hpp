@@ -1,9 +1,11 @@
 ﻿
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "base/not_null.hpp"
+#include "base/thread_pool.hpp"
 #include "geometry/named_quantities.hpp"
 #include "geometry/orthogonal_map.hpp"
 #include "geometry/perspective.hpp"
@@ -13,6 +15,7 @@
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
+#include "physics/frame_motion_cache.hpp"
 #include "physics/rigid_motion.hpp"
 #include "quantities/quantities.hpp"
 
@@ -21,6 +24,7 @@ namespace ksp_plugin {
 namespace internal_planetarium {
 
 using base::not_null;
+using base::ThreadPool;
 using geometry::Displacement;
 using geometry::Instant;
 using geometry::OrthogonalMap;
@@ -30,9 +34,11 @@ using geometry::RP2Point;
 using geometry::Segment;
 using geometry::Segments;
 using geometry::Sphere;
+using geometry::SphereHierarchy;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
+using physics::FrameMotionCache;
 using physics::RigidMotion;
 using quantities::Angle;
 using quantities::Length;
@@ -59,12 +65,29 @@ class Planetarium {
     friend class Planetarium;
   };
 
+  // A part of a trajectory to be plotted, in the direction given by
+  // |reverse|.
+  struct TrajectoryRange final {
+    DiscreteTrajectory<Barycentric>::Iterator begin;
+    DiscreteTrajectory<Barycentric>::Iterator end;
+    bool reverse;
+  };
+
   // TODO(phl): All this Navigation is weird.  Should it be named Plotting?
   // In particular Navigation vs. NavigationFrame is a mess.
+  // If |plotting_frame_motion_cache| is not null, it must be a cache of the
+  // motion of |plotting_frame|; it is then used to transform the trajectories
+  // to the plotting frame, in place of the exact computation.  The planetarium
+  // shares the ownership of the cache.  If
+  // |plotting_thread_pool| is not null, it is used to plot multiple ranges in
+  // parallel.
   Planetarium(Parameters const& parameters,
               Perspective<Navigation, Camera> const& perspective,
               not_null<Ephemeris<Barycentric> const*> ephemeris,
-              not_null<NavigationFrame const*> plotting_frame);
+              not_null<NavigationFrame const*> plotting_frame,
+              std::shared_ptr<FrameMotionCache<Barycentric, Navigation> const>
+                  plotting_frame_motion_cache = nullptr,
+              ThreadPool<void>* plotting_thread_pool = nullptr);
 
   // A no-op method that just returns all the points in the trajectory defined
   // by |begin| and |end|.
@@ -88,16 +111,37 @@ class Planetarium {
       Instant const& now,
       bool reverse) const;
 
+  // Plots each of the |ranges| using |PlotMethod2|, in parallel if this object
+  // has a thread pool.  The spheres are computed only once, at time |now|.
+  // The result has one element per range, in the same order as |ranges|.
+  std::vector<RP2Lines<Length, Camera>> PlotMethod2(
+      std::vector<TrajectoryRange> const& ranges,
+      Instant const& now) const;
+
  private:
+  // The implementation of |PlotMethod2| for the given |plottable_spheres|.
+  RP2Lines<Length, Camera> PlotMethod2(
+      SphereHierarchy<Navigation, Camera> const& plottable_spheres,
+      DiscreteTrajectory<Barycentric>::Iterator const& begin,
+      DiscreteTrajectory<Barycentric>::Iterator const& end,
+      bool reverse) const;
+
+  // The motion of the |plotting_frame_| at |t|, possibly from the
+  // |plotting_frame_motion_cache_|.
+  RigidMotion<Barycentric, Navigation> ToPlottingFrameAtTime(
+      Instant const& t) const;
+
   // Computes the coordinates of the spheres that represent the |ephemeris_|
   // bodies.  These coordinates are in the |plotting_frame_| at time |now|.
-  std::vector<Sphere<Navigation>> ComputePlottableSpheres(
+  // The spheres are returned in a hierarchy for the |perspective_| so that
+  // hiding only tests the spheres that may hide a segment.
+  SphereHierarchy<Navigation, Camera> ComputePlottableSpheres(
       Instant const& now) const;
 
   // Computes the segments of the trajectory defined by |begin| and |end| that
   // are not hidden by the |plottable_spheres|.
   Segments<Navigation> ComputePlottableSegments(
-      const std::vector<Sphere<Navigation>>& plottable_spheres,
+      SphereHierarchy<Navigation, Camera> const& plottable_spheres,
       DiscreteTrajectory<Barycentric>::Iterator const& begin,
       DiscreteTrajectory<Barycentric>::Iterator const& end) const;
 
@@ -105,6 +149,9 @@ class Planetarium {
   Perspective<Navigation, Camera> const perspective_;
   not_null<Ephemeris<Barycentric> const*> const ephemeris_;
   not_null<NavigationFrame const*> const plotting_frame_;
+  std::shared_ptr<FrameMotionCache<Barycentric, Navigation> const> const
+      plotting_frame_motion_cache_;
+  ThreadPool<void>* const plotting_thread_pool_;
 };
 
 }  // namespace internal_planetarium
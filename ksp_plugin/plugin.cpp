@@ -5,10 +5,13 @@
 #include <cmath>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <ios>
+#include <iterator>
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
 #include <thread>
@@ -106,13 +109,20 @@ using ::operator<<;
 Plugin::Plugin(std::string const& game_epoch,
                std::string const& solar_system_epoch,
                Angle const& planetarium_rotation)
-    : history_parameters_(DefaultHistoryParameters()),
+    : ephemeris_thread_pool_(
+          /*pool_size=*/std::thread::hardware_concurrency()),
+      history_parameters_(DefaultHistoryParameters()),
       psychohistory_parameters_(DefaultPsychohistoryParameters()),
       vessel_thread_pool_(
           /*pool_size=*/2 * std::thread::hardware_concurrency()),
+      plotting_thread_pool_(
+          /*pool_size=*/std::thread::hardware_concurrency()),
+      coasting_thread_pool_(
+          /*pool_size=*/std::thread::hardware_concurrency()),
       planetarium_rotation_(planetarium_rotation),
       game_epoch_(ParseTT(game_epoch)),
-      current_time_(ParseTT(solar_system_epoch)) {
+      current_time_(ParseTT(solar_system_epoch)),
+      coasting_pile_ups_(&coasting_thread_pool_) {
   gravity_model_.set_plugin_frame(serialization::Frame::BARYCENTRIC);
   initial_state_.set_epoch(solar_system_epoch);
   initial_state_.set_plugin_frame(serialization::Frame::BARYCENTRIC);
@@ -223,6 +233,7 @@ void Plugin::EndInitialization() {
                                      DefaultEphemerisAccuracyParameters()),
                                  ephemeris_fixed_step_parameters_.value_or(
                                      DefaultEphemerisFixedStepParameters()));
+  ephemeris_->SetFittingThreadPool(&ephemeris_thread_pool_);
 
   // Construct the celestials using the bodies from the ephemeris.
   for (std::string const& name : solar_system.names()) {
@@ -708,9 +719,15 @@ void Plugin::AdvanceTime(Instant const& t, Angle const& planetarium_rotation) {
 void Plugin::CatchUpLaggingVessels(VesselSet& collided_vessels) {
   CHECK(!initializing_);
 
-  // Start all the integrations in parallel.
+  // Start the integrations of the pile-ups subject to an intrinsic force in
+  // parallel.
   std::vector<PileUpFuture> pile_up_futures;
+  std::vector<not_null<PileUp*>> coasting_pile_ups;
   for (auto* const pile_up : pile_ups_) {
+    if (pile_up->is_coasting()) {
+      coasting_pile_ups.push_back(pile_up);
+      continue;
+    }
     pile_up_futures.emplace_back(
         pile_up,
         vessel_thread_pool_.Add([this, pile_up]() {
@@ -720,6 +737,14 @@ void Plugin::CatchUpLaggingVessels(VesselSet& collided_vessels) {
         }));
   }
 
+  // Integrate the histories of the coasting pile-ups in batches.  The batches
+  // and the rest of the advancement of each pile-up run in parallel.
+  auto coasting_pile_up_futures = coasting_pile_ups_.AdvanceTime(
+      coasting_pile_ups, current_time_, vessel_thread_pool_);
+  std::move(coasting_pile_up_futures.begin(),
+            coasting_pile_up_futures.end(),
+            std::back_inserter(pile_up_futures));
+
   // Wait for the integrations to finish and figure out which vessels collided
   // with a celestial.
   for (auto& pile_up_future : pile_up_futures) {
@@ -729,7 +754,7 @@ void Plugin::CatchUpLaggingVessels(VesselSet& collided_vessels) {
   // Update the vessels.
   for (auto const& pair : vessels_) {
     Vessel& vessel = *pair.second;
-    if (vessel.psychohistory().last().time() < current_time_) {
+    if (vessel.psychohistory_last().time() < current_time_) {
       if (Contains(collided_vessels, &vessel)) {
         vessel.DisableDownsampling();
       }
@@ -803,7 +828,7 @@ RelativeDegreesOfFreedom<AliceSun> Plugin::VesselFromParent(
     vessel->set_parent(parent);
   }
   RelativeDegreesOfFreedom<Barycentric> const barycentric_result =
-      vessel->psychohistory().last().degrees_of_freedom() -
+      vessel->psychohistory_last().degrees_of_freedom() -
       vessel->parent()->current_degrees_of_freedom(current_time_);
   RelativeDegreesOfFreedom<AliceSun> const result =
       PlanetariumRotation()(barycentric_result);
@@ -846,6 +871,12 @@ void Plugin::UpdatePrediction(GUID const& vessel_guid) const {
   FindOrDie(vessels_, vessel_guid)->FlowPrediction(InfiniteFuture);
 }
 
+void Plugin::RequestPrediction(GUID const& vessel_guid) {
+  CHECK(!initializing_);
+  FindOrDie(vessels_, vessel_guid)->RequestPrediction(InfiniteFuture,
+                                                      &vessel_thread_pool_);
+}
+
 void Plugin::CreateFlightPlan(GUID const& vessel_guid,
                               Instant const& final_time,
                               Mass const& initial_mass) const {
@@ -961,10 +992,13 @@ not_null<std::unique_ptr<Planetarium>> Plugin::NewPlanetarium(
     Planetarium::Parameters const& parameters,
     Perspective<Navigation, Camera> const& perspective)
     const {
-  return make_not_null_unique<Planetarium>(parameters,
-                                           perspective,
-                                           ephemeris_.get(),
-                                           renderer_->GetPlottingFrame());
+  return make_not_null_unique<Planetarium>(
+      parameters,
+      perspective,
+      ephemeris_.get(),
+      renderer_->GetPlottingFrame(),
+      renderer_->GetPlottingFrameMotionCache(),
+      &plotting_thread_pool_);
 }
 
 not_null<std::unique_ptr<NavigationFrame>>
@@ -1157,7 +1191,7 @@ Velocity<World> Plugin::UnmanageableVesselVelocity(
 
 Velocity<World> Plugin::VesselVelocity(GUID const& vessel_guid) const {
   Vessel const& vessel = *FindOrDie(vessels_, vessel_guid);
-  auto const& last = vessel.psychohistory().last();
+  auto const last = vessel.psychohistory_last();
   return VesselVelocity(last.time(), last.degrees_of_freedom());
 }
 
@@ -1184,75 +1218,24 @@ Renderer const& Plugin::renderer() const {
 void Plugin::WriteToMessage(
     not_null<serialization::Plugin*> const message) const {
   LOG(INFO) << __FUNCTION__;
-  CHECK(!initializing_);
-  ephemeris_->Prolong(current_time_);
-  std::map<not_null<Celestial const*>, Index const> celestial_to_index;
-  for (auto const& pair : celestials_) {
-    Index const index = pair.first;
-    auto const& owned_celestial = pair.second;
-    celestial_to_index.emplace(owned_celestial.get(), index);
+  for (auto const& write_part : SerializationParts()) {
+    write_part(message);
   }
-  for (auto const& pair : celestials_) {
-    Index const index = pair.first;
-    auto const& owned_celestial = pair.second.get();
-    auto* const celestial_message = message->add_celestial();
-    celestial_message->set_index(index);
-    if (owned_celestial->has_parent()) {
-      Index const parent_index =
-          FindOrDie(celestial_to_index, owned_celestial->parent());
-      celestial_message->set_parent_index(parent_index);
-    }
-    celestial_message->set_ephemeris_index(
-        ephemeris_->serialization_index_for_body(owned_celestial->body()));
-  }
-
-  // Construct a map to help serialization of the pile-ups.
-  std::map<not_null<PileUp const*>, int> serialization_index_to_pile_up;
-  int serialization_index = 0;
-  for (auto const* pile_up : pile_ups_) {
-    serialization_index_to_pile_up[pile_up] = serialization_index++;
-  }
-  auto const serialization_index_for_pile_up =
-      [&serialization_index_to_pile_up](not_null<PileUp const*> const pile_up) {
-        return serialization_index_to_pile_up.at(pile_up);
-      };
-
-  std::map<not_null<Vessel const*>, GUID const> vessel_to_guid;
-  for (auto const& pair : vessels_) {
-    std::string const& guid = pair.first;
-    not_null<Vessel*> const vessel = pair.second.get();
-    vessel_to_guid.emplace(vessel, guid);
-    auto* const vessel_message = message->add_vessel();
-    vessel_message->set_guid(guid);
-    vessel->WriteToMessage(vessel_message->mutable_vessel(),
-                           serialization_index_for_pile_up);
-    Index const parent_index = FindOrDie(celestial_to_index, vessel->parent());
-    vessel_message->set_parent_index(parent_index);
-    vessel_message->set_loaded(Contains(loaded_vessels_, vessel));
-    vessel_message->set_kept(Contains(kept_vessels_, vessel));
-  }
-  for (auto const& pair : part_id_to_vessel_) {
-    PartId const part_id = pair.first;
-    not_null<Vessel*> const vessel = pair.second;
-    (*message->mutable_part_id_to_vessel())[part_id] = vessel_to_guid[vessel];
-  }
-
-  ephemeris_->WriteToMessage(message->mutable_ephemeris());
-
-  history_parameters_.WriteToMessage(message->mutable_history_parameters());
-  psychohistory_parameters_.WriteToMessage(
-      message->mutable_psychohistory_parameters());
-
-  planetarium_rotation_.WriteToMessage(message->mutable_planetarium_rotation());
-  game_epoch_.WriteToMessage(message->mutable_game_epoch());
-  current_time_.WriteToMessage(message->mutable_current_time());
-  Index const sun_index = FindOrDie(celestial_to_index, sun_);
-  message->set_sun_index(sun_index);
-  renderer_->WriteToMessage(message->mutable_renderer());
+}
 
-  for (auto* const pile_up : pile_ups_) {
-    pile_up->WriteToMessage(message->add_pile_up());
-  }
+Plugin::SerializationPartWriter Plugin::SerializeInParts() const {
+  LOG(INFO) << __FUNCTION__;
+  auto const parts = std::make_shared<
+      std::vector<std::function<void(not_null<serialization::Plugin*>)>>>(
+          SerializationParts());
+  auto const next_part = std::make_shared<std::size_t>(0);
+  return [parts, next_part](not_null<serialization::Plugin*> const message) {
+    if (*next_part == parts->size()) {
+      return false;
+    }
+    (*parts)[(*next_part)++](message);
+    return true;
+  };
 }
 
 not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
@@ -1271,6 +1254,7 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
 
   plugin->ephemeris_ =
       Ephemeris<Barycentric>::ReadFromMessage(message.ephemeris());
+  plugin->ephemeris_->SetFittingThreadPool(&plugin->ephemeris_thread_pool_);
   ReadCelestialsFromMessages(*plugin->ephemeris_,
                              message.celestial(),
                              plugin->celestials_,
@@ -1381,10 +1365,17 @@ Plugin::Plugin(
     Ephemeris<Barycentric>::FixedStepParameters const& history_parameters,
     Ephemeris<Barycentric>::AdaptiveStepParameters const&
         psychohistory_parameters)
-    : history_parameters_(history_parameters),
+    : ephemeris_thread_pool_(
+          /*pool_size=*/std::thread::hardware_concurrency()),
+      history_parameters_(history_parameters),
       psychohistory_parameters_(psychohistory_parameters),
       vessel_thread_pool_(
-          /*pool_size=*/2 * std::thread::hardware_concurrency()) {}
+          /*pool_size=*/2 * std::thread::hardware_concurrency()),
+      plotting_thread_pool_(
+          /*pool_size=*/std::thread::hardware_concurrency()),
+      coasting_thread_pool_(
+          /*pool_size=*/std::thread::hardware_concurrency()),
+      coasting_pile_ups_(&coasting_thread_pool_) {}
 
 void Plugin::InitializeIndices(
     std::string const& name,
@@ -1435,6 +1426,110 @@ Velocity<World> Plugin::VesselVelocity(
       plotting_frame_degrees_of_freedom.velocity());
 }
 
+std::vector<std::function<void(not_null<serialization::Plugin*>)>>
+Plugin::SerializationParts() const {
+  CHECK(!initializing_);
+  ephemeris_->Prolong(current_time_);
+
+  // The maps from celestials and pile-ups to their serialization indices are
+  // shared by the parts.
+  auto const celestial_to_index =
+      std::make_shared<std::map<not_null<Celestial const*>, Index const>>();
+  for (auto const& pair : celestials_) {
+    Index const index = pair.first;
+    auto const& owned_celestial = pair.second;
+    celestial_to_index->emplace(owned_celestial.get(), index);
+  }
+  auto const pile_up_to_serialization_index =
+      std::make_shared<std::map<not_null<PileUp const*>, int>>();
+  int serialization_index = 0;
+  for (auto const* pile_up : pile_ups_) {
+    (*pile_up_to_serialization_index)[pile_up] = serialization_index++;
+  }
+  PileUp::SerializationIndexForPileUp const serialization_index_for_pile_up =
+      [pile_up_to_serialization_index](
+          not_null<PileUp const*> const pile_up) {
+        return pile_up_to_serialization_index->at(pile_up);
+      };
+
+  std::vector<std::function<void(not_null<serialization::Plugin*>)>> parts;
+
+  // The global state of the plugin.
+  parts.push_back([this, celestial_to_index](
+                      not_null<serialization::Plugin*> const message) {
+    for (auto const& pair : celestials_) {
+      Index const index = pair.first;
+      auto const& owned_celestial = pair.second.get();
+      auto* const celestial_message = message->add_celestial();
+      celestial_message->set_index(index);
+      if (owned_celestial->has_parent()) {
+        Index const parent_index =
+            FindOrDie(*celestial_to_index, owned_celestial->parent());
+        celestial_message->set_parent_index(parent_index);
+      }
+      celestial_message->set_ephemeris_index(
+          ephemeris_->serialization_index_for_body(owned_celestial->body()));
+    }
+
+    std::map<not_null<Vessel const*>, GUID const> vessel_to_guid;
+    for (auto const& pair : vessels_) {
+      vessel_to_guid.emplace(pair.second.get(), pair.first);
+    }
+    for (auto const& pair : part_id_to_vessel_) {
+      PartId const part_id = pair.first;
+      not_null<Vessel*> const vessel = pair.second;
+      (*message->mutable_part_id_to_vessel())[part_id] =
+          FindOrDie(vessel_to_guid, vessel);
+    }
+
+    history_parameters_.WriteToMessage(message->mutable_history_parameters());
+    psychohistory_parameters_.WriteToMessage(
+        message->mutable_psychohistory_parameters());
+
+    planetarium_rotation_.WriteToMessage(
+        message->mutable_planetarium_rotation());
+    game_epoch_.WriteToMessage(message->mutable_game_epoch());
+    current_time_.WriteToMessage(message->mutable_current_time());
+    Index const sun_index = FindOrDie(*celestial_to_index, sun_);
+    message->set_sun_index(sun_index);
+    renderer_->WriteToMessage(message->mutable_renderer());
+  });
+
+  // The vessels, one part each since their histories make up most of the
+  // serialization.
+  for (auto const& pair : vessels_) {
+    std::string const& guid = pair.first;
+    not_null<Vessel*> const vessel = pair.second.get();
+    parts.push_back([this,
+                     celestial_to_index,
+                     guid,
+                     serialization_index_for_pile_up,
+                     vessel](not_null<serialization::Plugin*> const message) {
+      auto* const vessel_message = message->add_vessel();
+      vessel_message->set_guid(guid);
+      vessel->WriteToMessage(vessel_message->mutable_vessel(),
+                             serialization_index_for_pile_up);
+      Index const parent_index =
+          FindOrDie(*celestial_to_index, vessel->parent());
+      vessel_message->set_parent_index(parent_index);
+      vessel_message->set_loaded(Contains(loaded_vessels_, vessel));
+      vessel_message->set_kept(Contains(kept_vessels_, vessel));
+    });
+  }
+
+  parts.push_back([this](not_null<serialization::Plugin*> const message) {
+    ephemeris_->WriteToMessage(message->mutable_ephemeris());
+  });
+
+  parts.push_back([this](not_null<serialization::Plugin*> const message) {
+    for (auto* const pile_up : pile_ups_) {
+      pile_up->WriteToMessage(message->add_pile_up());
+    }
+  });
+
+  return parts;
+}
+
 template<typename T>
 void Plugin::ReadCelestialsFromMessages(
     Ephemeris<Barycentric> const& ephemeris,
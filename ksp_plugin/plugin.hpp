@@ -1,6 +1,7 @@
 ﻿
 #pragma once
 
+#include <functional>
 #include <future>
 #include <limits>
 #include <list>
@@ -20,6 +21,7 @@
 #include "geometry/perspective.hpp"
 #include "geometry/point.hpp"
 #include "ksp_plugin/celestial.hpp"
+#include "ksp_plugin/coasting_pile_ups.hpp"
 #include "ksp_plugin/frames.hpp"
 #include "ksp_plugin/manœuvre.hpp"
 #include "ksp_plugin/planetarium.hpp"
@@ -322,6 +324,12 @@ class Plugin {
   // Updates the prediction for the vessel with guid |vessel_guid|.
   void UpdatePrediction(GUID const& vessel_guid) const;
 
+  // Same as above, but the prediction is computed on a background thread so
+  // that this method doesn't block.  The prediction of the vessel becomes the
+  // one computed by the last completed request, if any; see
+  // |Vessel::RequestPrediction|.
+  virtual void RequestPrediction(GUID const& vessel_guid);
+
   virtual void CreateFlightPlan(GUID const& vessel_guid,
                                 Instant const& final_time,
                                 Mass const& initial_mass) const;
@@ -416,8 +424,22 @@ class Plugin {
   virtual Renderer& renderer();
   virtual Renderer const& renderer() const;
 
+  // Writes the next part of the serialization of a plugin to |message| and
+  // returns true, or returns false if all the parts have been written.
+  using SerializationPartWriter =
+      std::function<bool(not_null<serialization::Plugin*> message)>;
+
   // Must be called after initialization.
   virtual void WriteToMessage(not_null<serialization::Plugin*> message) const;
+
+  // Must be called after initialization.  Prolongs the ephemeris and returns an
+  // object that writes the serialization of this plugin in parts, one per
+  // vessel plus a few for the global state.  Merging the parts, or parsing the
+  // concatenation of their serializations, yields the message written by
+  // |WriteToMessage|.  The returned object may be called on any thread, but the
+  // plugin must not be modified until it has returned false.
+  virtual SerializationPartWriter SerializeInParts() const;
+
   static not_null<std::unique_ptr<Plugin>> ReadFromMessage(
       serialization::Plugin const& message);
 
@@ -446,6 +468,11 @@ class Plugin {
       Instant const& time,
       DegreesOfFreedom<Barycentric> const& degrees_of_freedom) const;
 
+  // Prolongs the ephemeris and returns functions that write the successive
+  // parts of the serialization of this plugin.
+  std::vector<std::function<void(not_null<serialization::Plugin*>)>>
+  SerializationParts() const;
+
   // Fill |celestials| using the |index| and |parent_index| fields found in
   // |celestial_messages|.
   template<typename T>
@@ -488,6 +515,10 @@ class Plugin {
   std::map<PartId, not_null<Vessel*>> part_id_to_vessel_;
   IndexToOwnedCelestial celestials_;
 
+  // The thread pool for fitting the trajectories of the celestials.  Declared
+  // before |ephemeris_| which uses it.
+  ThreadPool<Status> ephemeris_thread_pool_;
+
   // Not null after initialization.
   std::unique_ptr<Ephemeris<Barycentric>> ephemeris_;
 
@@ -498,6 +529,15 @@ class Plugin {
   // The thread pool for advancing vessels.
   ThreadPool<Status> vessel_thread_pool_;
 
+  // The thread pool for plotting trajectories in the planetaria.  Mutable
+  // because the planetaria are created by a const member function; the pool
+  // is thread-safe anyway.
+  mutable ThreadPool<void> plotting_thread_pool_;
+
+  // The thread pool for computing the accelerations of the coasting pile-ups.
+  // Declared before |coasting_pile_ups_| which uses it.
+  ThreadPool<void> coasting_thread_pool_;
+
   Angle planetarium_rotation_;
   std::optional<Rotation<Barycentric, AliceSun>> cached_planetarium_rotation_;
   // The game epoch in real time.
@@ -518,6 +558,10 @@ class Plugin {
   // not |not_null<>| because we temporarily need to insert null pointers.
   std::list<PileUp*> pile_ups_;
 
+  // Integrates in batches the histories of the pile-ups that are not subject to
+  // an intrinsic force.
+  CoastingPileUps coasting_pile_ups_;
+
   // The vessels that are currently loaded, i.e. in the physics bubble.
   VesselSet loaded_vessels_;
   // The vessels that will be kept during the next call to |AdvanceTime|.
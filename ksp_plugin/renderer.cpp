@@ -9,11 +9,13 @@
 #include "physics/apsides.hpp"
 #include "physics/body_centred_body_direction_dynamic_frame.hpp"
 #include "physics/degrees_of_freedom.hpp"
+#include "quantities/si.hpp"
 
 namespace principia {
 namespace ksp_plugin {
 namespace internal_renderer {
 
+using base::make_not_null_shared;
 using base::make_not_null_unique;
 using geometry::AngularVelocity;
 using geometry::RigidTransformation;
@@ -23,20 +25,44 @@ using physics::BodyCentredBodyDirectionDynamicFrame;
 using physics::ComputeApsides;
 using physics::ComputeNodes;
 using physics::DegreesOfFreedom;
+using quantities::Time;
+using quantities::si::Minute;
+
+namespace {
+
+// The spacing of the nodes of the cache of the motion of the plotting frame.
+// This is commensurate with the step of the ephemeris, and small enough that
+// the motion of the frames of the celestials is accurately interpolated.
+constexpr Time plotting_frame_motion_cache_step = 10 * Minute;
+
+}  // namespace
 
 Renderer::Renderer(not_null<Celestial const*> const sun,
                    not_null<std::unique_ptr<NavigationFrame>> plotting_frame)
     : sun_(sun),
-      plotting_frame_(std::move(plotting_frame)) {}
+      plotting_frame_(
+          make_not_null_shared<PlottingFrame>(std::move(plotting_frame))) {}
 
 void Renderer::SetPlottingFrame(
     not_null<std::unique_ptr<NavigationFrame>> plotting_frame) {
-  plotting_frame_ = std::move(plotting_frame);
+  plotting_frame_ =
+      make_not_null_shared<PlottingFrame>(std::move(plotting_frame));
 }
 
 not_null<NavigationFrame const*> Renderer::GetPlottingFrame() const {
   return target_ ? target_->target_frame.get()
-                 : plotting_frame_.get();
+                 : plotting_frame_->frame.get();
+}
+
+std::shared_ptr<FrameMotionCache<Barycentric, Navigation> const>
+Renderer::GetPlottingFrameMotionCache() const {
+  if (target_) {
+    return nullptr;
+  }
+  // The aliasing constructor makes the cache keep its frame alive.
+  std::shared_ptr<PlottingFrame> const plotting_frame = plotting_frame_;
+  return std::shared_ptr<FrameMotionCache<Barycentric, Navigation> const>(
+      plotting_frame, &plotting_frame->motion_cache);
 }
 
 void Renderer::SetTargetVessel(
@@ -286,7 +312,7 @@ RigidTransformation<World, Navigation> Renderer::WorldToPlotting(
 
 void Renderer::WriteToMessage(
     not_null<serialization::Renderer*> message) const {
-  plotting_frame_->WriteToMessage(message->mutable_plotting_frame());
+  plotting_frame_->frame->WriteToMessage(message->mutable_plotting_frame());
   // No serialization of the |target_|.
 }
 
@@ -299,6 +325,11 @@ not_null<std::unique_ptr<Renderer>> Renderer::ReadFromMessage(
       NavigationFrame::ReadFromMessage(message.plotting_frame(), ephemeris));
 }
 
+Renderer::PlottingFrame::PlottingFrame(
+    not_null<std::unique_ptr<NavigationFrame>> frame)
+    : frame(std::move(frame)),
+      motion_cache(this->frame.get(), plotting_frame_motion_cache_step) {}
+
 Renderer::Target::Target(
     not_null<Vessel*> const vessel,
     not_null<Celestial const*> const celestial,
@@ -15,6 +15,7 @@
 #include "physics/discrete_trajectory.hpp"
 #include "physics/dynamic_frame.hpp"
 #include "physics/ephemeris.hpp"
+#include "physics/frame_motion_cache.hpp"
 #include "physics/rigid_motion.hpp"
 #include "quantities/quantities.hpp"
 
@@ -31,6 +32,7 @@ using geometry::RigidTransformation;
 using geometry::Rotation;
 using physics::DiscreteTrajectory;
 using physics::Ephemeris;
+using physics::FrameMotionCache;
 using physics::Frenet;
 using physics::RigidMotion;
 using quantities::Length;
@@ -50,6 +52,14 @@ class Renderer {
   // |SetPlottingFrame| if it is overridden by a target vessel.
   virtual not_null<NavigationFrame const*> GetPlottingFrame() const;
 
+  // Returns a cache of the motion of the frame returned by |GetPlottingFrame|,
+  // to be used for plotting, or null if that frame is overridden by a target
+  // vessel, since the motion of that frame changes with the prediction of the
+  // vessel.  The cache shares the ownership of that frame, so both remain valid
+  // after |SetPlottingFrame|; a new cache is used for the new frame.
+  virtual std::shared_ptr<FrameMotionCache<Barycentric, Navigation> const>
+  GetPlottingFrameMotionCache() const;
+
   // Overrides the current plotting frame with one that is centred on the given
   // |vessel|.
   virtual void SetTargetVessel(
@@ -187,7 +197,16 @@ class Renderer {
 
   not_null<Celestial const*> const sun_;
 
-  not_null<std::unique_ptr<NavigationFrame>> plotting_frame_;
+  // A plotting frame and the cache of its motion.  The cache refers to the
+  // frame, so they are owned together.
+  struct PlottingFrame {
+    explicit PlottingFrame(not_null<std::unique_ptr<NavigationFrame>> frame);
+    not_null<std::unique_ptr<NavigationFrame>> const frame;
+    FrameMotionCache<Barycentric, Navigation> const motion_cache;
+  };
+
+  // Shared with the caches returned by |GetPlottingFrameMotionCache|.
+  not_null<std::shared_ptr<PlottingFrame>> plotting_frame_;
 
   std::optional<Target> target_;
 };
@@ -32,6 +32,30 @@ using quantities::si::Metre;
 constexpr std::int64_t max_dense_intervals = 10'000;
 constexpr Length downsampling_tolerance = 10 * Metre;
 
+namespace {
+
+// Whether the vessel |history| may be packed when it is read: it must have
+// points before the one where the psychohistory is forked.
+bool IsPackable(serialization::DiscreteTrajectory const& history) {
+  if (history.timeline_size() < 2 || history.children_size() != 1) {
+    return false;
+  }
+  auto const& last = history.timeline(history.timeline_size() - 1);
+  return Instant::ReadFromMessage(history.children(0).fork_time()) ==
+         Instant::ReadFromMessage(last.instant());
+}
+
+void AppendToTimeline(Instant const& time,
+                      DegreesOfFreedom<Barycentric> const& degrees_of_freedom,
+                      not_null<serialization::DiscreteTrajectory*> const
+                          message) {
+  auto* const point = message->add_timeline();
+  time.WriteToMessage(point->mutable_instant());
+  degrees_of_freedom.WriteToMessage(point->mutable_degrees_of_freedom());
+}
+
+}  // namespace
+
 Vessel::Vessel(GUID const& guid,
                std::string const& name,
                not_null<Celestial const*> const parent,
@@ -51,6 +75,10 @@ Vessel::Vessel(GUID const& guid,
 
 Vessel::~Vessel() {
   LOG(INFO) << "Destroying vessel " << ShortDebugString();
+  // The background thread may still be flowing the trajectory that we own.
+  if (prediction_future_.valid()) {
+    prediction_future_.wait();
+  }
 }
 
 GUID const& Vessel::guid() const {
@@ -149,6 +177,9 @@ void Vessel::PrepareHistory(Instant const& t) {
 }
 
 void Vessel::DisableDownsampling() {
+  if (packed_history_.has_value()) {
+    packed_history_->downsampling.reset();
+  }
   history_->ClearDownsampling();
 }
 
@@ -206,9 +237,43 @@ void Vessel::AdvanceTime() {
     Part& part = *pair.second;
     part.ClearHistory();
   }
+
+  // The |history_| is not downsampled while the history is packed, so unpack
+  // it before the |history_| grows larger than a dense timeline.
+  if (packed_history_.has_value() &&
+      packed_history_->downsampling.has_value() &&
+      history_->Size() >
+          packed_history_->downsampling->max_dense_intervals()) {
+    UnpackHistory();
+  }
 }
 
 void Vessel::ForgetBefore(Instant const& time) {
+  if (packed_history_.has_value()) {
+    if (time <= packed_history_->base.last_time) {
+      // Only packed points are forgotten, and the first point of the
+      // |history_| is kept.  Forget them without unpacking.
+      auto& points = packed_history_->points;
+      auto const first_kept = std::lower_bound(
+          points.begin(),
+          points.end(),
+          time,
+          [](PackedPoint const& point, Instant const& t) {
+            return point.time < t;
+          });
+      points.erase(points.begin(), first_kept);
+      auto& downsampling = packed_history_->downsampling;
+      if (downsampling.has_value() &&
+          downsampling->has_start_of_dense_timeline() &&
+          Instant::ReadFromMessage(downsampling->start_of_dense_timeline()) <
+              time) {
+        points.front().time.WriteToMessage(
+            downsampling->mutable_start_of_dense_timeline());
+      }
+    } else {
+      UnpackHistory();
+    }
+  }
   // Make sure that the history keeps at least one (authoritative) point and
   // don't change the psychohistory or prediction.  We cannot use the parts
   // because they may have been moved to the future already.
@@ -242,26 +307,41 @@ void Vessel::DeleteFlightPlan() {
 
 void Vessel::FlowPrediction(Instant const& time) {
   if (time > prediction_->last().time()) {
-    bool const finite_time = IsFinite(time - prediction_->last().time());
-    Instant const t = finite_time ? time : ephemeris_->t_max();
-    // This will not prolong the ephemeris if |time| is infinite (but it may do
-    // so if it is finite).
-    bool const reached_t = ephemeris_->FlowWithAdaptiveStep(
-        prediction_,
-        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
-        t,
-        prediction_adaptive_step_parameters_,
-        FlightPlan::max_ephemeris_steps_per_frame,
-        /*last_point_only=*/false).ok();
-    if (!finite_time && reached_t) {
-      // This will prolong the ephemeris by |max_ephemeris_steps_per_frame|.
-      ephemeris_->FlowWithAdaptiveStep(
-        prediction_,
-        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
-        time,
-        prediction_adaptive_step_parameters_,
-        FlightPlan::max_ephemeris_steps_per_frame,
-        /*last_point_only=*/false);
+    FlowUnaccelerated(time,
+                      prediction_adaptive_step_parameters_,
+                      *ephemeris_,
+                      *prediction_);
+  }
+}
+
+void Vessel::RequestPrediction(
+    Instant const& last_time,
+    not_null<ThreadPool<Status>*> const thread_pool) {
+  PredictionRequest const request = MakePredictionRequest(last_time);
+  {
+    absl::MutexLock l(&prediction_lock_);
+    if (prediction_in_flight_) {
+      // The thread computing the prediction will pick up this request when it
+      // is done.
+      queued_prediction_request_ = request;
+      return;
+    }
+    prediction_in_flight_ = true;
+  }
+
+  // The previous computation, if any, is complete or about to be.
+  WaitForPrediction();
+  prediction_future_ = thread_pool->Add([this, request]() {
+    return FlowPredictions(request);
+  });
+}
+
+void Vessel::WaitForPrediction() {
+  if (prediction_future_.valid()) {
+    prediction_future_.get();
+    if (prediction_trajectory_ != nullptr) {
+      AttachPrediction(*prediction_trajectory_);
+      prediction_trajectory_.reset();
     }
   }
 }
@@ -270,6 +350,25 @@ DiscreteTrajectory<Barycentric> const& Vessel::psychohistory() const {
   return *psychohistory_;
 }
 
+DiscreteTrajectory<Barycentric>::Iterator Vessel::psychohistory_last() const {
+  return psychohistory_->last();
+}
+
+void Vessel::UnpackHistory() {
+  if (!packed_history_.has_value()) {
+    return;
+  }
+  LOG(INFO) << "Unpacking the history of vessel " << ShortDebugString();
+  serialization::DiscreteTrajectory message;
+  WritePackedHistoryToMessage(&message);
+  psychohistory_ = nullptr;
+  prediction_ = nullptr;
+  history_ = DiscreteTrajectory<Barycentric>::ReadFromMessage(
+      message,
+      /*forks=*/{&psychohistory_, &prediction_});
+  packed_history_.reset();
+}
+
 void Vessel::WriteToMessage(not_null<serialization::Vessel*> const message,
                             PileUp::SerializationIndexForPileUp const&
                                 serialization_index_for_pile_up) const {
@@ -286,8 +385,12 @@ void Vessel::WriteToMessage(not_null<serialization::Vessel*> const message,
     CHECK(Contains(parts_, part_id));
     message->add_kept_parts(part_id);
   }
-  history_->WriteToMessage(message->mutable_history(),
-                           /*forks=*/{psychohistory_, prediction_});
+  if (!packed_history_.has_value()) {
+    history_->WriteToMessage(message->mutable_history(),
+                             /*forks=*/{psychohistory_, prediction_});
+  } else {
+    WritePackedHistoryToMessage(message->mutable_history());
+  }
   if (flight_plan_ != nullptr) {
     flight_plan_->WriteToMessage(message->mutable_flight_plan());
   }
@@ -352,10 +455,40 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
         /*forks=*/{&vessel->psychohistory_});
     vessel->prediction_ = vessel->psychohistory_->NewForkAtLast();
     vessel->FlowPrediction(InfiniteFuture);
-  } else {
+  } else if (is_pre_陈景润 || !IsPackable(message.history())) {
     vessel->history_ = DiscreteTrajectory<Barycentric>::ReadFromMessage(
         message.history(),
         /*forks=*/{&vessel->psychohistory_, &vessel->prediction_});
+  } else {
+    // Only deserialize the last point of the history, where the psychohistory
+    // is forked, and keep the other points packed.
+    auto const& history = message.history();
+    PackedHistory packed_history;
+    packed_history.points.reserve(history.timeline_size());
+    for (auto const& point : history.timeline()) {
+      packed_history.points.push_back(
+          {Instant::ReadFromMessage(point.instant()),
+           DegreesOfFreedom<Barycentric>::ReadFromMessage(
+               point.degrees_of_freedom())});
+    }
+    if (history.has_downsampling()) {
+      packed_history.downsampling = history.downsampling();
+    }
+
+    // The last point is serialized again so that the base has the fingerprint
+    // that |WriteDeltaToMessage| computes for the first point of the
+    // |history_|.
+    auto const& last = packed_history.points.back();
+    serialization::DiscreteTrajectory last_point;
+    AppendToTimeline(last.time, last.degrees_of_freedom, &last_point);
+    packed_history.base =
+        DiscreteTrajectory<Barycentric>::LastPointDeltaBase(last_point);
+    *last_point.mutable_children() = history.children();
+    *last_point.mutable_fork_position() = history.fork_position();
+    vessel->history_ = DiscreteTrajectory<Barycentric>::ReadFromMessage(
+        last_point,
+        /*forks=*/{&vessel->psychohistory_, &vessel->prediction_});
+    vessel->packed_history_ = std::move(packed_history);
   }
 
   if (is_pre_陈景润) {
@@ -392,6 +525,155 @@ Vessel::Vessel()
       ephemeris_(testing_utilities::make_not_null<Ephemeris<Barycentric>*>()),
       history_(make_not_null_unique<DiscreteTrajectory<Barycentric>>()) {}
 
+Status Vessel::FlowUnaccelerated(
+    Instant const& last_time,
+    Ephemeris<Barycentric>::AdaptiveStepParameters const&
+        adaptive_step_parameters,
+    Ephemeris<Barycentric>& ephemeris,
+    DiscreteTrajectory<Barycentric>& trajectory) {
+  bool const finite_time = IsFinite(last_time - trajectory.last().time());
+  Instant const t = finite_time ? last_time : ephemeris.t_max();
+  // This will not prolong the ephemeris if |last_time| is infinite (but it may
+  // do so if it is finite).
+  Status status = ephemeris.FlowWithAdaptiveStep(
+      &trajectory,
+      Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+      t,
+      adaptive_step_parameters,
+      FlightPlan::max_ephemeris_steps_per_frame,
+      /*last_point_only=*/false);
+  if (!finite_time && status.ok()) {
+    // This will prolong the ephemeris by |max_ephemeris_steps_per_frame|.
+    status = ephemeris.FlowWithAdaptiveStep(
+        &trajectory,
+        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+        last_time,
+        adaptive_step_parameters,
+        FlightPlan::max_ephemeris_steps_per_frame,
+        /*last_point_only=*/false);
+  }
+  return status;
+}
+
+Vessel::PredictionRequest Vessel::MakePredictionRequest(
+    Instant const& last_time) {
+  auto const psychohistory_last = psychohistory_->last();
+
+  // Prolonging the ephemeris changes the continuous trajectories of the
+  // bodies, which the main thread and the plotting threads read without
+  // synchronization.  Therefore, the ephemeris is prolonged here, as
+  // |FlowUnaccelerated| would, and the background computation doesn't go
+  // beyond its |t_max()|.  If |last_time| is infinite, the ephemeris is only
+  // prolonged if the last prediction reached its end: otherwise the prediction
+  // is lagging or was stopped, e.g., next to a singularity, and prolonging the
+  // ephemeris at every request would make it grow without bound.
+  if (IsFinite(last_time - psychohistory_last.time())) {
+    ephemeris_->Prolong(last_time);
+  } else if (prediction_->last().time() >= ephemeris_->t_max()) {
+    ephemeris_->Prolong(ephemeris_->t_max() +
+                        FlightPlan::max_ephemeris_steps_per_frame *
+                            ephemeris_->fixed_step_parameters().step());
+  }
+  return {psychohistory_last.time(),
+          psychohistory_last.degrees_of_freedom(),
+          std::min(last_time, ephemeris_->t_max()),
+          prediction_adaptive_step_parameters_};
+}
+
+Status Vessel::FlowPredictions(PredictionRequest request) {
+  for (;;) {
+    auto trajectory = std::make_unique<DiscreteTrajectory<Barycentric>>();
+    trajectory->Append(request.fork_time, request.fork_degrees_of_freedom);
+    Status const status = ephemeris_->FlowWithAdaptiveStep(
+        trajectory.get(),
+        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+        request.last_time,
+        request.adaptive_step_parameters,
+        /*max_ephemeris_steps=*/0,
+        /*last_point_only=*/false);
+    prediction_trajectory_ = std::move(trajectory);
+
+    absl::MutexLock l(&prediction_lock_);
+    if (!queued_prediction_request_.has_value()) {
+      prediction_in_flight_ = false;
+      return status;
+    }
+    request = *queued_prediction_request_;
+    queued_prediction_request_.reset();
+  }
+}
+
+void Vessel::AttachPrediction(
+    DiscreteTrajectory<Barycentric> const& trajectory) {
+  auto const psychohistory_last = psychohistory_->last();
+  auto const fork = trajectory.Begin();
+  if (fork.time() != psychohistory_last.time() ||
+      fork.degrees_of_freedom() != psychohistory_last.degrees_of_freedom()) {
+    // The psychohistory has changed since the prediction was requested.
+    return;
+  }
+  if (trajectory.last().time() <= prediction_->last().time()) {
+    return;
+  }
+  psychohistory_->DeleteFork(prediction_);
+  prediction_ = psychohistory_->NewForkAtLast();
+  for (auto it = trajectory.Begin(); it != trajectory.End(); ++it) {
+    if (it.time() > prediction_->last().time()) {
+      prediction_->Append(it.time(), it.degrees_of_freedom());
+    }
+  }
+}
+
+void Vessel::WritePackedHistoryToMessage(
+    not_null<serialization::DiscreteTrajectory*> const message) const {
+  CHECK(packed_history_.has_value()) << ShortDebugString();
+  serialization::DiscreteTrajectory delta;
+  history_->WriteDeltaToMessage(&delta,
+                                /*forks=*/{psychohistory_, prediction_},
+                                packed_history_->base);
+
+  message->Clear();
+  for (auto const& point : packed_history_->points) {
+    AppendToTimeline(point.time, point.degrees_of_freedom, message);
+  }
+  if (delta.has_delta()) {
+    // The |history_| starts at the last packed point, so the delta would
+    // forget all the other packed points: they are the actual start of the
+    // history.
+    CHECK_LT(0, message->timeline_size()) << ShortDebugString();
+    *delta.mutable_delta()->mutable_first_time() =
+        message->timeline(0).instant();
+    DiscreteTrajectory<Barycentric>::ApplyDelta(delta, message);
+  } else {
+    // The base of the delta doesn't match the |history_| (its last point was
+    // replaced).  The full |history_| was written, so keep the packed points
+    // that precede it.
+    LOG(WARNING) << "Packed history of vessel " << ShortDebugString()
+                 << " doesn't match its base, writing it in full";
+    auto& timeline = *message->mutable_timeline();
+    if (delta.timeline_size() > 0) {
+      Instant const first_time =
+          Instant::ReadFromMessage(delta.timeline(0).instant());
+      int packed_size = 0;
+      while (packed_size < timeline.size() &&
+             Instant::ReadFromMessage(timeline[packed_size].instant()) <
+                 first_time) {
+        ++packed_size;
+      }
+      timeline.DeleteSubrange(packed_size, timeline.size() - packed_size);
+    }
+    timeline.MergeFrom(delta.timeline());
+    *message->mutable_children() = delta.children();
+    *message->mutable_fork_position() = delta.fork_position();
+  }
+  // The |history_| is not downsampled, so the delta doesn't carry the
+  // downsampling of the history.
+  message->clear_downsampling();
+  if (packed_history_->downsampling.has_value()) {
+    *message->mutable_downsampling() = *packed_history_->downsampling;
+  }
+}
+
 void Vessel::AppendToVesselTrajectory(
     TrajectoryIterator const part_trajectory_begin,
     TrajectoryIterator const part_trajectory_end,
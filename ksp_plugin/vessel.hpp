@@ -1,13 +1,18 @@
 ﻿
 #pragma once
 
+#include <future>
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "absl/synchronization/mutex.h"
+#include "base/status.hpp"
+#include "base/thread_pool.hpp"
 #include "ksp_plugin/celestial.hpp"
 #include "ksp_plugin/flight_plan.hpp"
 #include "ksp_plugin/part.hpp"
@@ -23,6 +28,8 @@ namespace ksp_plugin {
 namespace internal_vessel {
 
 using base::not_null;
+using base::Status;
+using base::ThreadPool;
 using geometry::Instant;
 using geometry::Vector;
 using physics::DegreesOfFreedom;
@@ -148,9 +155,37 @@ class Vessel {
   // able to do it next to a singularity.
   virtual void FlowPrediction(Instant const& last_time);
 
+  // Starts extending the prediction up to and including |last_time| on a
+  // thread of |thread_pool|, without blocking.  The computation starts from the
+  // end of the |psychohistory()|, and its result becomes the |prediction()| at
+  // the next call to |RequestPrediction| or |WaitForPrediction| after it has
+  // completed, unless the |psychohistory()| has changed in the meantime.  If a
+  // computation is already in flight, this request is queued and the thread
+  // computing the prediction picks it up when it is done; a later request
+  // replaces the queued one.  The ephemeris is only prolonged on the calling
+  // thread, and only if the last prediction reached its |t_max()|; the
+  // background computation stops at |t_max()|.
+  virtual void RequestPrediction(Instant const& last_time,
+                                 not_null<ThreadPool<Status>*> thread_pool);
+
+  // Blocks until the computation started by |RequestPrediction|, if any, has
+  // completed, and makes its result the |prediction()|.
+  virtual void WaitForPrediction();
+
+  // If the history is packed, the psychohistory starts at the last point of
+  // the history, and the points before it are missing: call |UnpackHistory|
+  // first to get all of them.
   virtual DiscreteTrajectory<Barycentric> const& psychohistory() const;
 
-  // The vessel must satisfy |is_initialized()|.
+  // Returns the last point of the psychohistory.
+  virtual DiscreteTrajectory<Barycentric>::Iterator psychohistory_last() const;
+
+  // If the history was packed by |ReadFromMessage|, deserializes it entirely.
+  // This invalidates the references and iterators into the |psychohistory()|
+  // and the |prediction()|, so it must be called before taking them.
+  virtual void UnpackHistory();
+
+  // The vessel must satisfy |is_initialized()|.  Does not unpack the history.
   virtual void WriteToMessage(not_null<serialization::Vessel*> message,
                               PileUp::SerializationIndexForPileUp const&
                                   serialization_index_for_pile_up) const;
@@ -159,6 +194,12 @@ class Vessel {
       not_null<Celestial const*> parent,
       not_null<Ephemeris<Barycentric>*> ephemeris,
       std::function<void(PartId)> const& deletion_callback);
+  // The history of the vessel read by the above function is packed: only its
+  // last point is deserialized as a trajectory, together with the
+  // psychohistory and the prediction.  The other points are kept in a flat
+  // array until the history is unpacked by |UnpackHistory|, by |ForgetBefore|
+  // if it forgets more than the packed points, or by |AdvanceTime| once the
+  // downsampling would apply.
   void FillContainingPileUpsFromMessage(
       serialization::Vessel const& message,
       PileUp::PileUpForSerializationIndex const&
@@ -179,6 +220,48 @@ class Vessel {
                                 TrajectoryIterator part_trajectory_end,
                                 DiscreteTrajectory<Barycentric>& trajectory);
 
+  // Extends |trajectory| up to and including |last_time| using the given
+  // parameters.  Doesn't touch the state of the vessel, so it may be called on
+  // a background thread.
+  static Status FlowUnaccelerated(
+      Instant const& last_time,
+      Ephemeris<Barycentric>::AdaptiveStepParameters const&
+          adaptive_step_parameters,
+      Ephemeris<Barycentric>& ephemeris,
+      DiscreteTrajectory<Barycentric>& trajectory);
+
+  // The parameters of a prediction computed on a background thread.
+  struct PredictionRequest {
+    Instant fork_time;
+    DegreesOfFreedom<Barycentric> fork_degrees_of_freedom;
+    Instant last_time;
+    Ephemeris<Barycentric>::AdaptiveStepParameters adaptive_step_parameters;
+  };
+
+  // Returns a request for a prediction forked at the end of the
+  // |psychohistory_| and extending up to |last_time|, prolonging the ephemeris
+  // if needed.  Must be called on the main thread.
+  PredictionRequest MakePredictionRequest(Instant const& last_time);
+
+  // Computes the prediction for |request| into the |prediction_trajectory_|,
+  // and then the predictions for the queued requests, if any, until there is
+  // none.  Runs on a background thread, so it only touches the ephemeris and
+  // the members used to communicate with the main thread.
+  Status FlowPredictions(PredictionRequest request)
+      EXCLUDES(prediction_lock_);
+
+  // Replaces the |prediction_| with the points of |trajectory| that are after
+  // the end of the |psychohistory_|, unless the |prediction_| already extends
+  // further.  Does nothing if |trajectory| is not forked at the end of the
+  // |psychohistory_|, i.e., if it was computed from a stale psychohistory.
+  void AttachPrediction(DiscreteTrajectory<Barycentric> const& trajectory);
+
+  // Writes a complete serialization of the history, made of the
+  // |packed_history_| and of the |history_|, to |message|.  The history must be
+  // packed.
+  void WritePackedHistoryToMessage(
+      not_null<serialization::DiscreteTrajectory*> message) const;
+
   GUID const guid_;
   std::string name_;
 
@@ -199,6 +282,38 @@ class Vessel {
   // The |prediction_| is forked off the end of the |psychohistory_|.
   DiscreteTrajectory<Barycentric>* prediction_ = nullptr;
 
+  struct PackedPoint {
+    Instant time;
+    DegreesOfFreedom<Barycentric> degrees_of_freedom;
+  };
+
+  // The |points| of a packed history up to and including the first point of
+  // the |history_|, which is designated by the |base|, in increasing time
+  // order.  The |downsampling|, if any, applies to the whole history, and the
+  // |history_| is not downsampled.
+  struct PackedHistory {
+    std::vector<PackedPoint> points;
+    std::optional<serialization::DiscreteTrajectory::Downsampling>
+        downsampling;
+    DiscreteTrajectory<Barycentric>::DeltaBase base;
+  };
+
+  // Engaged if the history is packed.
+  std::optional<PackedHistory> packed_history_;
+
+  // The predictions being computed on a background thread.  The
+  // |prediction_trajectory_| is only accessed by that thread until the
+  // |prediction_future_| is ready, and is null if no prediction was computed.
+  // The |prediction_future_| is not |valid()| if no computation was started.
+  std::unique_ptr<DiscreteTrajectory<Barycentric>> prediction_trajectory_;
+  std::future<Status> prediction_future_;
+  absl::Mutex prediction_lock_;
+  // True from the time a computation is started to the time the background
+  // thread stops looking at the |queued_prediction_request_|.
+  bool prediction_in_flight_ GUARDED_BY(prediction_lock_) = false;
+  std::optional<PredictionRequest> queued_prediction_request_
+      GUARDED_BY(prediction_lock_);
+
   std::unique_ptr<FlightPlan> flight_plan_;
 };
 
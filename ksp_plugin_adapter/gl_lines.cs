@@ -107,27 +107,30 @@ public enum Style {
       using (DisposableIterator rp2_line_iterator =
                 rp2_lines_iterator.IteratorGetRP2LinesIterator()) {
         XY? previous_rp2_point = null;
-        for (;
-             !rp2_line_iterator.IteratorAtEnd();
-             rp2_line_iterator.IteratorIncrement()) {
-          XY current_rp2_point = ToScreen(
-              rp2_line_iterator.IteratorGetRP2LineXY());
-          if (previous_rp2_point.HasValue) {
-            if (style == Style.FADED) {
-              colour.a = 1 - (float)(4 * index) / (float)(5 * size);
-              UnityEngine.GL.Color(colour);
-            }
-            if (style != Style.DASHED || index % 2 == 1) {
-              UnityEngine.GL.Vertex3((float)previous_rp2_point.Value.x,
-                                      (float)previous_rp2_point.Value.y,
-                                      0);
-              UnityEngine.GL.Vertex3((float)current_rp2_point.x,
-                                      (float)current_rp2_point.y,
-                                      0);
+        // The points are obtained in chunks to avoid crossing the interface
+        // for each of them.
+        for (int count;
+             (count = rp2_line_iterator.IteratorGetRP2LineXYs(
+                  rp2_points_, rp2_points_.Length)) > 0;) {
+          for (int i = 0; i < count; ++i) {
+            XY current_rp2_point = ToScreen(rp2_points_[i]);
+            if (previous_rp2_point.HasValue) {
+              if (style == Style.FADED) {
+                colour.a = 1 - (float)(4 * index) / (float)(5 * size);
+                UnityEngine.GL.Color(colour);
+              }
+              if (style != Style.DASHED || index % 2 == 1) {
+                UnityEngine.GL.Vertex3((float)previous_rp2_point.Value.x,
+                                        (float)previous_rp2_point.Value.y,
+                                        0);
+                UnityEngine.GL.Vertex3((float)current_rp2_point.x,
+                                        (float)current_rp2_point.y,
+                                        0);
+              }
             }
+            previous_rp2_point = current_rp2_point;
+            ++index;
           }
-          previous_rp2_point = current_rp2_point;
-          ++index;
         }
       }
     }
@@ -146,6 +149,8 @@ public enum Style {
                       0.5 * camera.pixelHeight};
    }
 
+  private static readonly XY[] rp2_points_ = new XY[1000];
+
   private static UnityEngine.Material line_material_;
   private static UnityEngine.Material line_material {
     get {
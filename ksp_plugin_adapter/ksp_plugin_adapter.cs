@@ -131,6 +131,10 @@ private enum UnityLayers {
   // Whether to compress saves.
   [KSPField(isPersistant = true)]
   private string serialization_compression_ = "";
+  // How to encode saves, either "hexadecimal" or "base32768".  Saves that
+  // predate the latter encoding are hexadecimal.
+  [KSPField(isPersistant = true)]
+  private string serialization_encoding_ = "hexadecimal";
 
   // Whether the plotting frame must be set to something convenient at the next
   // opportunity.
@@ -362,14 +366,14 @@ private enum UnityLayers {
                     prediction_length_tolerance_index_]};
       plugin_.VesselSetPredictionAdaptiveStepParameters(
           main_vessel.id.ToString(), adaptive_step_parameters);
-      plugin_.UpdatePrediction(main_vessel.id.ToString());
+      plugin_.RequestPrediction(main_vessel.id.ToString());
       string target_id =
           FlightGlobals.fetch.VesselTarget?.GetVessel()?.id.ToString();
       if (!plotting_frame_selector_.get().target_override &&
           target_id != null && plugin_.HasVessel(target_id)) {
         plugin_.VesselSetPredictionAdaptiveStepParameters(
             target_id, adaptive_step_parameters);
-        plugin_.UpdatePrediction(target_id);
+        plugin_.RequestPrediction(target_id);
       }
     }
   }
@@ -589,9 +593,15 @@ private enum UnityLayers {
       String serialization;
       IntPtr serializer = IntPtr.Zero;
       for (;;) {
-        serialization = plugin_.SerializePluginHexadecimal(
-                            ref serializer,
-                            serialization_compression_);
+        if (serialization_encoding_ == "base32768") {
+          serialization = plugin_.SerializePluginBase32768(
+                              ref serializer,
+                              serialization_compression_);
+        } else {
+          serialization = plugin_.SerializePluginHexadecimal(
+                              ref serializer,
+                              serialization_compression_);
+        }
         if (serialization == null) {
           break;
         }
@@ -617,21 +627,35 @@ private enum UnityLayers {
       IntPtr deserializer = IntPtr.Zero;
       String[] serializations = node.GetValues(principia_serialized_plugin_);
       Log.Info("Serialization has " + serializations.Length + " chunks");
-      foreach (String serialization in serializations) {
-        Interface.DeserializePluginHexadecimal(serialization,
-                                               serialization.Length,
+      if (serialization_encoding_ == "base32768") {
+        foreach (String serialization in serializations) {
+          Interface.DeserializePluginBase32768(serialization,
                                                ref deserializer,
                                                ref plugin_,
                                                serialization_compression_);
-      }
-      Interface.DeserializePluginHexadecimal("",
-                                             0,
+        }
+        Interface.DeserializePluginBase32768("",
                                              ref deserializer,
                                              ref plugin_,
                                              serialization_compression_);
+      } else {
+        foreach (String serialization in serializations) {
+          Interface.DeserializePluginHexadecimal(serialization,
+                                                 serialization.Length,
+                                                 ref deserializer,
+                                                 ref plugin_,
+                                                 serialization_compression_);
+        }
+        Interface.DeserializePluginHexadecimal("",
+                                               0,
+                                               ref deserializer,
+                                               ref plugin_,
+                                               serialization_compression_);
+      }
       if (serialization_compression_ == "") {
         serialization_compression_ = "gipfeli";
       }
+      serialization_encoding_ = "base32768";
 
       plotting_frame_selector_.reset(
           new ReferenceFrameSelector(this, 
@@ -1747,99 +1771,104 @@ private enum UnityLayers {
       using (DisposablePlanetarium planetarium =
                 GLLines.NewPlanetarium(plugin_, sun_world_position)) {
         GLLines.Draw(() => {
-          using (DisposableIterator rp2_lines_iterator =
-                    planetarium.PlanetariumPlotPsychohistory(
+          // Plot the psychohistory, the prediction and the flight plan of the
+          // main vessel in one call, so that the plugin may do it in parallel.
+          using (DisposableIterator rp2_lines_vector_iterator =
+                    planetarium.PlanetariumPlotVesselTrajectories(
                         plugin_,
                         чебышёв_plotting_method_,
                         main_vessel_guid)) {
-            GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                 XKCDColors.Lime,
-                                 GLLines.Style.FADED);
-          }
-          RenderPredictionMarkers(main_vessel_guid, sun_world_position);
-          using (DisposableIterator rp2_lines_iterator =
-                    planetarium.PlanetariumPlotPrediction(
-                        plugin_,
-                        чебышёв_plotting_method_,
-                        main_vessel_guid)) {
-            GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                 XKCDColors.Fuchsia,
-                                 GLLines.Style.SOLID);
-          }
-          string target_id =
-              FlightGlobals.fetch.VesselTarget?.GetVessel()?.id.ToString();
-          if (FlightGlobals.ActiveVessel != null &&
-              !plotting_frame_selector_.get().target_override &&
-              target_id != null && plugin_.HasVessel(target_id)) {
             using (DisposableIterator rp2_lines_iterator =
-                      planetarium.PlanetariumPlotPsychohistory(
-                          plugin_,
-                          чебышёв_plotting_method_,
-                          target_id)) {
+                      rp2_lines_vector_iterator.
+                          IteratorGetRP2LinesVectorIterator()) {
               GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                   XKCDColors.Goldenrod,
+                                   XKCDColors.Lime,
                                    GLLines.Style.FADED);
             }
-            RenderPredictionMarkers(target_id, sun_world_position);
+            rp2_lines_vector_iterator.IteratorIncrement();
+            RenderPredictionMarkers(main_vessel_guid, sun_world_position);
             using (DisposableIterator rp2_lines_iterator =
-                      planetarium.PlanetariumPlotPrediction(
-                          plugin_,
-                          чебышёв_plotting_method_,
-                          target_id)) {
+                      rp2_lines_vector_iterator.
+                          IteratorGetRP2LinesVectorIterator()) {
               GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                   XKCDColors.LightMauve,
+                                   XKCDColors.Fuchsia,
                                    GLLines.Style.SOLID);
             }
-          }
-          if (plugin_.FlightPlanExists(main_vessel_guid)) {
-            RenderFlightPlanMarkers(main_vessel_guid, sun_world_position);
-
-            int number_of_segments =
-                plugin_.FlightPlanNumberOfSegments(main_vessel_guid);
-            for (int i = 0; i < number_of_segments; ++i) {
-              bool is_burn = i % 2 == 1;
-              using (DisposableIterator rendered_segments =
-                        plugin_.FlightPlanRenderedSegment(main_vessel_guid,
-                                                          sun_world_position,
-                                                          i)) {
-                if (rendered_segments.IteratorAtEnd()) {
-                  Log.Info("Skipping segment " + i);
-                  continue;
-                }
-                Vector3d position_at_start =
-                    (Vector3d)rendered_segments.
-                        IteratorGetDiscreteTrajectoryXYZ();
+            rp2_lines_vector_iterator.IteratorIncrement();
+            string target_id =
+                FlightGlobals.fetch.VesselTarget?.GetVessel()?.id.ToString();
+            if (FlightGlobals.ActiveVessel != null &&
+                !plotting_frame_selector_.get().target_override &&
+                target_id != null && plugin_.HasVessel(target_id)) {
+              using (DisposableIterator rp2_lines_iterator =
+                        planetarium.PlanetariumPlotPsychohistory(
+                            plugin_,
+                            чебышёв_plotting_method_,
+                            target_id)) {
+                GLLines.PlotRP2Lines(rp2_lines_iterator,
+                                     XKCDColors.Goldenrod,
+                                     GLLines.Style.FADED);
+              }
+              RenderPredictionMarkers(target_id, sun_world_position);
+              using (DisposableIterator rp2_lines_iterator =
+                        planetarium.PlanetariumPlotPrediction(
+                            plugin_,
+                            чебышёв_plotting_method_,
+                            target_id)) {
+                GLLines.PlotRP2Lines(rp2_lines_iterator,
+                                     XKCDColors.LightMauve,
+                                     GLLines.Style.SOLID);
+              }
+            }
+            if (plugin_.FlightPlanExists(main_vessel_guid)) {
+              RenderFlightPlanMarkers(main_vessel_guid, sun_world_position);
+
+              int number_of_segments =
+                  plugin_.FlightPlanNumberOfSegments(main_vessel_guid);
+              // The iterator is incremented even when a segment is skipped.
+              for (int i = 0;
+                   i < number_of_segments;
+                   ++i, rp2_lines_vector_iterator.IteratorIncrement()) {
+                bool is_burn = i % 2 == 1;
                 using (DisposableIterator rp2_lines_iterator =
-                          planetarium.PlanetariumPlotFlightPlanSegment(
-                              plugin_,
-                              чебышёв_plotting_method_,
-                              main_vessel_guid,
-                              i)) {
+                          rp2_lines_vector_iterator.
+                              IteratorGetRP2LinesVectorIterator())
+                using (DisposableIterator rendered_segments =
+                          plugin_.FlightPlanRenderedSegment(main_vessel_guid,
+                                                            sun_world_position,
+                                                            i)) {
+                  if (rendered_segments.IteratorAtEnd()) {
+                    Log.Info("Skipping segment " + i);
+                    continue;
+                  }
+                  Vector3d position_at_start =
+                      (Vector3d)rendered_segments.
+                          IteratorGetDiscreteTrajectoryXYZ();
                   GLLines.PlotRP2Lines(
                       rp2_lines_iterator,
                       is_burn ? XKCDColors.Pink : XKCDColors.PeriwinkleBlue,
                       is_burn ? GLLines.Style.SOLID : GLLines.Style.DASHED);
-                }
-                if (is_burn) {
-                  int manoeuvre_index = i / 2;
-                  NavigationManoeuvreFrenetTrihedron manoeuvre =
-                      plugin_.FlightPlanGetManoeuvreFrenetTrihedron(
-                          main_vessel_guid,
-                          manoeuvre_index);
-                  double scale = (ScaledSpace.ScaledToLocalSpace(
-                                      MapView.MapCamera.transform.position) -
-                                  position_at_start).magnitude * 0.015;
-                  Action<XYZ, UnityEngine.Color> add_vector =
-                      (world_direction, colour) => {
-                        UnityEngine.GL.Color(colour);
-                        GLLines.AddSegment(
-                            position_at_start,
-                            position_at_start +
-                                scale * (Vector3d)world_direction);
-                      };
-                  add_vector(manoeuvre.tangent, XKCDColors.NeonYellow);
-                  add_vector(manoeuvre.normal, XKCDColors.AquaBlue);
-                  add_vector(manoeuvre.binormal, XKCDColors.PurplePink);
+                  if (is_burn) {
+                    int manoeuvre_index = i / 2;
+                    NavigationManoeuvreFrenetTrihedron manoeuvre =
+                        plugin_.FlightPlanGetManoeuvreFrenetTrihedron(
+                            main_vessel_guid,
+                            manoeuvre_index);
+                    double scale = (ScaledSpace.ScaledToLocalSpace(
+                                        MapView.MapCamera.transform.position) -
+                                    position_at_start).magnitude * 0.015;
+                    Action<XYZ, UnityEngine.Color> add_vector =
+                        (world_direction, colour) => {
+                          UnityEngine.GL.Color(colour);
+                          GLLines.AddSegment(
+                              position_at_start,
+                              position_at_start +
+                                  scale * (Vector3d)world_direction);
+                        };
+                    add_vector(manoeuvre.tangent, XKCDColors.NeonYellow);
+                    add_vector(manoeuvre.normal, XKCDColors.AquaBlue);
+                    add_vector(manoeuvre.binormal, XKCDColors.PurplePink);
+                  }
                 }
               }
             }
@@ -1,38 +1,71 @@
 
 #include "ksp_plugin/plugin.hpp"
 
+#include <array>
+#include <chrono>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include "astronomy/frames.hpp"
 #include "base/push_deserializer.hpp"
 #include "base/serialization.hpp"
 #include "benchmark/benchmark.h"
 #include "geometry/named_quantities.hpp"
 #include "gtest/gtest.h"
 #include "ksp_plugin/interface.hpp"
+#include "ksp_plugin_test/fake_plugin.hpp"
+#include "physics/kepler_orbit.hpp"
+#include "physics/solar_system.hpp"
 #include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
 #include "serialization/ksp_plugin.pb.h"
 #include "testing_utilities/serialization.hpp"
+#include "testing_utilities/solar_system_factory.hpp"
 
 namespace principia {
 
+using astronomy::ICRS;
 using base::ParseFromBytes;
 using base::PullSerializer;
 using base::PushDeserializer;
+using geometry::Bivector;
+using geometry::Displacement;
 using geometry::Instant;
+using geometry::Perspective;
+using geometry::RigidTransformation;
+using geometry::Rotation;
+using geometry::Vector;
+using geometry::Velocity;
 using interface::principia__AdvanceTime;
 using interface::principia__DeletePlugin;
 using interface::principia__DeserializePluginHexadecimal;
 using interface::principia__FutureCatchUpVessel;
 using interface::principia__FutureWaitForVesselToCatchUp;
 using interface::principia__IteratorDelete;
+using interface::principia__SerializePluginBase32768;
 using interface::principia__SerializePluginHexadecimal;
+using physics::DegreesOfFreedom;
+using physics::DiscreteTrajectory;
+using physics::KeplerianElements;
+using physics::SolarSystem;
+using quantities::Force;
 using quantities::Frequency;
 using quantities::Time;
+using quantities::si::ArcMinute;
+using quantities::si::Day;
+using quantities::si::Degree;
 using quantities::si::Hertz;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Newton;
+using quantities::si::Radian;
 using quantities::si::Second;
+using quantities::si::Tonne;
 using testing_utilities::ReadFromBinaryFile;
 using testing_utilities::ReadLinesFromHexadecimalFile;
+using testing_utilities::SolarSystemFactory;
 
 namespace ksp_plugin {
 
@@ -93,6 +126,278 @@ void BM_PluginIntegrationBenchmark(benchmark::State& state) {
   }
 }
 
+// A synthetic game in which the numbers of vessels, of pile-ups and of flight
+// plans are parameters.  Each call to |Tick| makes the calls that the adapter
+// makes to the plugin during a frame of the game, and measures the time spent
+// in each phase.
+class SyntheticGame {
+ public:
+  // Each of the |unloaded_vessels| has a single part and its own orbit around
+  // the Earth.  The |loaded_vessels| are in a physics bubble in low Earth
+  // orbit; each of them is made of |parts_per_loaded_vessel| parts which form a
+  // pile-up subject to an intrinsic force.  The first |flight_plans| vessels,
+  // loaded ones first, have a flight plan.  The active vessel is the first
+  // loaded vessel if any, otherwise the first unloaded vessel.
+  SyntheticGame(int unloaded_vessels,
+                int loaded_vessels,
+                int parts_per_loaded_vessel,
+                int flight_plans);
+
+  void Tick();
+
+  // The average duration of each phase of |Tick|, excluding the tick that
+  // inserts the vessels.
+  std::string PhaseTimings() const;
+
+ private:
+  enum Phase {
+    INSERT_OR_KEEP_VESSELS,
+    FREE_VESSELS_AND_PARTS_AND_COLLECT_PILE_UPS,
+    ADVANCE_TIME,
+    CATCH_UP_LAGGING_VESSELS,
+    UPDATE_PREDICTION,
+    PLOT,
+    NUMBER_OF_PHASES,
+  };
+  static constexpr std::array<char const*, NUMBER_OF_PHASES> phase_names_ = {
+      "InsertOrKeepVessel",
+      "FreeVesselsAndPartsAndCollectPileUps",
+      "AdvanceTime",
+      "CatchUpLaggingVessels",
+      "UpdatePrediction",
+      "Plot"};
+
+  // A frame of the game when not warping.
+  static constexpr Time Δt = 20 * Milli(Second);
+
+  template<typename Action>
+  void Measure(Phase phase, Action const& action);
+
+  // The degrees of freedom of a part of a loaded vessel in |World|, with the
+  // Earth at the origin.
+  static DegreesOfFreedom<World> LoadedPartDegreesOfFreedom(PartId part_id);
+
+  FakePlugin plugin_;
+  std::vector<GUID> loaded_vessel_guids_;
+  std::vector<std::vector<PartId>> loaded_vessel_part_ids_;
+  std::vector<GUID> unloaded_vessel_guids_;
+  GUID active_vessel_guid_;
+
+  int ticks_ = 0;
+  std::array<std::chrono::duration<double, std::milli>, NUMBER_OF_PHASES>
+      durations_{};
+};
+
+SyntheticGame::SyntheticGame(int const unloaded_vessels,
+                             int const loaded_vessels,
+                             int const parts_per_loaded_vessel,
+                             int const flight_plans)
+    : plugin_(SolarSystem<ICRS>(
+          SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+          SOLUTION_DIR / "astronomy" /
+              "sol_initial_state_jd_2451545_000000000.proto.txt")) {
+  CHECK_LT(0, unloaded_vessels + loaded_vessels);
+  CHECK_LE(flight_plans, unloaded_vessels + loaded_vessels);
+  plugin_.renderer().SetPlottingFrame(
+      plugin_.NewBodyCentredNonRotatingNavigationFrame(
+          SolarSystemFactory::Earth));
+
+  PartId part_id = 0;
+  for (int i = 0; i < loaded_vessels; ++i) {
+    loaded_vessel_guids_.push_back("loaded " + std::to_string(i));
+    loaded_vessel_part_ids_.emplace_back();
+    for (int j = 0; j < parts_per_loaded_vessel; ++j) {
+      loaded_vessel_part_ids_.back().push_back(part_id++);
+    }
+  }
+
+  // The unloaded vessels are spread between low Earth orbit and the
+  // geostationary orbit.
+  for (int i = 0; i < unloaded_vessels; ++i) {
+    GUID const guid = "unloaded " + std::to_string(i);
+    unloaded_vessel_guids_.push_back(guid);
+    KeplerianElements<Barycentric> elements;
+    elements.eccentricity = 0.01;
+    elements.semimajor_axis =
+        (6800 + 35'000.0 * i / unloaded_vessels) * Kilo(Metre);
+    elements.inclination = (i % 90) * Degree;
+    elements.longitude_of_ascending_node = (i % 360) * Degree;
+    elements.argument_of_periapsis = 0 * Radian;
+    elements.mean_anomaly = (i % 360) * Degree;
+    plugin_.AddVesselInEarthOrbit(guid, guid, part_id++, guid, elements);
+  }
+  active_vessel_guid_ = loaded_vessels > 0 ? loaded_vessel_guids_.front()
+                                           : unloaded_vessel_guids_.front();
+
+  // The first tick inserts the loaded parts and creates the pile-ups; it is
+  // not representative.
+  Tick();
+  ticks_ = 0;
+  durations_ = {};
+
+  for (int i = 0; i < flight_plans; ++i) {
+    GUID const& guid =
+        i < loaded_vessels ? loaded_vessel_guids_[i]
+                           : unloaded_vessel_guids_[i - loaded_vessels];
+    plugin_.CreateFlightPlan(guid, plugin_.CurrentTime() + 1 * Day, 1 * Tonne);
+  }
+}
+
+void SyntheticGame::Tick() {
+  Measure(INSERT_OR_KEEP_VESSELS, [this]() {
+    bool inserted;
+    for (int i = 0; i < loaded_vessel_guids_.size(); ++i) {
+      GUID const& guid = loaded_vessel_guids_[i];
+      plugin_.InsertOrKeepVessel(guid,
+                                 guid,
+                                 SolarSystemFactory::Earth,
+                                 /*loaded=*/true,
+                                 inserted);
+      for (PartId const part_id : loaded_vessel_part_ids_[i]) {
+        plugin_.InsertOrKeepLoadedPart(
+            part_id,
+            std::to_string(part_id),
+            1 * Tonne,
+            guid,
+            SolarSystemFactory::Earth,
+            DegreesOfFreedom<World>(World::origin, Velocity<World>()),
+            LoadedPartDegreesOfFreedom(part_id),
+            Δt);
+        plugin_.IncrementPartIntrinsicForce(
+            part_id,
+            Vector<Force, World>({1 * Newton, 0 * Newton, 0 * Newton}));
+      }
+    }
+    for (GUID const& guid : unloaded_vessel_guids_) {
+      plugin_.InsertOrKeepVessel(guid,
+                                 guid,
+                                 SolarSystemFactory::Earth,
+                                 /*loaded=*/false,
+                                 inserted);
+    }
+  });
+
+  Measure(FREE_VESSELS_AND_PARTS_AND_COLLECT_PILE_UPS, [this]() {
+    plugin_.PrepareToReportCollisions();
+    for (auto const& part_ids : loaded_vessel_part_ids_) {
+      for (int j = 1; j < part_ids.size(); ++j) {
+        plugin_.ReportPartCollision(part_ids[j - 1], part_ids[j]);
+      }
+    }
+    plugin_.FreeVesselsAndPartsAndCollectPileUps(Δt);
+    for (auto const& part_ids : loaded_vessel_part_ids_) {
+      for (PartId const part_id : part_ids) {
+        plugin_.SetPartApparentDegreesOfFreedom(
+            part_id,
+            LoadedPartDegreesOfFreedom(part_id),
+            DegreesOfFreedom<World>(World::origin, Velocity<World>()));
+      }
+    }
+  });
+
+  Measure(ADVANCE_TIME, [this]() {
+    plugin_.AdvanceTime(plugin_.CurrentTime() + Δt,
+                        /*planetarium_rotation=*/0 * Radian);
+  });
+
+  Measure(CATCH_UP_LAGGING_VESSELS, [this]() {
+    VesselSet collided_vessels;
+    plugin_.CatchUpLaggingVessels(collided_vessels);
+  });
+
+  Measure(UPDATE_PREDICTION, [this]() {
+    plugin_.UpdatePrediction(active_vessel_guid_);
+  });
+
+  // The trajectories of the active vessel, as in
+  // |principia__PlanetariumPlotVesselTrajectories|.
+  Measure(PLOT, [this]() {
+    Planetarium::Parameters const parameters(
+        /*sphere_radius_multiplier=*/1,
+        /*angular_resolution=*/0.4 * ArcMinute,
+        /*field_of_view=*/90 * Degree);
+    Perspective<Navigation, Camera> const perspective(
+        RigidTransformation<Navigation, Camera>(
+            Navigation::origin +
+                Displacement<Navigation>(
+                    {0 * Metre, 0 * Metre, 40'000 * Kilo(Metre)}),
+            Camera::origin,
+            Rotation<Navigation, Camera>(
+                Vector<double, Navigation>({1, 0, 0}),
+                Vector<double, Navigation>({0, -1, 0}),
+                Bivector<double, Navigation>({0, 0, -1})).Forget()),
+        /*focal=*/1 * Metre);
+    auto const planetarium = plugin_.NewPlanetarium(parameters, perspective);
+
+    Vessel const& vessel = *plugin_.GetVessel(active_vessel_guid_);
+    std::vector<Planetarium::TrajectoryRange> ranges;
+    auto const& psychohistory = vessel.psychohistory();
+    ranges.push_back({psychohistory.Begin(),
+                      psychohistory.End(),
+                      /*reverse=*/true});
+    auto const& prediction = vessel.prediction();
+    ranges.push_back({prediction.Fork(), prediction.End(), /*reverse=*/false});
+    if (vessel.has_flight_plan()) {
+      auto const& flight_plan = vessel.flight_plan();
+      for (int index = 0; index < flight_plan.number_of_segments(); ++index) {
+        DiscreteTrajectory<Barycentric>::Iterator segment_begin;
+        DiscreteTrajectory<Barycentric>::Iterator segment_end;
+        flight_plan.GetSegment(index, segment_begin, segment_end);
+        ranges.push_back({segment_begin, segment_end, /*reverse=*/false});
+      }
+    }
+    auto const rp2_lines =
+        planetarium->PlotMethod2(ranges, plugin_.CurrentTime());
+    benchmark::DoNotOptimize(rp2_lines);
+  });
+
+  ++ticks_;
+}
+
+std::string SyntheticGame::PhaseTimings() const {
+  std::stringstream ss;
+  for (int phase = 0; phase < NUMBER_OF_PHASES; ++phase) {
+    if (phase > 0) {
+      ss << ", ";
+    }
+    ss << phase_names_[phase] << " " << durations_[phase].count() / ticks_
+       << " ms";
+  }
+  return ss.str();
+}
+
+template<typename Action>
+void SyntheticGame::Measure(Phase const phase, Action const& action) {
+  auto const start = std::chrono::steady_clock::now();
+  action();
+  durations_[phase] += std::chrono::steady_clock::now() - start;
+}
+
+DegreesOfFreedom<World> SyntheticGame::LoadedPartDegreesOfFreedom(
+    PartId const part_id) {
+  return DegreesOfFreedom<World>(
+      World::origin + Displacement<World>({6783 * Kilo(Metre),
+                                           part_id * Metre,
+                                           0 * Metre}),
+      Velocity<World>({0 * Metre / Second,
+                       0 * Metre / Second,
+                       7.7 * Kilo(Metre) / Second}));
+}
+
+// The arguments are the numbers of unloaded vessels, of loaded vessels, of
+// parts per loaded vessel, and of flight plans.  The label gives the average
+// duration of each phase of a tick.
+void BM_PluginTick(benchmark::State& state) {
+  SyntheticGame game(/*unloaded_vessels=*/state.range(0),
+                     /*loaded_vessels=*/state.range(1),
+                     /*parts_per_loaded_vessel=*/state.range(2),
+                     /*flight_plans=*/state.range(3));
+  for (auto _ : state) {
+    game.Tick();
+  }
+  state.SetLabel(game.PhaseTimings());
+}
+
 void BM_PluginSerializationBenchmark(benchmark::State& state) {
   char const compressor[] = "gipfeli";
 
@@ -124,6 +429,39 @@ void BM_PluginSerializationBenchmark(benchmark::State& state) {
   state.SetBytesProcessed(bytes_processed);
 }
 
+void BM_PluginSerializationBase32768Benchmark(benchmark::State& state) {
+  char const compressor[] = "gipfeli";
+
+  // First, construct a plugin by reading a file.
+  auto const gipfeli_plugin(
+      ReadLinesFromHexadecimalFile(
+          SOLUTION_DIR / "ksp_plugin_test" / "large_plugin.proto.gipfeli.hex"));
+  int bytes_processed = 0;
+  auto const plugin = DeserializePluginFromLines(gipfeli_plugin,
+                                                 compressor,
+                                                 bytes_processed);
+
+  bytes_processed = 0;
+  for (auto _ : state) {
+    PullSerializer* serializer = nullptr;
+    char16_t const* serialization = nullptr;
+    for (;;) {
+      serialization = principia__SerializePluginBase32768(plugin.get(),
+                                                          &serializer,
+                                                          compressor);
+      if (serialization == nullptr) {
+        break;
+      }
+      // Each code point encodes 15 bits.
+      bytes_processed +=
+          std::char_traits<char16_t>::length(serialization) * 15 / 8;
+      delete[] serialization;
+    }
+  }
+
+  state.SetBytesProcessed(bytes_processed);
+}
+
 void BM_PluginDeserializationBenchmark(benchmark::State& state) {
   char const compressor[] = "gipfeli";
   auto const gipfeli_plugin(
@@ -142,8 +480,19 @@ void BM_PluginDeserializationBenchmark(benchmark::State& state) {
 }
 
 BENCHMARK(BM_PluginSerializationBenchmark);
+BENCHMARK(BM_PluginSerializationBase32768Benchmark);
 BENCHMARK(BM_PluginDeserializationBenchmark);
 BENCHMARK(BM_PluginIntegrationBenchmark);
+BENCHMARK(BM_PluginTick)
+    ->Args({10, 0, 0, 0})
+    ->Args({100, 0, 0, 0})
+    ->Args({1000, 0, 0, 0})
+    ->Args({10, 1, 10, 1})
+    ->Args({100, 1, 10, 1})
+    ->Args({1000, 1, 10, 1})
+    ->Args({100, 10, 10, 10})
+    ->Args({1000, 10, 10, 100})
+    ->Unit(benchmark::kMillisecond);
 
 // .\Release\x64\ksp_plugin_test_tests.exe --gtest_filter=PluginBenchmark.DISABLED_All --gtest_also_run_disabled_tests  // NOLINT
 TEST(PluginBenchmark, DISABLED_All) {
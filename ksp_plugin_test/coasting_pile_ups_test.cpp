@@ -0,0 +1,232 @@
+#include "ksp_plugin/coasting_pile_ups.hpp"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "astronomy/epoch.hpp"
+#include "base/status.hpp"
+#include "base/thread_pool.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/mock_integrators.hpp"
+#include "ksp_plugin/integrators.hpp"
+#include "ksp_plugin/part.hpp"
+#include "ksp_plugin/pile_up.hpp"
+#include "physics/mock_ephemeris.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace ksp_plugin {
+namespace internal_coasting_pile_ups {
+
+using base::Error;
+using base::make_not_null_unique;
+using base::Status;
+using base::ThreadPool;
+using geometry::Displacement;
+using geometry::Velocity;
+using integrators::MockFixedStepSizeIntegrator;
+using physics::DegreesOfFreedom;
+using physics::DiscreteTrajectory;
+using physics::MockEphemeris;
+using quantities::si::Kilogram;
+using quantities::si::Metre;
+using quantities::si::Second;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::DoDefault;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::SizeIs;
+
+class CoastingPileUpsTest : public testing::Test {
+ protected:
+  using Instance = Integrator<
+      Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance;
+  using MockInstance = MockFixedStepSizeIntegrator<
+      Ephemeris<Barycentric>::NewtonianMotionEquation>::MockInstance;
+
+  CoastingPileUpsTest()
+      : p1_(part_id1_, "p1", 1 * Kilogram, dof_, /*deletion_callback=*/nullptr),
+        p2_(part_id2_, "p2", 2 * Kilogram, dof_, /*deletion_callback=*/nullptr),
+        pile_up1_({&p1_},
+                  astronomy::J2000,
+                  DefaultPsychohistoryParameters(),
+                  DefaultHistoryParameters(),
+                  &ephemeris_,
+                  /*deletion_callback=*/nullptr),
+        pile_up2_({&p2_},
+                  astronomy::J2000,
+                  DefaultPsychohistoryParameters(),
+                  DefaultHistoryParameters(),
+                  &ephemeris_,
+                  /*deletion_callback=*/nullptr),
+        thread_pool_(/*pool_size=*/2),
+        acceleration_thread_pool_(/*pool_size=*/2),
+        coasting_pile_ups_(&acceleration_thread_pool_) {
+    // The instances remember the histories that they integrate.  The
+    // fixed-step integration stops short of the final time, and the
+    // psychohistories are completed with an adaptive step.
+    ON_CALL(ephemeris_, NewInstance(_, _, _))
+        .WillByDefault(Invoke(
+            [this](Histories const& histories,
+                   Ephemeris<Barycentric>::IntrinsicAccelerations const&,
+                   Ephemeris<Barycentric>::FixedStepParameters const&) {
+              return NewMockInstance(histories);
+            }));
+    ON_CALL(ephemeris_, NewInstance(_, _, _, _))
+        .WillByDefault(Invoke(
+            [this](Histories const& histories,
+                   Ephemeris<Barycentric>::IntrinsicAccelerations const&,
+                   Ephemeris<Barycentric>::FixedStepParameters const&,
+                   not_null<ThreadPool<void>*> const thread_pool) {
+              EXPECT_EQ(&acceleration_thread_pool_, thread_pool);
+              return NewMockInstance(histories);
+            }));
+    ON_CALL(ephemeris_, FlowWithFixedStep(_, _))
+        .WillByDefault(Invoke([this](Instant const& t, Instance& instance) {
+          absl::MutexLock l(&lock_);
+          for (auto const history : histories_[&instance]) {
+            history->Append(t - 0.5 * Second, dof_);
+          }
+          return Status::OK;
+        }));
+    ON_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _))
+        .WillByDefault(
+            DoAll(AppendToDiscreteTrajectory(dof_), Return(Status::OK)));
+  }
+
+  using Histories = std::vector<not_null<DiscreteTrajectory<Barycentric>*>>;
+
+  not_null<std::unique_ptr<Instance>> NewMockInstance(
+      Histories const& histories) {
+    not_null<std::unique_ptr<Instance>> instance =
+        make_not_null_unique<MockInstance>();
+    absl::MutexLock l(&lock_);
+    histories_[instance.get()] = histories;
+    return instance;
+  }
+
+  void AdvanceTime(std::vector<not_null<PileUp*>> const& pile_ups,
+                   Instant const& t) {
+    for (auto& future :
+         coasting_pile_ups_.AdvanceTime(pile_ups, t, thread_pool_)) {
+      EXPECT_TRUE(future.future.get().ok());
+    }
+  }
+
+  PartId const part_id1_ = 111;
+  PartId const part_id2_ = 222;
+  DegreesOfFreedom<Barycentric> const dof_ = DegreesOfFreedom<Barycentric>(
+      Barycentric::origin +
+          Displacement<Barycentric>({1 * Metre, 2 * Metre, 3 * Metre}),
+      Velocity<Barycentric>(
+          {10 * Metre / Second, 20 * Metre / Second, 30 * Metre / Second}));
+
+  MockEphemeris<Barycentric> ephemeris_;
+  Part p1_;
+  Part p2_;
+  PileUp pile_up1_;
+  PileUp pile_up2_;
+  ThreadPool<Status> thread_pool_;
+  ThreadPool<void> acceleration_thread_pool_;
+  CoastingPileUps coasting_pile_ups_;
+  absl::Mutex lock_;
+  std::map<Instance const*, Histories> histories_ GUARDED_BY(lock_);
+};
+
+// The histories of coasting pile-ups that end at the same time are integrated by
+// a single instance, which is only rebuilt when the set of pile-ups changes.
+TEST_F(CoastingPileUpsTest, SharedInstance) {
+  EXPECT_CALL(ephemeris_, NewInstance(SizeIs(2), _, _, _));
+  EXPECT_CALL(ephemeris_, FlowWithFixedStep(_, _)).Times(2);
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _)).Times(4);
+  AdvanceTime({&pile_up1_, &pile_up2_}, astronomy::J2000 + 1 * Second);
+  AdvanceTime({&pile_up1_, &pile_up2_}, astronomy::J2000 + 2 * Second);
+
+  // Both parts have been advanced, with the authoritative points computed by
+  // the shared instance in their histories.
+  for (Part* const part : {&p1_, &p2_}) {
+    EXPECT_EQ(astronomy::J2000 + 1.5 * Second,
+              (--part->history_end()).time());
+    EXPECT_EQ(astronomy::J2000 + 2 * Second,
+              (--part->psychohistory_end()).time());
+  }
+
+  // A pile-up leaves the batch, the other one is integrated by itself.
+  EXPECT_CALL(ephemeris_, NewInstance(_, _, _, _)).Times(0);
+  EXPECT_CALL(ephemeris_, NewInstance(SizeIs(1), _, _));
+  EXPECT_CALL(ephemeris_, FlowWithFixedStep(_, _));
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _));
+  AdvanceTime({&pile_up2_}, astronomy::J2000 + 3 * Second);
+  EXPECT_EQ(astronomy::J2000 + 2.5 * Second, (--p2_.history_end()).time());
+  EXPECT_EQ(astronomy::J2000 + 1.5 * Second, (--p1_.history_end()).time());
+}
+
+// Pile-ups whose histories don't end at the same time are integrated by
+// themselves, without any adaptive step in their histories, and form a batch
+// once their histories end at the same time.
+TEST_F(CoastingPileUpsTest, DifferentTimes) {
+  EXPECT_CALL(ephemeris_, NewInstance(SizeIs(1), _, _));
+  EXPECT_CALL(ephemeris_, FlowWithFixedStep(_, _));
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _));
+  AdvanceTime({&pile_up1_}, astronomy::J2000 + 1 * Second);
+
+  // The history of |pile_up2_| is behind that of |pile_up1_|.  The instance of
+  // |pile_up1_| is reused, and the adaptive steps are only for the
+  // psychohistories.
+  EXPECT_CALL(ephemeris_, NewInstance(_, _, _, _)).Times(0);
+  EXPECT_CALL(ephemeris_, NewInstance(SizeIs(1), _, _));
+  EXPECT_CALL(ephemeris_, FlowWithFixedStep(_, _)).Times(2);
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _)).Times(2);
+  AdvanceTime({&pile_up1_, &pile_up2_}, astronomy::J2000 + 2 * Second);
+  for (Part* const part : {&p1_, &p2_}) {
+    EXPECT_EQ(astronomy::J2000 + 1.5 * Second,
+              (--part->history_end()).time());
+  }
+
+  // The histories now end at the same time.
+  EXPECT_CALL(ephemeris_, NewInstance(SizeIs(2), _, _, _));
+  EXPECT_CALL(ephemeris_, NewInstance(_, _, _)).Times(0);
+  EXPECT_CALL(ephemeris_, FlowWithFixedStep(_, _));
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _)).Times(2);
+  AdvanceTime({&pile_up1_, &pile_up2_}, astronomy::J2000 + 3 * Second);
+  for (Part* const part : {&p1_, &p2_}) {
+    EXPECT_EQ(astronomy::J2000 + 2.5 * Second,
+              (--part->history_end()).time());
+  }
+}
+
+// If the integration of a batch fails, each pile-up finishes the integration by
+// itself, and a new batch is built the next time.
+TEST_F(CoastingPileUpsTest, Collision) {
+  EXPECT_CALL(ephemeris_, NewInstance(SizeIs(2), _, _, _));
+  EXPECT_CALL(ephemeris_, NewInstance(SizeIs(1), _, _)).Times(2);
+  EXPECT_CALL(ephemeris_, FlowWithFixedStep(_, _))
+      .Times(3)
+      .WillOnce(Return(Status(Error::OUT_OF_RANGE, "Collision")))
+      .WillRepeatedly(DoDefault());
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _)).Times(2);
+  AdvanceTime({&pile_up1_, &pile_up2_}, astronomy::J2000 + 1 * Second);
+  for (Part* const part : {&p1_, &p2_}) {
+    EXPECT_EQ(astronomy::J2000 + 0.5 * Second,
+              (--part->history_end()).time());
+  }
+
+  EXPECT_CALL(ephemeris_, NewInstance(SizeIs(2), _, _, _));
+  EXPECT_CALL(ephemeris_, NewInstance(_, _, _)).Times(0);
+  EXPECT_CALL(ephemeris_, FlowWithFixedStep(_, _));
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _)).Times(2);
+  AdvanceTime({&pile_up1_, &pile_up2_}, astronomy::J2000 + 2 * Second);
+  for (Part* const part : {&p1_, &p2_}) {
+    EXPECT_EQ(astronomy::J2000 + 1.5 * Second,
+              (--part->history_end()).time());
+  }
+}
+
+}  // namespace internal_coasting_pile_ups
+}  // namespace ksp_plugin
+}  // namespace principia
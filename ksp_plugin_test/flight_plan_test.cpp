@@ -461,6 +461,52 @@ TEST_F(FlightPlanTest, SetAdaptiveStepParameter) {
   EXPECT_EQ(t0_ + 42 * Second, end.time());
 }
 
+TEST_F(FlightPlanTest, SetGeneralizedAdaptiveStepParameter) {
+  flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
+  EXPECT_TRUE(flight_plan_->Append(MakeFirstBurn()));
+  auto frenet_burn = MakeSecondBurn();
+  frenet_burn.is_inertially_fixed = false;
+  EXPECT_TRUE(flight_plan_->Append(std::move(frenet_burn)));
+  EXPECT_EQ(5, flight_plan_->number_of_segments());
+
+  // Only the segments starting with the coast before the second burn are
+  // recomputed.  The result must be the same as recomputing everything.
+  EXPECT_TRUE(flight_plan_->SetAdaptiveStepParameters(
+      flight_plan_->adaptive_step_parameters(),
+      Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters(
+          EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator<
+              Fine1987RKNG34,
+              Position<Barycentric>>(),
+          /*max_steps=*/1000,
+          /*length_integration_tolerance=*/1 * Metre,
+          /*speed_integration_tolerance=*/1 * Metre / Second)));
+  EXPECT_EQ(5, flight_plan_->number_of_segments());
+
+  serialization::FlightPlan message;
+  flight_plan_->WriteToMessage(&message);
+  auto const recomputed_flight_plan =
+      FlightPlan::ReadFromMessage(message, ephemeris_.get());
+  ASSERT_EQ(5, recomputed_flight_plan->number_of_segments());
+  for (int i = 0; i < flight_plan_->number_of_segments(); ++i) {
+    DiscreteTrajectory<Barycentric>::Iterator begin;
+    DiscreteTrajectory<Barycentric>::Iterator end;
+    DiscreteTrajectory<Barycentric>::Iterator recomputed_begin;
+    DiscreteTrajectory<Barycentric>::Iterator recomputed_end;
+    flight_plan_->GetSegment(i, begin, end);
+    recomputed_flight_plan->GetSegment(i, recomputed_begin, recomputed_end);
+    auto it = begin;
+    auto recomputed_it = recomputed_begin;
+    for (; it != end && recomputed_it != recomputed_end;
+         ++it, ++recomputed_it) {
+      EXPECT_EQ(recomputed_it.time(), it.time()) << i;
+      EXPECT_EQ(recomputed_it.degrees_of_freedom(), it.degrees_of_freedom())
+          << i;
+    }
+    EXPECT_TRUE(it == end) << i;
+    EXPECT_TRUE(recomputed_it == recomputed_end) << i;
+  }
+}
+
 TEST_F(FlightPlanTest, GuidedBurn) {
   flight_plan_->SetDesiredFinalTime(t0_ + 42 * Second);
   auto unguided_burn = MakeFirstBurn();
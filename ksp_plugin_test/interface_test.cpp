@@ -2,11 +2,13 @@
 #include "ksp_plugin/interface.hpp"
 
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "astronomy/time_scales.hpp"
+#include "base/base32768.hpp"
 #include "base/not_null.hpp"
 #include "base/pull_serializer.hpp"
 #include "base/push_deserializer.hpp"
@@ -35,6 +37,8 @@ namespace principia {
 namespace interface {
 
 using astronomy::operator""_TT;
+using base::Array;
+using base::Base32768Encode;
 using base::check_not_null;
 using base::make_not_null_unique;
 using base::ParseFromBytes;
@@ -611,12 +615,73 @@ TEST_F(InterfaceTest, Apocalypse) {
   EXPECT_THAT(details, IsNull());
 }
 
+TEST_F(InterfaceTest, SerializePluginBase32768) {
+  PullSerializer* serializer = nullptr;
+  auto const message = ParseFromBytes<principia::serialization::Plugin>(
+      serialized_simple_plugin_);
+
+  EXPECT_CALL(*plugin_, SerializeInParts())
+      .WillOnce(Return([message, written = std::make_shared<bool>(false)](
+                           not_null<serialization::Plugin*> const part) {
+        if (*written) {
+          return false;
+        }
+        *part = message;
+        *written = true;
+        return true;
+      }));
+  char16_t const* serialization =
+      principia__SerializePluginBase32768(plugin_.get(),
+                                          &serializer,
+                                          /*compressor=*/nullptr);
+  auto const expected = Base32768Encode(
+      Array<std::uint8_t const>(serialized_simple_plugin_.data(),
+                                serialized_simple_plugin_.size()),
+      /*null_terminated=*/true);
+  EXPECT_EQ(std::u16string(expected.data.get()),
+            std::u16string(serialization));
+  EXPECT_EQ(nullptr,
+            principia__SerializePluginBase32768(plugin_.get(),
+                                                &serializer,
+                                                /*compressor=*/nullptr));
+  principia__DeleteU16String(&serialization);
+  EXPECT_THAT(serialization, IsNull());
+}
+
+TEST_F(InterfaceTest, DeserializePluginBase32768) {
+  PushDeserializer* deserializer = nullptr;
+  Plugin const* plugin = nullptr;
+  auto const base32768_simple_plugin = Base32768Encode(
+      Array<std::uint8_t const>(serialized_simple_plugin_.data(),
+                                serialized_simple_plugin_.size()),
+      /*null_terminated=*/true);
+  principia__DeserializePluginBase32768(base32768_simple_plugin.data.get(),
+                                        &deserializer,
+                                        &plugin,
+                                        /*compressor=*/nullptr);
+  principia__DeserializePluginBase32768(u"",
+                                        &deserializer,
+                                        &plugin,
+                                        /*compressor=*/nullptr);
+  EXPECT_THAT(plugin, NotNull());
+  principia__DeletePlugin(&plugin);
+}
+
 TEST_F(InterfaceTest, SerializePluginHexadecimal) {
   PullSerializer* serializer = nullptr;
   auto const message = ParseFromBytes<principia::serialization::Plugin>(
       serialized_simple_plugin_);
 
-  EXPECT_CALL(*plugin_, WriteToMessage(_)).WillOnce(SetArgPointee<0>(message));
+  EXPECT_CALL(*plugin_, SerializeInParts())
+      .WillOnce(Return([message, written = std::make_shared<bool>(false)](
+                           not_null<serialization::Plugin*> const part) {
+        if (*written) {
+          return false;
+        }
+        *part = message;
+        *written = true;
+        return true;
+      }));
   char const* serialization =
       principia__SerializePluginHexadecimal(plugin_.get(),
                                             &serializer,
@@ -127,6 +127,7 @@ class MockPlugin : public Plugin {
 
   MOCK_CONST_METHOD1(WriteToMessage,
                      void(not_null<serialization::Plugin*> message));
+  MOCK_CONST_METHOD0(SerializeInParts, SerializationPartWriter());
 };
 
 }  // namespace internal_plugin
@@ -20,6 +20,9 @@ class MockRenderer : public Renderer {
                void(NavigationFrame const& plotting_frame));
 
   MOCK_CONST_METHOD0(GetPlottingFrame, not_null<NavigationFrame const*> ());
+  MOCK_CONST_METHOD0(
+      GetPlottingFrameMotionCache,
+      std::shared_ptr<FrameMotionCache<Barycentric, Navigation> const>());
 
   not_null<std::unique_ptr<DiscreteTrajectory<World>>>
   RenderBarycentricTrajectoryInWorld(
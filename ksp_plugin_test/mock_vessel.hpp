@@ -35,6 +35,10 @@ class MockVessel : public Vessel {
   MOCK_METHOD0(DeleteFlightPlan, void());
 
   MOCK_METHOD1(FlowPrediction, void(Instant const& last_time));
+  MOCK_METHOD2(RequestPrediction,
+               void(Instant const& last_time,
+                    not_null<ThreadPool<Status>*> thread_pool));
+  MOCK_METHOD0(WaitForPrediction, void());
 
   MOCK_CONST_METHOD0(psychohistory, DiscreteTrajectory<Barycentric> const&());
   MOCK_CONST_METHOD0(psychohistory_is_authoritative, bool());
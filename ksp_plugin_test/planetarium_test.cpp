@@ -1,11 +1,13 @@
 ﻿
 #include "ksp_plugin/planetarium.hpp"
 
+#include <algorithm>
 #include <random>
 #include <vector>
 
 #include "base/not_null.hpp"
 #include "base/serialization.hpp"
+#include "base/thread_pool.hpp"
 #include "geometry/affine_map.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/linear_map.hpp"
@@ -34,11 +36,14 @@ using astronomy::InfinitePast;
 using astronomy::InfiniteFuture;
 using base::make_not_null_unique;
 using base::ParseFromBytes;
+using base::ThreadPool;
+using geometry::AngleBetween;
 using geometry::AngularVelocity;
 using geometry::Bivector;
 using geometry::Displacement;
 using geometry::LinearMap;
 using geometry::Perspective;
+using geometry::Position;
 using geometry::RigidTransformation;
 using geometry::Rotation;
 using geometry::Vector;
@@ -57,6 +62,7 @@ using quantities::si::ArcMinute;
 using quantities::si::Degree;
 using quantities::si::Kilogram;
 using quantities::si::Metre;
+using quantities::si::Minute;
 using quantities::si::Radian;
 using quantities::si::Second;
 using testing_utilities::AlmostEquals;
@@ -65,7 +71,9 @@ using testing_utilities::VanishesBefore;
 using ::testing::_;
 using ::testing::AllOf;
 using ::testing::Ge;
+using ::testing::IsEmpty;
 using ::testing::Le;
+using ::testing::Lt;
 using ::testing::Return;
 using ::testing::ReturnRef;
 using ::testing::SizeIs;
@@ -239,6 +247,78 @@ TEST_F(PlanetariumTest, PlotMethod2) {
   }
 }
 
+TEST_F(PlanetariumTest, PlotMethod2Parallel) {
+  auto const discrete_trajectory =
+      NewCircularTrajectory(/*period=*/100'000 * Second,
+                            /*step=*/1 * Second,
+                            /*last=*/25'000 * Second);
+  auto middle = discrete_trajectory->LowerBound(t0_ + 12'000 * Second);
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  ThreadPool<void> thread_pool(/*pool_size=*/2);
+  Planetarium sequential_planetarium(
+      parameters, perspective_, &ephemeris_, &plotting_frame_);
+  Planetarium parallel_planetarium(parameters,
+                                   perspective_,
+                                   &ephemeris_,
+                                   &plotting_frame_,
+                                   /*plotting_frame_motion_cache=*/nullptr,
+                                   &thread_pool);
+
+  std::vector<Planetarium::TrajectoryRange> const ranges = {
+      {discrete_trajectory->Begin(), middle, /*reverse=*/false},
+      {middle, discrete_trajectory->End(), /*reverse=*/true},
+      {middle, middle, /*reverse=*/false},
+      {discrete_trajectory->Begin(),
+       discrete_trajectory->End(),
+       /*reverse=*/false}};
+  Instant const now = t0_ + 10 * Second;
+  for (Planetarium const* const planetarium :
+       {&sequential_planetarium, &parallel_planetarium}) {
+    auto const all_rp2_lines = planetarium->PlotMethod2(ranges, now);
+    ASSERT_THAT(all_rp2_lines, SizeIs(ranges.size()));
+    for (int i = 0; i < ranges.size(); ++i) {
+      EXPECT_EQ(planetarium->PlotMethod2(ranges[i].begin,
+                                         ranges[i].end,
+                                         now,
+                                         ranges[i].reverse),
+                all_rp2_lines[i]) << i;
+    }
+    EXPECT_THAT(all_rp2_lines[2], IsEmpty());
+    EXPECT_THAT(all_rp2_lines[3], SizeIs(1));
+    EXPECT_THAT(all_rp2_lines[3][0], SizeIs(43));
+  }
+}
+
+TEST_F(PlanetariumTest, EmptyRanges) {
+  auto const discrete_trajectory = NewCircularTrajectory(/*period=*/10 * Second,
+                                                         /*step=*/1 * Second,
+                                                         /*last=*/10 * Second);
+  auto const middle = discrete_trajectory->LowerBound(t0_ + 5 * Second);
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  Planetarium planetarium(
+      parameters, perspective_, &ephemeris_, &plotting_frame_);
+  Instant const now = t0_ + 10 * Second;
+  // An empty range plots nothing, not the entire trajectory.
+  for (auto const& it : {discrete_trajectory->Begin(),
+                         middle,
+                         discrete_trajectory->End()}) {
+    EXPECT_THAT(planetarium.PlotMethod0(it, it, now, /*reverse=*/false),
+                IsEmpty());
+    EXPECT_THAT(planetarium.PlotMethod1(it, it, now, /*reverse=*/false),
+                IsEmpty());
+    EXPECT_THAT(planetarium.PlotMethod2(it, it, now, /*reverse=*/false),
+                IsEmpty());
+  }
+}
+
 #if !defined(_DEBUG)
 TEST_F(PlanetariumTest, RealSolarSystem) {
   auto discrete_trajectory = DiscreteTrajectory<Barycentric>::ReadFromMessage(
@@ -285,6 +365,56 @@ TEST_F(PlanetariumTest, RealSolarSystem) {
   EXPECT_EQ(2, rp2_lines[0].size());
   EXPECT_EQ(9, rp2_lines[1].size());
 }
+
+// The plugin plots with a cache of the motion of the plotting frame, with nodes
+// every 10 minutes.  Check that, for all the points of an actual trajectory,
+// the directions seen from the camera with the cache and with the exact motion
+// differ by less than the angular resolution used by the plugin, so the cached
+// plots are indistinguishable from the exact ones.
+TEST_F(PlanetariumTest, RealSolarSystemMotionCache) {
+  auto discrete_trajectory = DiscreteTrajectory<Barycentric>::ReadFromMessage(
+      ParseFromBytes<serialization::DiscreteTrajectory>(
+          ReadFromBinaryFile(SOLUTION_DIR / "ksp_plugin_test" /
+                             "planetarium_trajectory.proto.bin")),
+      /*forks=*/{});
+
+  auto ephemeris = Ephemeris<Barycentric>::ReadFromMessage(
+      ParseFromBytes<serialization::Ephemeris>(
+          ReadFromBinaryFile(SOLUTION_DIR / "ksp_plugin_test" /
+                             "planetarium_ephemeris.proto.bin")));
+
+  auto plotting_frame = NavigationFrame::ReadFromMessage(
+      ParseFromBytes<serialization::DynamicFrame>(
+          ReadFromBinaryFile(SOLUTION_DIR / "ksp_plugin_test" /
+                             "planetarium_plotting_frame.proto.bin")),
+      ephemeris.get());
+
+  auto rigid_transformation =
+      RigidTransformation<Navigation, Camera>::ReadFromMessage(
+          ParseFromBytes<serialization::AffineMap>(
+              ReadFromBinaryFile(SOLUTION_DIR / "ksp_plugin_test" /
+                                 "planetarium_to_camera.proto.bin")));
+
+  FrameMotionCache<Barycentric, Navigation> const cache(plotting_frame.get(),
+                                                        /*step=*/10 * Minute);
+  Angle max_angle;
+  for (auto it = discrete_trajectory->Begin();
+       it != discrete_trajectory->End();
+       ++it) {
+    Position<Barycentric> const position = it.degrees_of_freedom().position();
+    auto const exact = plotting_frame->ToThisFrameAtTime(it.time());
+    auto const cached = cache.ToThisFrameAtTime(it.time());
+    Displacement<Camera> const exact_direction =
+        rigid_transformation(exact.rigid_transformation()(position)) -
+        Camera::origin;
+    Displacement<Camera> const cached_direction =
+        rigid_transformation(cached.rigid_transformation()(position)) -
+        Camera::origin;
+    max_angle =
+        std::max(max_angle, AngleBetween(exact_direction, cached_direction));
+  }
+  EXPECT_THAT(max_angle, Lt(0.4 * ArcMinute));
+}
 #endif
 
 }  // namespace internal_planetarium
@@ -453,6 +453,25 @@ TEST_F(PluginTest, Serialization) {
             message.renderer().plotting_frame().GetExtension(
                 serialization::BodyCentredNonRotatingDynamicFrame::extension).
                     centre());
+
+  // Serializing in parts yields the same message, both by merging the parts
+  // and by parsing the concatenation of their serializations.
+  auto const write_next_part = plugin->SerializeInParts();
+  serialization::Plugin merged_message;
+  std::string concatenated_parts;
+  int number_of_parts = 0;
+  for (serialization::Plugin part; write_next_part(&part); part.Clear()) {
+    ++number_of_parts;
+    merged_message.MergeFrom(part);
+    concatenated_parts += part.SerializePartialAsString();
+  }
+  // One part for each vessel, plus the global state, the ephemeris and the
+  // pile-ups.
+  EXPECT_EQ(4, number_of_parts);
+  EXPECT_THAT(merged_message, EqualsProto(second_message));
+  serialization::Plugin parsed_message;
+  EXPECT_TRUE(parsed_message.ParseFromString(concatenated_parts));
+  EXPECT_THAT(parsed_message, EqualsProto(second_message));
 }
 
 TEST_F(PluginTest, Initialization) {
@@ -1,6 +1,7 @@
 
 #include "ksp_plugin/renderer.hpp"
 
+#include "astronomy/epoch.hpp"
 #include "base/not_null.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
@@ -23,6 +24,8 @@ namespace principia {
 namespace ksp_plugin {
 namespace internal_renderer {
 
+using astronomy::InfiniteFuture;
+using astronomy::InfinitePast;
 using base::not_null;
 using geometry::AngularVelocity;
 using geometry::Bivector;
@@ -113,6 +116,26 @@ TEST_F(RendererTest, TargetVessel) {
   EXPECT_FALSE(renderer_.HasTargetVessel());
 }
 
+TEST_F(RendererTest, PlottingFrameMotionCache) {
+  auto const cache = renderer_.GetPlottingFrameMotionCache();
+  ASSERT_NE(nullptr, cache);
+
+  // The cache remains usable, with its frame, after the plotting frame has
+  // changed.
+  renderer_.SetPlottingFrame(
+      std::make_unique<MockDynamicFrame<Barycentric, Navigation>>());
+  EXPECT_NE(cache, renderer_.GetPlottingFrameMotionCache());
+  RigidMotion<Barycentric, Navigation> const rigid_motion(
+      RigidTransformation<Barycentric, Navigation>::Identity(),
+      AngularVelocity<Barycentric>(),
+      Velocity<Barycentric>());
+  EXPECT_CALL(*dynamic_frame_, t_min()).WillRepeatedly(Return(InfinitePast));
+  EXPECT_CALL(*dynamic_frame_, t_max()).WillRepeatedly(Return(InfiniteFuture));
+  EXPECT_CALL(*dynamic_frame_, ToThisFrameAtTime(_))
+      .WillRepeatedly(Return(rigid_motion));
+  cache->ToThisFrameAtTime(t0_ + 1 * Second);
+}
+
 TEST_F(RendererTest, RenderBarycentricTrajectoryInPlottingWithoutTargetVessel) {
   DiscreteTrajectory<Barycentric> trajectory_to_render;
   FillTrajectory<Barycentric>(
@@ -3,14 +3,20 @@
 
 #include <limits>
 #include <set>
+#include <vector>
 
+#include "absl/synchronization/notification.h"
 #include "astronomy/epoch.hpp"
 #include "base/not_null.hpp"
 #include "base/status.hpp"
+#include "base/thread_pool.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ksp_plugin/celestial.hpp"
 #include "ksp_plugin/integrators.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "physics/ephemeris.hpp"
 #include "physics/massive_body.hpp"
 #include "physics/rotating_body.hpp"
 #include "physics/mock_ephemeris.hpp"
@@ -25,15 +31,23 @@ namespace internal_vessel {
 
 using base::make_not_null_unique;
 using base::Status;
+using base::ThreadPool;
 using geometry::Displacement;
 using geometry::Position;
 using geometry::Velocity;
+using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::methods::QuinlanTremaine1990Order12;
+using physics::Ephemeris;
 using physics::MassiveBody;
 using physics::MockEphemeris;
 using physics::RotatingBody;
+using quantities::Pow;
 using quantities::si::Degree;
+using quantities::si::Hour;
 using quantities::si::Kilogram;
 using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Minute;
 using quantities::si::Radian;
 using quantities::si::Second;
 using testing_utilities::AlmostEquals;
@@ -41,6 +55,7 @@ using testing_utilities::Componentwise;
 using testing_utilities::EqualsProto;
 using ::testing::DoAll;
 using ::testing::ElementsAre;
+using ::testing::InvokeWithoutArgs;
 using ::testing::MockFunction;
 using ::testing::Return;
 using ::testing::_;
@@ -261,6 +276,202 @@ TEST_F(VesselTest, Prediction) {
                                        40.0 * Metre / Second}), 0)));
 }
 
+TEST_F(VesselTest, RequestPrediction) {
+  vessel_.PrepareHistory(astronomy::J2000);
+  ThreadPool<Status> thread_pool(/*pool_size=*/1);
+
+  // The ephemeris is prolonged on the calling thread, not by the background
+  // computation.
+  EXPECT_CALL(ephemeris_, Prolong(astronomy::J2000 + 1 * Second));
+  EXPECT_CALL(ephemeris_, t_max())
+      .WillRepeatedly(Return(astronomy::J2000 + 1 * Second));
+  EXPECT_CALL(
+      ephemeris_,
+      FlowWithAdaptiveStep(_, _, astronomy::J2000 + 1 * Second, _,
+                           /*max_ephemeris_steps=*/0, _))
+      .WillOnce(
+          DoAll(AppendToDiscreteTrajectory(
+                    astronomy::J2000 + 1.0 * Second,
+                    DegreesOfFreedom<Barycentric>(
+                        Barycentric::origin +
+                            Displacement<Barycentric>({14.0 / 3.0 * Metre,
+                                                       5.0 * Metre,
+                                                       4.0 * Metre}),
+                        Velocity<Barycentric>({140.0 / 3.0 * Metre / Second,
+                                               50.0 * Metre / Second,
+                                               40.0 * Metre / Second}))),
+                Return(Status::OK)));
+  vessel_.RequestPrediction(astronomy::J2000 + 1 * Second, &thread_pool);
+  vessel_.WaitForPrediction();
+
+  EXPECT_EQ(2, vessel_.prediction().Size());
+  auto it = vessel_.prediction().Begin();
+  EXPECT_EQ(astronomy::J2000, it.time());
+  ++it;
+  EXPECT_EQ(astronomy::J2000 + 1.0 * Second, it.time());
+  EXPECT_THAT(
+      it.degrees_of_freedom(),
+      Componentwise(AlmostEquals(Barycentric::origin +
+                                      Displacement<Barycentric>(
+                                          {14.0 / 3.0 * Metre,
+                                           5.0 * Metre,
+                                           4.0 * Metre}), 0),
+                    AlmostEquals(Velocity<Barycentric>(
+                                      {140.0 / 3.0 * Metre / Second,
+                                       50.0 * Metre / Second,
+                                       40.0 * Metre / Second}), 0)));
+}
+
+// Predictions are computed while the main thread evaluates the trajectories of
+// the bodies, e.g., for plotting.  The background computation must not prolong
+// the ephemeris.
+TEST_F(VesselTest, RequestPredictionWhilePlotting) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  bodies.emplace_back(
+      make_not_null_unique<MassiveBody>(1 * Pow<3>(Metre) / Pow<2>(Second)));
+  std::vector<DegreesOfFreedom<Barycentric>> initial_state{
+      {Barycentric::origin, Velocity<Barycentric>()}};
+  Ephemeris<Barycentric> ephemeris(
+      std::move(bodies),
+      initial_state,
+      /*initial_time=*/astronomy::J2000,
+      /*fitting_tolerance=*/1 * Milli(Metre),
+      Ephemeris<Barycentric>::FixedStepParameters(
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<Barycentric>>(),
+          /*step=*/10 * Minute));
+  ephemeris.Prolong(astronomy::J2000 + 1 * Hour);
+  auto const& trajectory = *ephemeris.trajectory(ephemeris.bodies().back());
+
+  Vessel vessel("456",
+                "vessel",
+                &celestial_,
+                &ephemeris,
+                DefaultPredictionParameters());
+  vessel.AddPart(make_not_null_unique<Part>(
+      part_id1_,
+      "p1",
+      mass1_,
+      DegreesOfFreedom<Barycentric>(
+          Barycentric::origin +
+              Displacement<Barycentric>({1 * Metre, 0 * Metre, 0 * Metre}),
+          Velocity<Barycentric>(
+              {0 * Metre / Second, 1 * Metre / Second, 0 * Metre / Second})),
+      /*deletion_callback=*/nullptr));
+  vessel.PrepareHistory(astronomy::J2000);
+
+  ThreadPool<Status> thread_pool(/*pool_size=*/1);
+  for (int i = 0; i < 10; ++i) {
+    vessel.RequestPrediction(astronomy::InfiniteFuture, &thread_pool);
+    Instant const t_max = ephemeris.t_max();
+    // Plot while the prediction is being computed.
+    for (Instant t = trajectory.t_min(); t <= t_max; t += 1 * Minute) {
+      trajectory.EvaluateDegreesOfFreedom(t);
+    }
+    vessel.WaitForPrediction();
+    EXPECT_EQ(t_max, ephemeris.t_max());
+    EXPECT_LE(vessel.prediction().last().time(), t_max);
+  }
+}
+
+// A request made while a prediction is being computed is picked up when that
+// computation is done.
+TEST_F(VesselTest, QueuedPredictionRequest) {
+  vessel_.PrepareHistory(astronomy::J2000);
+  ThreadPool<Status> thread_pool(/*pool_size=*/1);
+  absl::Notification second_request_made;
+
+  DegreesOfFreedom<Barycentric> const dof(
+      Barycentric::origin +
+          Displacement<Barycentric>({14.0 / 3.0 * Metre,
+                                     5.0 * Metre,
+                                     4.0 * Metre}),
+      Velocity<Barycentric>({140.0 / 3.0 * Metre / Second,
+                             50.0 * Metre / Second,
+                             40.0 * Metre / Second}));
+  EXPECT_CALL(ephemeris_, Prolong(astronomy::J2000 + 1 * Second));
+  EXPECT_CALL(ephemeris_, Prolong(astronomy::J2000 + 2 * Second));
+  EXPECT_CALL(ephemeris_, t_max())
+      .WillRepeatedly(Return(astronomy::J2000 + 2 * Second));
+  EXPECT_CALL(
+      ephemeris_,
+      FlowWithAdaptiveStep(_, _, astronomy::J2000 + 1 * Second, _, _, _))
+      .WillOnce(DoAll(InvokeWithoutArgs([&second_request_made]() {
+                        second_request_made.WaitForNotification();
+                      }),
+                      AppendToDiscreteTrajectory(
+                          astronomy::J2000 + 1 * Second, dof),
+                      Return(Status::OK)));
+  EXPECT_CALL(
+      ephemeris_,
+      FlowWithAdaptiveStep(_, _, astronomy::J2000 + 2 * Second, _, _, _))
+      .WillOnce(DoAll(AppendToDiscreteTrajectory(
+                          astronomy::J2000 + 2 * Second, dof),
+                      Return(Status::OK)));
+  vessel_.RequestPrediction(astronomy::J2000 + 1 * Second, &thread_pool);
+  vessel_.RequestPrediction(astronomy::J2000 + 2 * Second, &thread_pool);
+  second_request_made.Notify();
+  vessel_.WaitForPrediction();
+
+  EXPECT_EQ(2, vessel_.prediction().Size());
+  EXPECT_EQ(astronomy::J2000 + 2 * Second, vessel_.prediction().last().time());
+}
+
+// A prediction computed from a psychohistory that has changed in the meantime
+// is not attached.
+TEST_F(VesselTest, StalePrediction) {
+  vessel_.PrepareHistory(astronomy::J2000);
+  ThreadPool<Status> thread_pool(/*pool_size=*/1);
+  absl::Notification psychohistory_changed;
+
+  EXPECT_CALL(ephemeris_, Prolong(astronomy::J2000 + 1 * Second));
+  EXPECT_CALL(ephemeris_, t_max())
+      .WillRepeatedly(Return(astronomy::J2000 + 1 * Second));
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _, _))
+      .WillOnce(DoAll(InvokeWithoutArgs([&psychohistory_changed]() {
+                        psychohistory_changed.WaitForNotification();
+                      }),
+                      AppendToDiscreteTrajectory(astronomy::J2000 + 1 * Second,
+                                                 p1_dof_),
+                      Return(Status::OK)));
+  vessel_.RequestPrediction(astronomy::J2000 + 1 * Second, &thread_pool);
+
+  p1_->AppendToHistory(astronomy::J2000 + 0.5 * Second, p1_dof_);
+  p2_->AppendToHistory(astronomy::J2000 + 0.5 * Second, p2_dof_);
+  vessel_.AdvanceTime();
+  psychohistory_changed.Notify();
+  vessel_.WaitForPrediction();
+
+  EXPECT_EQ(1, vessel_.prediction().Size());
+  EXPECT_EQ(astronomy::J2000 + 0.5 * Second,
+            vessel_.prediction().last().time());
+}
+
+// The ephemeris is not prolonged for a prediction that doesn't reach its end.
+TEST_F(VesselTest, LaggingPrediction) {
+  vessel_.PrepareHistory(astronomy::J2000);
+  ThreadPool<Status> thread_pool(/*pool_size=*/1);
+
+  EXPECT_CALL(ephemeris_, Prolong(_)).Times(0);
+  EXPECT_CALL(ephemeris_, t_max())
+      .WillRepeatedly(Return(astronomy::J2000 + 2 * Second));
+  EXPECT_CALL(
+      ephemeris_,
+      FlowWithAdaptiveStep(_, _, astronomy::J2000 + 2 * Second, _,
+                           /*max_ephemeris_steps=*/0, _))
+      .Times(2)
+      .WillOnce(DoAll(AppendToDiscreteTrajectory(astronomy::J2000 + 1 * Second,
+                                                 p1_dof_),
+                      Return(Status::OK)))
+      .WillOnce(Return(Status::OK));
+  for (int i = 0; i < 2; ++i) {
+    vessel_.RequestPrediction(astronomy::InfiniteFuture, &thread_pool);
+    vessel_.WaitForPrediction();
+    EXPECT_EQ(astronomy::J2000 + 1 * Second,
+              vessel_.prediction().last().time());
+  }
+}
+
 TEST_F(VesselTest, PredictBeyondTheInfinite) {
   vessel_.PrepareHistory(astronomy::J2000);
 
@@ -364,6 +575,89 @@ TEST_F(VesselTest, SerializationSuccess) {
   EXPECT_THAT(message, EqualsProto(second_message));
 }
 
+TEST_F(VesselTest, SerializationPackedHistory) {
+  MockFunction<int(not_null<PileUp const*>)>
+      serialization_index_for_pile_up;
+  EXPECT_CALL(serialization_index_for_pile_up, Call(_)).Times(0);
+
+  vessel_.PrepareHistory(astronomy::J2000);
+  p1_->AppendToHistory(astronomy::J2000 + 0.5 * Second, p1_dof_);
+  p1_->AppendToHistory(astronomy::J2000 + 1.0 * Second, p1_dof_);
+  p2_->AppendToHistory(astronomy::J2000 + 0.5 * Second, p2_dof_);
+  p2_->AppendToHistory(astronomy::J2000 + 1.0 * Second, p2_dof_);
+  vessel_.AdvanceTime();
+
+  serialization::Vessel message;
+  vessel_.WriteToMessage(&message,
+                         serialization_index_for_pile_up.AsStdFunction());
+  EXPECT_EQ(3, message.history().timeline_size());
+
+  // The history of the deserialized vessel is packed: the psychohistory only
+  // has its last point.  It is written unchanged.
+  auto const v = Vessel::ReadFromMessage(
+      message, &celestial_, &ephemeris_, /*deletion_callback=*/nullptr);
+  EXPECT_EQ(astronomy::J2000 + 1.0 * Second, v->psychohistory_last().time());
+  EXPECT_EQ(1, v->psychohistory().Size());
+  serialization::Vessel second_message;
+  v->WriteToMessage(&second_message,
+                    serialization_index_for_pile_up.AsStdFunction());
+  EXPECT_THAT(second_message, EqualsProto(message));
+
+  // Forgetting packed points doesn't require unpacking, and the history is
+  // complete once unpacked.
+  vessel_.ForgetBefore(astronomy::J2000 + 0.5 * Second);
+  v->ForgetBefore(astronomy::J2000 + 0.5 * Second);
+  EXPECT_EQ(1, v->psychohistory().Size());
+  v->UnpackHistory();
+  EXPECT_EQ(2, v->psychohistory().Size());
+  EXPECT_EQ(astronomy::J2000 + 0.5 * Second, v->psychohistory().Begin().time());
+  serialization::Vessel third_message;
+  vessel_.WriteToMessage(&third_message,
+                         serialization_index_for_pile_up.AsStdFunction());
+  serialization::Vessel fourth_message;
+  v->WriteToMessage(&fourth_message,
+                    serialization_index_for_pile_up.AsStdFunction());
+  EXPECT_THAT(fourth_message, EqualsProto(third_message));
+}
+
+TEST_F(VesselTest, SerializationUnpackAndRepack) {
+  MockFunction<int(not_null<PileUp const*>)>
+      serialization_index_for_pile_up;
+  EXPECT_CALL(serialization_index_for_pile_up, Call(_)).Times(0);
+
+  vessel_.PrepareHistory(astronomy::J2000);
+  p1_->AppendToHistory(astronomy::J2000 + 0.5 * Second, p1_dof_);
+  p1_->AppendToHistory(astronomy::J2000 + 1.0 * Second, p1_dof_);
+  p2_->AppendToHistory(astronomy::J2000 + 0.5 * Second, p2_dof_);
+  p2_->AppendToHistory(astronomy::J2000 + 1.0 * Second, p2_dof_);
+  vessel_.AdvanceTime();
+
+  serialization::Vessel message;
+  vessel_.WriteToMessage(&message,
+                         serialization_index_for_pile_up.AsStdFunction());
+  EXPECT_EQ(3, message.history().timeline_size());
+
+  // Unpack the history of a deserialized vessel, write it, and read it back:
+  // no point is lost along the way.
+  auto const v1 = Vessel::ReadFromMessage(
+      message, &celestial_, &ephemeris_, /*deletion_callback=*/nullptr);
+  v1->UnpackHistory();
+  EXPECT_EQ(3, v1->psychohistory().Size());
+  serialization::Vessel second_message;
+  v1->WriteToMessage(&second_message,
+                     serialization_index_for_pile_up.AsStdFunction());
+  EXPECT_EQ(3, second_message.history().timeline_size());
+
+  auto const v2 = Vessel::ReadFromMessage(
+      second_message, &celestial_, &ephemeris_, /*deletion_callback=*/nullptr);
+  serialization::Vessel third_message;
+  v2->WriteToMessage(&third_message,
+                     serialization_index_for_pile_up.AsStdFunction());
+  EXPECT_EQ(3, third_message.history().timeline_size());
+  v2->UnpackHistory();
+  EXPECT_EQ(3, v2->psychohistory().Size());
+}
+
 }  // namespace internal_vessel
 }  // namespace ksp_plugin
 }  // namespace principia
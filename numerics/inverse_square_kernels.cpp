@@ -0,0 +1,409 @@
+﻿
+#include "numerics/inverse_square_kernels.hpp"
+
+#include <immintrin.h>
+
+#include <cmath>
+
+#include "base/cpuid.hpp"
+#include "base/macros.hpp"
+
+namespace principia {
+namespace numerics {
+
+using base::CPUFeature;
+using base::HasCPUFeature;
+
+namespace {
+
+// The scalar kernels process the elements in [begin, size[; they are also used
+// for the tails of the vectorized kernels.  Each multiplication is a separate
+// statement so that the compiler doesn't contract it with an addition into an
+// FMA, which it could do when these functions are inlined in a function
+// targeting AVX-512.
+
+bool AddAccelerationsBySourceScalar(double const x1,
+                                    double const y1,
+                                    double const z1,
+                                    double const μ1,
+                                    double const radius1,
+                                    std::size_t const begin,
+                                    std::size_t const size,
+                                    double const* const x,
+                                    double const* const y,
+                                    double const* const z,
+                                    double* const ax,
+                                    double* const ay,
+                                    double* const az) {
+  bool ok = true;
+  for (std::size_t i = begin; i < size; ++i) {
+    double const Δx = x1 - x[i];
+    double const Δy = y1 - y[i];
+    double const Δz = z1 - z[i];
+    double const Δx² = Δx * Δx;
+    double const Δy² = Δy * Δy;
+    double const Δz² = Δz * Δz;
+    double const Δq² = Δx² + Δy² + Δz²;
+    double const Δq_norm = std::sqrt(Δq²);
+    ok &= Δq_norm > radius1;
+    double const one_over_Δq³ = Δq_norm / (Δq² * Δq²);
+    double const μ1_over_Δq³ = μ1 * one_over_Δq³;
+    double const ax_i = Δx * μ1_over_Δq³;
+    double const ay_i = Δy * μ1_over_Δq³;
+    double const az_i = Δz * μ1_over_Δq³;
+    ax[i] += ax_i;
+    ay[i] += ay_i;
+    az[i] += az_i;
+  }
+  return ok;
+}
+
+void AddMutualAccelerationsScalar(double const x1,
+                                  double const y1,
+                                  double const z1,
+                                  double const μ1,
+                                  double& ax1,
+                                  double& ay1,
+                                  double& az1,
+                                  std::size_t const begin,
+                                  std::size_t const size,
+                                  double const* const x,
+                                  double const* const y,
+                                  double const* const z,
+                                  double const* const μ,
+                                  double* const ax,
+                                  double* const ay,
+                                  double* const az) {
+  for (std::size_t i = begin; i < size; ++i) {
+    double const Δx = x1 - x[i];
+    double const Δy = y1 - y[i];
+    double const Δz = z1 - z[i];
+    double const Δx² = Δx * Δx;
+    double const Δy² = Δy * Δy;
+    double const Δz² = Δz * Δz;
+    double const Δq² = Δx² + Δy² + Δz²;
+    double const Δq_norm = std::sqrt(Δq²);
+    double const one_over_Δq³ = Δq_norm / (Δq² * Δq²);
+    double const μ1_over_Δq³ = μ1 * one_over_Δq³;
+    double const ax_i = Δx * μ1_over_Δq³;
+    double const ay_i = Δy * μ1_over_Δq³;
+    double const az_i = Δz * μ1_over_Δq³;
+    ax[i] += ax_i;
+    ay[i] += ay_i;
+    az[i] += az_i;
+    double const μ2_over_Δq³ = μ[i] * one_over_Δq³;
+    double const ax1_i = Δx * μ2_over_Δq³;
+    double const ay1_i = Δy * μ2_over_Δq³;
+    double const az1_i = Δz * μ2_over_Δq³;
+    ax1 -= ax1_i;
+    ay1 -= ay1_i;
+    az1 -= az1_i;
+  }
+}
+
+#if PRINCIPIA_USE_SSE3_INTRINSICS
+
+// Note that we use separate multiplications and additions, not FMAs, to get
+// the same roundings as the scalar code.
+
+PRINCIPIA_TARGET("avx2")
+bool AddAccelerationsBySourceAVX2(double const x1,
+                                  double const y1,
+                                  double const z1,
+                                  double const μ1,
+                                  double const radius1,
+                                  std::size_t const size,
+                                  double const* const x,
+                                  double const* const y,
+                                  double const* const z,
+                                  double* const ax,
+                                  double* const ay,
+                                  double* const az) {
+  __m256d const x1_256d = _mm256_set1_pd(x1);
+  __m256d const y1_256d = _mm256_set1_pd(y1);
+  __m256d const z1_256d = _mm256_set1_pd(z1);
+  __m256d const μ1_256d = _mm256_set1_pd(μ1);
+  __m256d const radius1_256d = _mm256_set1_pd(radius1);
+  // A lane is set if the corresponding point collided with the source, or if
+  // its distance is NaN.
+  __m256d collisions = _mm256_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m256d const Δx = _mm256_sub_pd(x1_256d, _mm256_loadu_pd(x + i));
+    __m256d const Δy = _mm256_sub_pd(y1_256d, _mm256_loadu_pd(y + i));
+    __m256d const Δz = _mm256_sub_pd(z1_256d, _mm256_loadu_pd(z + i));
+    __m256d const Δq² = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(Δx, Δx), _mm256_mul_pd(Δy, Δy)),
+        _mm256_mul_pd(Δz, Δz));
+    __m256d const Δq_norm = _mm256_sqrt_pd(Δq²);
+    collisions = _mm256_or_pd(
+        collisions, _mm256_cmp_pd(Δq_norm, radius1_256d, _CMP_NGT_UQ));
+    __m256d const one_over_Δq³ =
+        _mm256_div_pd(Δq_norm, _mm256_mul_pd(Δq², Δq²));
+    __m256d const μ1_over_Δq³ = _mm256_mul_pd(μ1_256d, one_over_Δq³);
+    _mm256_storeu_pd(ax + i,
+                     _mm256_add_pd(_mm256_loadu_pd(ax + i),
+                                   _mm256_mul_pd(Δx, μ1_over_Δq³)));
+    _mm256_storeu_pd(ay + i,
+                     _mm256_add_pd(_mm256_loadu_pd(ay + i),
+                                   _mm256_mul_pd(Δy, μ1_over_Δq³)));
+    _mm256_storeu_pd(az + i,
+                     _mm256_add_pd(_mm256_loadu_pd(az + i),
+                                   _mm256_mul_pd(Δz, μ1_over_Δq³)));
+  }
+  bool const ok = _mm256_movemask_pd(collisions) == 0;
+  return AddAccelerationsBySourceScalar(
+             x1, y1, z1, μ1, radius1, i, size, x, y, z, ax, ay, az) && ok;
+}
+
+PRINCIPIA_TARGET("avx2")
+void AddMutualAccelerationsAVX2(double const x1,
+                                double const y1,
+                                double const z1,
+                                double const μ1,
+                                double& ax1,
+                                double& ay1,
+                                double& az1,
+                                std::size_t const size,
+                                double const* const x,
+                                double const* const y,
+                                double const* const z,
+                                double const* const μ,
+                                double* const ax,
+                                double* const ay,
+                                double* const az) {
+  __m256d const x1_256d = _mm256_set1_pd(x1);
+  __m256d const y1_256d = _mm256_set1_pd(y1);
+  __m256d const z1_256d = _mm256_set1_pd(z1);
+  __m256d const μ1_256d = _mm256_set1_pd(μ1);
+  // The accelerations on the first body, which must be accumulated
+  // sequentially.
+  alignas(32) double a1x[4];
+  alignas(32) double a1y[4];
+  alignas(32) double a1z[4];
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m256d const Δx = _mm256_sub_pd(x1_256d, _mm256_loadu_pd(x + i));
+    __m256d const Δy = _mm256_sub_pd(y1_256d, _mm256_loadu_pd(y + i));
+    __m256d const Δz = _mm256_sub_pd(z1_256d, _mm256_loadu_pd(z + i));
+    __m256d const Δq² = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(Δx, Δx), _mm256_mul_pd(Δy, Δy)),
+        _mm256_mul_pd(Δz, Δz));
+    __m256d const Δq_norm = _mm256_sqrt_pd(Δq²);
+    __m256d const one_over_Δq³ =
+        _mm256_div_pd(Δq_norm, _mm256_mul_pd(Δq², Δq²));
+    __m256d const μ1_over_Δq³ = _mm256_mul_pd(μ1_256d, one_over_Δq³);
+    _mm256_storeu_pd(ax + i,
+                     _mm256_add_pd(_mm256_loadu_pd(ax + i),
+                                   _mm256_mul_pd(Δx, μ1_over_Δq³)));
+    _mm256_storeu_pd(ay + i,
+                     _mm256_add_pd(_mm256_loadu_pd(ay + i),
+                                   _mm256_mul_pd(Δy, μ1_over_Δq³)));
+    _mm256_storeu_pd(az + i,
+                     _mm256_add_pd(_mm256_loadu_pd(az + i),
+                                   _mm256_mul_pd(Δz, μ1_over_Δq³)));
+    __m256d const μ2_over_Δq³ =
+        _mm256_mul_pd(_mm256_loadu_pd(μ + i), one_over_Δq³);
+    _mm256_store_pd(a1x, _mm256_mul_pd(Δx, μ2_over_Δq³));
+    _mm256_store_pd(a1y, _mm256_mul_pd(Δy, μ2_over_Δq³));
+    _mm256_store_pd(a1z, _mm256_mul_pd(Δz, μ2_over_Δq³));
+    for (int lane = 0; lane < 4; ++lane) {
+      ax1 -= a1x[lane];
+      ay1 -= a1y[lane];
+      az1 -= a1z[lane];
+    }
+  }
+  AddMutualAccelerationsScalar(
+      x1, y1, z1, μ1, ax1, ay1, az1, i, size, x, y, z, μ, ax, ay, az);
+}
+
+PRINCIPIA_TARGET("avx512f")
+bool AddAccelerationsBySourceAVX512F(double const x1,
+                                     double const y1,
+                                     double const z1,
+                                     double const μ1,
+                                     double const radius1,
+                                     std::size_t const size,
+                                     double const* const x,
+                                     double const* const y,
+                                     double const* const z,
+                                     double* const ax,
+                                     double* const ay,
+                                     double* const az) {
+  __m512d const x1_512d = _mm512_set1_pd(x1);
+  __m512d const y1_512d = _mm512_set1_pd(y1);
+  __m512d const z1_512d = _mm512_set1_pd(z1);
+  __m512d const μ1_512d = _mm512_set1_pd(μ1);
+  __m512d const radius1_512d = _mm512_set1_pd(radius1);
+  __mmask8 collisions = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m512d const Δx = _mm512_sub_pd(x1_512d, _mm512_loadu_pd(x + i));
+    __m512d const Δy = _mm512_sub_pd(y1_512d, _mm512_loadu_pd(y + i));
+    __m512d const Δz = _mm512_sub_pd(z1_512d, _mm512_loadu_pd(z + i));
+    __m512d const Δq² = _mm512_add_pd(
+        _mm512_add_pd(_mm512_mul_pd(Δx, Δx), _mm512_mul_pd(Δy, Δy)),
+        _mm512_mul_pd(Δz, Δz));
+    __m512d const Δq_norm = _mm512_sqrt_pd(Δq²);
+    collisions |= _mm512_cmp_pd_mask(Δq_norm, radius1_512d, _CMP_NGT_UQ);
+    __m512d const one_over_Δq³ =
+        _mm512_div_pd(Δq_norm, _mm512_mul_pd(Δq², Δq²));
+    __m512d const μ1_over_Δq³ = _mm512_mul_pd(μ1_512d, one_over_Δq³);
+    _mm512_storeu_pd(ax + i,
+                     _mm512_add_pd(_mm512_loadu_pd(ax + i),
+                                   _mm512_mul_pd(Δx, μ1_over_Δq³)));
+    _mm512_storeu_pd(ay + i,
+                     _mm512_add_pd(_mm512_loadu_pd(ay + i),
+                                   _mm512_mul_pd(Δy, μ1_over_Δq³)));
+    _mm512_storeu_pd(az + i,
+                     _mm512_add_pd(_mm512_loadu_pd(az + i),
+                                   _mm512_mul_pd(Δz, μ1_over_Δq³)));
+  }
+  bool const ok = collisions == 0;
+  return AddAccelerationsBySourceScalar(
+             x1, y1, z1, μ1, radius1, i, size, x, y, z, ax, ay, az) && ok;
+}
+
+PRINCIPIA_TARGET("avx512f")
+void AddMutualAccelerationsAVX512F(double const x1,
+                                   double const y1,
+                                   double const z1,
+                                   double const μ1,
+                                   double& ax1,
+                                   double& ay1,
+                                   double& az1,
+                                   std::size_t const size,
+                                   double const* const x,
+                                   double const* const y,
+                                   double const* const z,
+                                   double const* const μ,
+                                   double* const ax,
+                                   double* const ay,
+                                   double* const az) {
+  __m512d const x1_512d = _mm512_set1_pd(x1);
+  __m512d const y1_512d = _mm512_set1_pd(y1);
+  __m512d const z1_512d = _mm512_set1_pd(z1);
+  __m512d const μ1_512d = _mm512_set1_pd(μ1);
+  alignas(64) double a1x[8];
+  alignas(64) double a1y[8];
+  alignas(64) double a1z[8];
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m512d const Δx = _mm512_sub_pd(x1_512d, _mm512_loadu_pd(x + i));
+    __m512d const Δy = _mm512_sub_pd(y1_512d, _mm512_loadu_pd(y + i));
+    __m512d const Δz = _mm512_sub_pd(z1_512d, _mm512_loadu_pd(z + i));
+    __m512d const Δq² = _mm512_add_pd(
+        _mm512_add_pd(_mm512_mul_pd(Δx, Δx), _mm512_mul_pd(Δy, Δy)),
+        _mm512_mul_pd(Δz, Δz));
+    __m512d const Δq_norm = _mm512_sqrt_pd(Δq²);
+    __m512d const one_over_Δq³ =
+        _mm512_div_pd(Δq_norm, _mm512_mul_pd(Δq², Δq²));
+    __m512d const μ1_over_Δq³ = _mm512_mul_pd(μ1_512d, one_over_Δq³);
+    _mm512_storeu_pd(ax + i,
+                     _mm512_add_pd(_mm512_loadu_pd(ax + i),
+                                   _mm512_mul_pd(Δx, μ1_over_Δq³)));
+    _mm512_storeu_pd(ay + i,
+                     _mm512_add_pd(_mm512_loadu_pd(ay + i),
+                                   _mm512_mul_pd(Δy, μ1_over_Δq³)));
+    _mm512_storeu_pd(az + i,
+                     _mm512_add_pd(_mm512_loadu_pd(az + i),
+                                   _mm512_mul_pd(Δz, μ1_over_Δq³)));
+    __m512d const μ2_over_Δq³ =
+        _mm512_mul_pd(_mm512_loadu_pd(μ + i), one_over_Δq³);
+    _mm512_store_pd(a1x, _mm512_mul_pd(Δx, μ2_over_Δq³));
+    _mm512_store_pd(a1y, _mm512_mul_pd(Δy, μ2_over_Δq³));
+    _mm512_store_pd(a1z, _mm512_mul_pd(Δz, μ2_over_Δq³));
+    for (int lane = 0; lane < 8; ++lane) {
+      ax1 -= a1x[lane];
+      ay1 -= a1y[lane];
+      az1 -= a1z[lane];
+    }
+  }
+  AddMutualAccelerationsScalar(
+      x1, y1, z1, μ1, ax1, ay1, az1, i, size, x, y, z, μ, ax, ay, az);
+}
+
+#endif
+
+KernelInstructionSet ComputeBestKernelInstructionSet() {
+#if PRINCIPIA_USE_SSE3_INTRINSICS
+  if (HasCPUFeature(CPUFeature::AVX512F)) {
+    return KernelInstructionSet::AVX512F;
+  } else if (HasCPUFeature(CPUFeature::AVX2)) {
+    return KernelInstructionSet::AVX2;
+  }
+#endif
+  return KernelInstructionSet::Scalar;
+}
+
+}  // namespace
+
+KernelInstructionSet BestKernelInstructionSet() {
+  static KernelInstructionSet const best = ComputeBestKernelInstructionSet();
+  return best;
+}
+
+bool AddAccelerationsBySource(KernelInstructionSet const instruction_set,
+                              double const x1,
+                              double const y1,
+                              double const z1,
+                              double const μ1,
+                              double const radius1,
+                              std::size_t const size,
+                              double const* const x,
+                              double const* const y,
+                              double const* const z,
+                              double* const ax,
+                              double* const ay,
+                              double* const az) {
+  switch (instruction_set) {
+#if PRINCIPIA_USE_SSE3_INTRINSICS
+    case KernelInstructionSet::AVX512F:
+      return AddAccelerationsBySourceAVX512F(
+          x1, y1, z1, μ1, radius1, size, x, y, z, ax, ay, az);
+    case KernelInstructionSet::AVX2:
+      return AddAccelerationsBySourceAVX2(
+          x1, y1, z1, μ1, radius1, size, x, y, z, ax, ay, az);
+#endif
+    default:
+      return AddAccelerationsBySourceScalar(
+          x1, y1, z1, μ1, radius1, /*begin=*/0, size, x, y, z, ax, ay, az);
+  }
+}
+
+void AddMutualAccelerations(KernelInstructionSet const instruction_set,
+                            double const x1,
+                            double const y1,
+                            double const z1,
+                            double const μ1,
+                            double& ax1,
+                            double& ay1,
+                            double& az1,
+                            std::size_t const size,
+                            double const* const x,
+                            double const* const y,
+                            double const* const z,
+                            double const* const μ,
+                            double* const ax,
+                            double* const ay,
+                            double* const az) {
+  switch (instruction_set) {
+#if PRINCIPIA_USE_SSE3_INTRINSICS
+    case KernelInstructionSet::AVX512F:
+      return AddMutualAccelerationsAVX512F(
+          x1, y1, z1, μ1, ax1, ay1, az1, size, x, y, z, μ, ax, ay, az);
+    case KernelInstructionSet::AVX2:
+      return AddMutualAccelerationsAVX2(
+          x1, y1, z1, μ1, ax1, ay1, az1, size, x, y, z, μ, ax, ay, az);
+#endif
+    default:
+      return AddMutualAccelerationsScalar(x1, y1, z1, μ1,
+                                          ax1, ay1, az1,
+                                          /*begin=*/0, size,
+                                          x, y, z, μ,
+                                          ax, ay, az);
+  }
+}
+
+}  // namespace numerics
+}  // namespace principia
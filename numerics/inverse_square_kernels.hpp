@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include <cstddef>
+
+namespace principia {
+namespace numerics {
+
+// Vectorized kernels for the accelerations resulting from an inverse-square
+// law, e.g., Newtonian gravitation.  The points are given as structures of
+// arrays of coordinates, and all the quantities are in SI units.  For a
+// displacement Δq between two points, the acceleration is Δq μ / |Δq|³, where
+// |Δq|² = Δx² + Δy² + Δz² and 1 / |Δq|³ = |Δq| / (|Δq|² |Δq|²).  The kernels
+// perform the same operations in the same order as a naïve scalar computation,
+// so their results are bit-for-bit identical whatever the instruction set.
+
+enum class KernelInstructionSet {
+  Scalar,
+  AVX2,
+  AVX512F,
+};
+
+// Returns the most efficient instruction set supported by the processor, or
+// |Scalar| if we are not using intrinsics.
+KernelInstructionSet BestKernelInstructionSet();
+
+// For i in [0, size[, adds to (ax[i], ay[i], az[i]) the acceleration exerted
+// by a source at (x1, y1, z1) with parameter |μ1| on the point
+// (x[i], y[i], z[i]).  Returns false iff one of the points is within |radius1|
+// of the source.
+bool AddAccelerationsBySource(KernelInstructionSet instruction_set,
+                              double x1, double y1, double z1,
+                              double μ1,
+                              double radius1,
+                              std::size_t size,
+                              double const* x,
+                              double const* y,
+                              double const* z,
+                              double* ax,
+                              double* ay,
+                              double* az);
+
+// For i in [0, size[, adds to (ax[i], ay[i], az[i]) the acceleration exerted
+// by a body at (x1, y1, z1) with parameter |μ1| on the body at
+// (x[i], y[i], z[i]) with parameter |μ[i]|, and adds to (ax1, ay1, az1) the
+// acceleration exerted by the latter on the former.  The accelerations on the
+// first body are accumulated in increasing order of i.
+void AddMutualAccelerations(KernelInstructionSet instruction_set,
+                            double x1, double y1, double z1,
+                            double μ1,
+                            double& ax1, double& ay1, double& az1,
+                            std::size_t size,
+                            double const* x,
+                            double const* y,
+                            double const* z,
+                            double const* μ,
+                            double* ax,
+                            double* ay,
+                            double* az);
+
+}  // namespace numerics
+}  // namespace principia
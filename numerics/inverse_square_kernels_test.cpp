@@ -0,0 +1,191 @@
+﻿
+#include "numerics/inverse_square_kernels.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "base/cpuid.hpp"
+#include "base/macros.hpp"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace numerics {
+
+using base::CPUFeature;
+using base::HasCPUFeature;
+
+class InverseSquareKernelsTest : public ::testing::Test {
+ protected:
+  struct Points {
+    explicit Points(std::size_t const size)
+        : x(size), y(size), z(size), μ(size), ax(size), ay(size), az(size) {}
+
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<double> μ;
+    std::vector<double> ax;
+    std::vector<double> ay;
+    std::vector<double> az;
+  };
+
+  Points RandomPoints(std::size_t const size) {
+    Points points(size);
+    std::uniform_real_distribution<double> coordinate(-1e11, 1e11);
+    std::uniform_real_distribution<double> parameter(1e10, 1e20);
+    std::uniform_real_distribution<double> acceleration(-1e-3, 1e-3);
+    for (std::size_t i = 0; i < size; ++i) {
+      points.x[i] = coordinate(random_);
+      points.y[i] = coordinate(random_);
+      points.z[i] = coordinate(random_);
+      points.μ[i] = parameter(random_);
+      points.ax[i] = acceleration(random_);
+      points.ay[i] = acceleration(random_);
+      points.az[i] = acceleration(random_);
+    }
+    return points;
+  }
+
+  std::vector<KernelInstructionSet> SupportedInstructionSets() const {
+    std::vector<KernelInstructionSet> instruction_sets;
+#if PRINCIPIA_USE_SSE3_INTRINSICS
+    if (HasCPUFeature(CPUFeature::AVX2)) {
+      instruction_sets.push_back(KernelInstructionSet::AVX2);
+    }
+    if (HasCPUFeature(CPUFeature::AVX512F)) {
+      instruction_sets.push_back(KernelInstructionSet::AVX512F);
+    }
+#endif
+    return instruction_sets;
+  }
+
+  std::mt19937_64 random_{42};
+};
+
+TEST_F(InverseSquareKernelsTest, Scalar) {
+  Points points = RandomPoints(3);
+  Points expected = points;
+  double const x1 = 1e10;
+  double const y1 = -2e10;
+  double const z1 = 3e10;
+  double const μ1 = 4e20;
+  double ax1 = 0;
+  double ay1 = 0;
+  double az1 = 0;
+  double expected_ax1 = 0;
+  double expected_ay1 = 0;
+  double expected_az1 = 0;
+  for (std::size_t i = 0; i < 3; ++i) {
+    double const Δx = x1 - points.x[i];
+    double const Δy = y1 - points.y[i];
+    double const Δz = z1 - points.z[i];
+    double const Δq³ = std::pow(Δx * Δx + Δy * Δy + Δz * Δz, 1.5);
+    expected.ax[i] += Δx * μ1 / Δq³;
+    expected.ay[i] += Δy * μ1 / Δq³;
+    expected.az[i] += Δz * μ1 / Δq³;
+    expected_ax1 -= Δx * points.μ[i] / Δq³;
+    expected_ay1 -= Δy * points.μ[i] / Δq³;
+    expected_az1 -= Δz * points.μ[i] / Δq³;
+  }
+  AddMutualAccelerations(KernelInstructionSet::Scalar,
+                         x1, y1, z1,
+                         μ1,
+                         ax1, ay1, az1,
+                         points.x.size(),
+                         points.x.data(), points.y.data(), points.z.data(),
+                         points.μ.data(),
+                         points.ax.data(), points.ay.data(), points.az.data());
+  for (std::size_t i = 0; i < 3; ++i) {
+    EXPECT_NEAR(expected.ax[i], points.ax[i], 1e-13 * std::abs(expected.ax[i]));
+    EXPECT_NEAR(expected.ay[i], points.ay[i], 1e-13 * std::abs(expected.ay[i]));
+    EXPECT_NEAR(expected.az[i], points.az[i], 1e-13 * std::abs(expected.az[i]));
+  }
+  EXPECT_NEAR(expected_ax1, ax1, 1e-13 * std::abs(expected_ax1));
+  EXPECT_NEAR(expected_ay1, ay1, 1e-13 * std::abs(expected_ay1));
+  EXPECT_NEAR(expected_az1, az1, 1e-13 * std::abs(expected_az1));
+}
+
+TEST_F(InverseSquareKernelsTest, Collision) {
+  auto instruction_sets = SupportedInstructionSets();
+  instruction_sets.push_back(KernelInstructionSet::Scalar);
+  for (auto const instruction_set : instruction_sets) {
+    for (std::size_t const size : {1, 5, 13}) {
+      Points points = RandomPoints(size);
+      EXPECT_TRUE(AddAccelerationsBySource(
+          instruction_set,
+          /*x1=*/0, /*y1=*/0, /*z1=*/0, /*μ1=*/1e20, /*radius1=*/1e3,
+          size,
+          points.x.data(), points.y.data(), points.z.data(),
+          points.ax.data(), points.ay.data(), points.az.data()));
+      points.x[size - 1] = 1;
+      points.y[size - 1] = 1;
+      points.z[size - 1] = 1;
+      EXPECT_FALSE(AddAccelerationsBySource(
+          instruction_set,
+          /*x1=*/0, /*y1=*/0, /*z1=*/0, /*μ1=*/1e20, /*radius1=*/1e3,
+          size,
+          points.x.data(), points.y.data(), points.z.data(),
+          points.ax.data(), points.ay.data(), points.az.data()));
+    }
+  }
+}
+
+// The vectorized kernels must give the same results as the scalar one, bit for
+// bit, including on the tail that doesn't fill a vector.
+TEST_F(InverseSquareKernelsTest, BitIdentical) {
+  for (auto const instruction_set : SupportedInstructionSets()) {
+    for (std::size_t const size : {0, 1, 3, 4, 7, 8, 13, 37}) {
+      Points const points = RandomPoints(size);
+
+      Points scalar = points;
+      Points vectorized = points;
+      bool const scalar_ok = AddAccelerationsBySource(
+          KernelInstructionSet::Scalar,
+          /*x1=*/1e9, /*y1=*/2e9, /*z1=*/-3e9, /*μ1=*/1e20, /*radius1=*/1e6,
+          size,
+          scalar.x.data(), scalar.y.data(), scalar.z.data(),
+          scalar.ax.data(), scalar.ay.data(), scalar.az.data());
+      bool const vectorized_ok = AddAccelerationsBySource(
+          instruction_set,
+          /*x1=*/1e9, /*y1=*/2e9, /*z1=*/-3e9, /*μ1=*/1e20, /*radius1=*/1e6,
+          size,
+          vectorized.x.data(), vectorized.y.data(), vectorized.z.data(),
+          vectorized.ax.data(), vectorized.ay.data(), vectorized.az.data());
+      EXPECT_EQ(scalar_ok, vectorized_ok);
+      EXPECT_EQ(scalar.ax, vectorized.ax) << size;
+      EXPECT_EQ(scalar.ay, vectorized.ay) << size;
+      EXPECT_EQ(scalar.az, vectorized.az) << size;
+
+      scalar = points;
+      vectorized = points;
+      double scalar_a1[3] = {1e-3, 2e-3, 3e-3};
+      double vectorized_a1[3] = {1e-3, 2e-3, 3e-3};
+      AddMutualAccelerations(
+          KernelInstructionSet::Scalar,
+          /*x1=*/1e9, /*y1=*/2e9, /*z1=*/-3e9, /*μ1=*/1e20,
+          scalar_a1[0], scalar_a1[1], scalar_a1[2],
+          size,
+          scalar.x.data(), scalar.y.data(), scalar.z.data(),
+          scalar.μ.data(),
+          scalar.ax.data(), scalar.ay.data(), scalar.az.data());
+      AddMutualAccelerations(
+          instruction_set,
+          /*x1=*/1e9, /*y1=*/2e9, /*z1=*/-3e9, /*μ1=*/1e20,
+          vectorized_a1[0], vectorized_a1[1], vectorized_a1[2],
+          size,
+          vectorized.x.data(), vectorized.y.data(), vectorized.z.data(),
+          vectorized.μ.data(),
+          vectorized.ax.data(), vectorized.ay.data(), vectorized.az.data());
+      EXPECT_EQ(scalar.ax, vectorized.ax) << size;
+      EXPECT_EQ(scalar.ay, vectorized.ay) << size;
+      EXPECT_EQ(scalar.az, vectorized.az) << size;
+      for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(scalar_a1[i], vectorized_a1[i]) << size;
+      }
+    }
+  }
+}
+
+}  // namespace numerics
+}  // namespace principia
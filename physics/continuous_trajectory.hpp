@@ -87,6 +87,27 @@ class ContinuousTrajectory : public Trajectory<Frame> {
 
   // End of the implementation of the interface.
 
+  // Evaluates all the |trajectories| at |time|, which must be in the range of
+  // each of them, and stores the results in |positions| (resp.
+  // |degrees_of_freedom|) in the order of |trajectories|.  The results are the
+  // same as those of |EvaluatePosition| (resp. |EvaluateDegreesOfFreedom|).
+  // The trajectories of an ephemeris have polynomials that end at the same
+  // times, so the index of the polynomial used for one trajectory is tried
+  // first for the next one, starting with |polynomial_index|.  On return
+  // |polynomial_index| is the index of the last polynomial used: callers that
+  // evaluate at nearby times should keep it between calls, so that most of the
+  // time no lookup is done at all.  Any value of |polynomial_index| is correct.
+  static void EvaluateAllPositions(
+      std::vector<not_null<ContinuousTrajectory<Frame>*>> const& trajectories,
+      Instant const& time,
+      int& polynomial_index,
+      std::vector<Position<Frame>>& positions);
+  static void EvaluateAllDegreesOfFreedom(
+      std::vector<not_null<ContinuousTrajectory<Frame>*>> const& trajectories,
+      Instant const& time,
+      int& polynomial_index,
+      std::vector<DegreesOfFreedom<Frame>>& degrees_of_freedom);
+
   // Returns a checkpoint for the current state of this object.
   Checkpoint GetCheckpoint() const;
 
@@ -177,6 +198,13 @@ class ContinuousTrajectory : public Trajectory<Frame> {
   typename InstantPolynomialPairs::const_iterator
   FindPolynomialForInstant(Instant const& time) const;
 
+  // Returns the polynomial applicable for the given |time|, which must be in
+  // [t_min(), t_max()].  The polynomial at |index| is tried first; on return
+  // |index| is the index of the polynomial that was returned.
+  Polynomial<Displacement<Frame>, Instant> const& PolynomialForInstant(
+      Instant const& time,
+      int& index) const;
+
   // Construction parameters;
   Time const step_;
   Length const tolerance_;
@@ -188,6 +188,37 @@ DegreesOfFreedom<Frame> ContinuousTrajectory<Frame>::EvaluateDegreesOfFreedom(
                                  polynomial->EvaluateDerivative(time));
 }
 
+template<typename Frame>
+void ContinuousTrajectory<Frame>::EvaluateAllPositions(
+    std::vector<not_null<ContinuousTrajectory<Frame>*>> const& trajectories,
+    Instant const& time,
+    int& polynomial_index,
+    std::vector<Position<Frame>>& positions) {
+  positions.clear();
+  positions.reserve(trajectories.size());
+  for (auto const trajectory : trajectories) {
+    auto const& polynomial =
+        trajectory->PolynomialForInstant(time, polynomial_index);
+    positions.push_back(polynomial.Evaluate(time) + Frame::origin);
+  }
+}
+
+template<typename Frame>
+void ContinuousTrajectory<Frame>::EvaluateAllDegreesOfFreedom(
+    std::vector<not_null<ContinuousTrajectory<Frame>*>> const& trajectories,
+    Instant const& time,
+    int& polynomial_index,
+    std::vector<DegreesOfFreedom<Frame>>& degrees_of_freedom) {
+  degrees_of_freedom.clear();
+  degrees_of_freedom.reserve(trajectories.size());
+  for (auto const trajectory : trajectories) {
+    auto const& polynomial =
+        trajectory->PolynomialForInstant(time, polynomial_index);
+    degrees_of_freedom.emplace_back(polynomial.Evaluate(time) + Frame::origin,
+                                    polynomial.EvaluateDerivative(time));
+  }
+}
+
 template<typename Frame>
 typename ContinuousTrajectory<Frame>::Checkpoint
 ContinuousTrajectory<Frame>::GetCheckpoint() const {
@@ -478,6 +509,25 @@ ContinuousTrajectory<Frame>::FindPolynomialForInstant(
   }
 }
 
+template<typename Frame>
+Polynomial<Displacement<Frame>, Instant> const&
+ContinuousTrajectory<Frame>::PolynomialForInstant(Instant const& time,
+                                                  int& index) const {
+  CHECK_LE(t_min(), time);
+  CHECK_GE(t_max(), time);
+  // Same test as in |FindPolynomialForInstant|, but without touching the
+  // atomic |last_accessed_polynomial_| when the hint is correct.
+  if (index >= 0 && index < polynomials_.size() &&
+      time <= polynomials_[index].t_max &&
+      (index == 0 || polynomials_[index - 1].t_max < time)) {
+    return *polynomials_[index].polynomial;
+  }
+  auto const it = FindPolynomialForInstant(time);
+  CHECK(it != polynomials_.end());
+  index = it - polynomials_.begin();
+  return *it->polynomial;
+}
+
 }  // namespace internal_continuous_trajectory
 }  // namespace physics
 }  // namespace principia
@@ -1,13 +1,14 @@
 ﻿
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <list>
-#include <map>
 #include <memory>
 #include <optional>
 #include <vector>
 
+#include "base/chunked_timeline.hpp"
 #include "base/not_constructible.hpp"
 #include "base/not_null.hpp"
 #include "geometry/grassmann.hpp"
@@ -29,12 +30,13 @@ FORWARD_DECLARE_FROM(discrete_trajectory,
 // Reopening |internal_forkable| to specialize a template.
 namespace internal_forkable {
 
+using base::ChunkedTimeline;
 using base::not_constructible;
 
 template<typename Frame>
 struct ForkableTraits<DiscreteTrajectory<Frame>> : not_constructible {
-  using TimelineConstIterator =
-      typename std::map<Instant, DegreesOfFreedom<Frame>>::const_iterator;
+  using TimelineConstIterator = typename ChunkedTimeline<
+      Instant, DegreesOfFreedom<Frame>>::const_iterator;
   static Instant const& time(TimelineConstIterator it);
 };
 
@@ -43,6 +45,9 @@ class DiscreteTrajectoryIterator
     : public ForkableIterator<DiscreteTrajectory<Frame>,
                               DiscreteTrajectoryIterator<Frame>> {
  public:
+  // The iterator remains valid when points are appended to the trajectory, but
+  // the references returned by these functions may not: copy the values if
+  // they are used across calls to |Append|.
   Instant const& time() const;
   DegreesOfFreedom<Frame> const& degrees_of_freedom() const;
 
@@ -55,6 +60,7 @@ class DiscreteTrajectoryIterator
 
 namespace internal_discrete_trajectory {
 
+using base::ChunkedTimeline;
 using base::not_null;
 using geometry::Instant;
 using geometry::Position;
@@ -70,7 +76,7 @@ template<typename Frame>
 class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
                                            DiscreteTrajectoryIterator<Frame>>,
                            public Trajectory<Frame> {
-  using Timeline = std::map<Instant, DegreesOfFreedom<Frame>>;
+  using Timeline = ChunkedTimeline<Instant, DegreesOfFreedom<Frame>>;
   using TimelineConstIterator = typename Forkable<
       DiscreteTrajectory<Frame>,
       DiscreteTrajectoryIterator<Frame>>::TimelineConstIterator;
@@ -173,6 +179,42 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
       serialization::DiscreteTrajectory const& message,
       std::vector<DiscreteTrajectory<Frame>**> const& forks);
 
+  // The points of the timeline that a serialization has written and that later
+  // serializations may omit: those up to and including |last_time|.  The
+  // |fingerprint| identifies the point at |last_time|.
+  struct DeltaBase {
+    Instant last_time;
+    std::uint64_t fingerprint;
+  };
+
+  // This trajectory must be a root.  Like |WriteToMessage|, except that if this
+  // trajectory still has the point designated by |base|, only the points after
+  // it are written to the timeline of the root; such a |message| must then be
+  // applied to the serialization that produced |base| with |ApplyDelta|.
+  // Otherwise, or if |base| is null, the entire trajectory is written.
+  // Returns the base for the next serialization, which covers the points that
+  // may only change through |ForgetBefore|: those up to the start of the dense
+  // timeline if this trajectory is downsampled, all of them otherwise.  Returns
+  // null if this trajectory is empty.
+  std::optional<DeltaBase> WriteDeltaToMessage(
+      not_null<serialization::DiscreteTrajectory*> message,
+      std::vector<DiscreteTrajectory<Frame>*> const& forks,
+      std::optional<DeltaBase> const& base) const;
+
+  // Applies the |delta| written by |WriteDeltaToMessage| to the serialization
+  // |base| on top of which it was written.  If |delta| is a complete
+  // serialization, it replaces |base|.  Afterwards, |base| is a complete
+  // serialization, suitable for |ReadFromMessage| or as the base of the next
+  // delta.
+  static void ApplyDelta(serialization::DiscreteTrajectory const& delta,
+                         not_null<serialization::DiscreteTrajectory*> base);
+
+  // Returns the base designating the last point of the timeline of the root of
+  // |message|, which must be a complete, nonempty serialization.  A trajectory
+  // that starts with that point may be written as a delta on top of |message|.
+  static DeltaBase LastPointDeltaBase(
+      serialization::DiscreteTrajectory const& message);
+
  protected:
   // The API inherited from Forkable.
   not_null<DiscreteTrajectory*> that() override;
@@ -239,15 +281,31 @@ class DiscreteTrajectory : public Forkable<DiscreteTrajectory<Frame>,
     std::int64_t dense_intervals_;
   };
 
+  // Same as the public |WriteToMessage|, but only the points of the timeline of
+  // the root starting at |timeline_begin| are serialized.
+  void WriteToMessage(
+      not_null<serialization::DiscreteTrajectory*> message,
+      std::vector<DiscreteTrajectory<Frame>*> const& forks,
+      TimelineConstIterator timeline_begin) const;
+
   // This trajectory need not be a root.
   void WriteSubTreeToMessage(
       not_null<serialization::DiscreteTrajectory*> message,
       std::vector<DiscreteTrajectory<Frame>*>& forks) const;
+  void WriteSubTreeToMessage(
+      not_null<serialization::DiscreteTrajectory*> message,
+      std::vector<DiscreteTrajectory<Frame>*>& forks,
+      TimelineConstIterator timeline_begin) const;
 
   void FillSubTreeFromMessage(
       serialization::DiscreteTrajectory const& message,
       std::vector<DiscreteTrajectory<Frame>**> const& forks);
 
+  // The fingerprint of a point of the timeline, computed on its serialization.
+  static std::uint64_t Fingerprint(
+      serialization::DiscreteTrajectory::InstantaneousDegreesOfFreedom const&
+          message);
+
   // Returns the Hermite interpolation for the left-open, right-closed
   // trajectory segment containing the given |time|, or, if |time| is |t_min()|,
   // returns a first-degree polynomial which should be evaluated only at
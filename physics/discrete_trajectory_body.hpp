@@ -4,11 +4,13 @@
 #include "physics/discrete_trajectory.hpp"
 
 #include <algorithm>
+#include <iterator>
 #include <list>
-#include <map>
 #include <vector>
 
 #include "astronomy/epoch.hpp"
+#include "base/fingerprint2011.hpp"
+#include "base/serialization.hpp"
 #include "geometry/named_quantities.hpp"
 #include "glog/logging.h"
 #include "numerics/fit_hermite_spline.hpp"
@@ -54,7 +56,9 @@ namespace internal_discrete_trajectory {
 
 using astronomy::InfiniteFuture;
 using astronomy::InfinitePast;
+using base::Fingerprint2011;
 using base::make_not_null_unique;
+using base::SerializeAsBytes;
 using numerics::FitHermiteSpline;
 
 template<typename Frame>
@@ -76,7 +80,9 @@ DiscreteTrajectory<Frame>::NewForkWithCopy(Instant const& time) {
 
   // Copy the tail of the trajectory in the child object.
   if (timeline_it != timeline_.end()) {
-    fork->timeline_.insert(++timeline_it, timeline_.end());
+    for (++timeline_it; timeline_it != timeline_.end(); ++timeline_it) {
+      fork->timeline_.emplace_back(timeline_it->first, timeline_it->second);
+    }
   }
   return fork;
 }
@@ -131,9 +137,8 @@ DiscreteTrajectory<Frame>::DetachFork() {
   // Insert a new point in the timeline for the fork time.  It should go at the
   // beginning of the timeline.
   auto const fork_it = this->Fork();
-  auto const begin_it = timeline_.emplace_hint(
-      timeline_.begin(), fork_it.time(), fork_it.degrees_of_freedom());
-  CHECK(begin_it == timeline_.begin());
+  CHECK(timeline_.empty() || fork_it.time() < timeline_.front().first);
+  timeline_.emplace_front(fork_it.time(), fork_it.degrees_of_freedom());
 
   // Detach this trajectory and tell the caller that it owns the pieces.
   return this->DetachForkWithCopiedBegin();
@@ -153,13 +158,10 @@ void DiscreteTrajectory<Frame>::Append(
                  << last().time() << "]";
     return;
   }
-  auto it = timeline_.emplace_hint(timeline_.end(),
-                                   time,
-                                   degrees_of_freedom);
-  // Decrementing |end()| is much faster than incrementing |it|.  Don't ask.
-  CHECK(--timeline_.end() == it)
+  CHECK(timeline_.empty() || timeline_.back().first < time)
       << "Append out of order at " << time << ", last time is "
-      << (--timeline_.end())->first;
+      << timeline_.back().first;
+  timeline_.emplace_back(time, degrees_of_freedom);
   if (downsampling_.has_value()) {
     if (timeline_.size() == 1) {
       downsampling_->SetStartOfDenseTimeline(timeline_.begin(), timeline_);
@@ -185,13 +187,31 @@ void DiscreteTrajectory<Frame>::Append(
         if (right_endpoints.empty()) {
           right_endpoints.push_back(dense_iterators.end() - 1);
         }
-        TimelineConstIterator left = downsampling_->start_of_dense_timeline();
+        // Only keep the left endpoint of the dense timeline, the right
+        // endpoints of the fitted intervals, and the points after the last of
+        // them.  Removing the points in between one interval at a time would
+        // shift the rest of the timeline each time, so instead we copy the
+        // points to keep and rebuild the dense timeline in a single pass.
+        std::vector<typename Timeline::value_type> kept;
+        kept.reserve(dense_iterators.size());
+        kept.push_back(*dense_iterators.front());
         for (const auto& it_in_dense_iterators : right_endpoints) {
-          TimelineConstIterator const right = *it_in_dense_iterators;
-          timeline_.erase(++left, right);
-          left = right;
+          kept.push_back(**it_in_dense_iterators);
+        }
+        for (auto it = std::next(*right_endpoints.back());
+             it != timeline_.end();
+             ++it) {
+          kept.push_back(*it);
         }
-        downsampling_->SetStartOfDenseTimeline(left, timeline_);
+        timeline_.erase(downsampling_->start_of_dense_timeline(),
+                        timeline_.end());
+        for (auto const& point : kept) {
+          timeline_.emplace_back(point.first, point.second);
+        }
+        // The last right endpoint starts the new dense timeline.
+        downsampling_->SetStartOfDenseTimeline(
+            timeline_.end() - (kept.size() - right_endpoints.size()),
+            timeline_);
       }
     }
   }
@@ -239,10 +259,9 @@ void DiscreteTrajectory<Frame>::ForgetBefore(Instant const& time) {
   // Get an iterator denoting the first entry with time >= |time|.  Remove all
   // the entries that precede it.  This preserves any entry with time == |time|.
   auto const first_kept_in_timeline = timeline_.lower_bound(time);
-  Instant const& first_kept_time = first_kept_in_timeline->first;
   if (downsampling_.has_value() &&
       (first_kept_in_timeline == timeline_.end() ||
-       downsampling_->first_dense_time() < first_kept_time)) {
+       downsampling_->first_dense_time() < first_kept_in_timeline->first)) {
     // The start of the dense timeline will be invalidated.
     downsampling_->SetStartOfDenseTimeline(first_kept_in_timeline, timeline_);
   }
@@ -297,15 +316,7 @@ void DiscreteTrajectory<Frame>::WriteToMessage(
     not_null<serialization::DiscreteTrajectory*> const message,
     std::vector<DiscreteTrajectory<Frame>*> const& forks)
     const {
-  CHECK(this->is_root());
-
-  std::vector<DiscreteTrajectory<Frame>*> mutable_forks = forks;
-  WriteSubTreeToMessage(message, mutable_forks);
-  CHECK(std::all_of(mutable_forks.begin(),
-                    mutable_forks.end(),
-                    [](DiscreteTrajectory<Frame>* const fork) {
-                      return fork == nullptr;
-                    }));
+  WriteToMessage(message, forks, timeline_.begin());
 }
 
 template<typename Frame>
@@ -319,10 +330,128 @@ DiscreteTrajectory<Frame>::ReadFromMessage(
                     [](DiscreteTrajectory<Frame>** const fork) {
                       return fork != nullptr && *fork == nullptr;
                     }));
+  CHECK(!message.has_delta()) << "Apply the delta to its base first";
   trajectory->FillSubTreeFromMessage(message, forks);
   return trajectory;
 }
 
+template<typename Frame>
+std::optional<typename DiscreteTrajectory<Frame>::DeltaBase>
+DiscreteTrajectory<Frame>::WriteDeltaToMessage(
+    not_null<serialization::DiscreteTrajectory*> const message,
+    std::vector<DiscreteTrajectory<Frame>*> const& forks,
+    std::optional<DeltaBase> const& base) const {
+  CHECK(this->is_root());
+
+  // Find the last point of the |base|, if it hasn't been forgotten or
+  // replaced since it was serialized.
+  auto base_last = timeline_.end();
+  if (base.has_value()) {
+    base_last = timeline_.find(base->last_time);
+  }
+  serialization::DiscreteTrajectory::InstantaneousDegreesOfFreedom
+      point_message;
+  if (base_last != timeline_.end()) {
+    base_last->first.WriteToMessage(point_message.mutable_instant());
+    base_last->second.WriteToMessage(
+        point_message.mutable_degrees_of_freedom());
+    if (Fingerprint(point_message) != base->fingerprint) {
+      base_last = timeline_.end();
+    }
+  }
+
+  if (base_last == timeline_.end()) {
+    WriteToMessage(message, forks);
+  } else {
+    WriteToMessage(message, forks, std::next(base_last));
+    auto* const delta = message->mutable_delta();
+    base->last_time.WriteToMessage(delta->mutable_base_last_time());
+    delta->set_base_fingerprint(base->fingerprint);
+    timeline_.front().first.WriteToMessage(delta->mutable_first_time());
+  }
+
+  if (timeline_.empty()) {
+    return std::nullopt;
+  }
+  // The points before the start of the dense timeline are never touched by
+  // the downsampling.
+  auto const& next_base_last = downsampling_.has_value()
+                                   ? *downsampling_->start_of_dense_timeline()
+                                   : timeline_.back();
+  next_base_last.first.WriteToMessage(point_message.mutable_instant());
+  next_base_last.second.WriteToMessage(
+      point_message.mutable_degrees_of_freedom());
+  return DeltaBase{next_base_last.first, Fingerprint(point_message)};
+}
+
+template<typename Frame>
+void DiscreteTrajectory<Frame>::ApplyDelta(
+    serialization::DiscreteTrajectory const& delta,
+    not_null<serialization::DiscreteTrajectory*> const base) {
+  if (!delta.has_delta()) {
+    *base = delta;
+    return;
+  }
+  CHECK(!base->has_delta());
+
+  using InstantaneousDegreesOfFreedom =
+      serialization::DiscreteTrajectory::InstantaneousDegreesOfFreedom;
+  auto const time_less_than_point =
+      [](Instant const& time, InstantaneousDegreesOfFreedom const& point) {
+        return time < Instant::ReadFromMessage(point.instant());
+      };
+  auto const point_less_than_time =
+      [](InstantaneousDegreesOfFreedom const& point, Instant const& time) {
+        return Instant::ReadFromMessage(point.instant()) < time;
+      };
+  Instant const base_last_time =
+      Instant::ReadFromMessage(delta.delta().base_last_time());
+  Instant const first_time =
+      Instant::ReadFromMessage(delta.delta().first_time());
+  auto& timeline = *base->mutable_timeline();
+
+  // Drop the points of the |base| that were replaced after it was written.
+  auto const base_end = std::upper_bound(timeline.begin(),
+                                         timeline.end(),
+                                         base_last_time,
+                                         time_less_than_point);
+  CHECK(base_end != timeline.begin());
+  auto const& base_last = *std::prev(base_end);
+  CHECK_EQ(base_last_time, Instant::ReadFromMessage(base_last.instant()));
+  CHECK_EQ(delta.delta().base_fingerprint(), Fingerprint(base_last))
+      << "Delta applied to the wrong base";
+  timeline.DeleteSubrange(base_end - timeline.begin(),
+                          timeline.end() - base_end);
+
+  // Drop the points that were forgotten.
+  auto const first = std::lower_bound(timeline.begin(),
+                                      timeline.end(),
+                                      first_time,
+                                      point_less_than_time);
+  timeline.DeleteSubrange(0, first - timeline.begin());
+
+  // The new points, the forks and the downsampling come from the |delta|.
+  timeline.MergeFrom(delta.timeline());
+  *base->mutable_children() = delta.children();
+  *base->mutable_fork_position() = delta.fork_position();
+  if (delta.has_downsampling()) {
+    *base->mutable_downsampling() = delta.downsampling();
+  } else {
+    base->clear_downsampling();
+  }
+}
+
+template<typename Frame>
+typename DiscreteTrajectory<Frame>::DeltaBase
+DiscreteTrajectory<Frame>::LastPointDeltaBase(
+    serialization::DiscreteTrajectory const& message) {
+  CHECK(!message.has_delta());
+  CHECK_LT(0, message.timeline_size());
+  auto const& last = message.timeline(message.timeline_size() - 1);
+  return DeltaBase{Instant::ReadFromMessage(last.instant()),
+                   Fingerprint(last)};
+}
+
 template<typename Frame>
 not_null<DiscreteTrajectory<Frame>*> DiscreteTrajectory<Frame>::that() {
   return this;
@@ -465,14 +594,38 @@ DiscreteTrajectory<Frame>::Downsampling::ReadFromMessage(
                       timeline);
 }
 
+template<typename Frame>
+void DiscreteTrajectory<Frame>::WriteToMessage(
+    not_null<serialization::DiscreteTrajectory*> const message,
+    std::vector<DiscreteTrajectory<Frame>*> const& forks,
+    TimelineConstIterator const timeline_begin) const {
+  CHECK(this->is_root());
+
+  std::vector<DiscreteTrajectory<Frame>*> mutable_forks = forks;
+  WriteSubTreeToMessage(message, mutable_forks, timeline_begin);
+  CHECK(std::all_of(mutable_forks.begin(),
+                    mutable_forks.end(),
+                    [](DiscreteTrajectory<Frame>* const fork) {
+                      return fork == nullptr;
+                    }));
+}
+
 template<typename Frame>
 void DiscreteTrajectory<Frame>::WriteSubTreeToMessage(
     not_null<serialization::DiscreteTrajectory*> const message,
     std::vector<DiscreteTrajectory<Frame>*>& forks) const {
+  WriteSubTreeToMessage(message, forks, timeline_.begin());
+}
+
+template<typename Frame>
+void DiscreteTrajectory<Frame>::WriteSubTreeToMessage(
+    not_null<serialization::DiscreteTrajectory*> const message,
+    std::vector<DiscreteTrajectory<Frame>*>& forks,
+    TimelineConstIterator const timeline_begin) const {
   Forkable<DiscreteTrajectory, Iterator>::WriteSubTreeToMessage(message, forks);
-  for (auto const& pair : timeline_) {
-    Instant const& instant = pair.first;
-    DegreesOfFreedom<Frame> const& degrees_of_freedom = pair.second;
+  for (auto it = timeline_begin; it != timeline_.end(); ++it) {
+    Instant const& instant = it->first;
+    DegreesOfFreedom<Frame> const& degrees_of_freedom = it->second;
     auto const instantaneous_degrees_of_freedom = message->add_timeline();
     instant.WriteToMessage(instantaneous_degrees_of_freedom->mutable_instant());
     degrees_of_freedom.WriteToMessage(
@@ -503,6 +656,13 @@ void DiscreteTrajectory<Frame>::FillSubTreeFromMessage(
                                                                  forks);
 }
 
+template<typename Frame>
+std::uint64_t DiscreteTrajectory<Frame>::Fingerprint(
+    serialization::DiscreteTrajectory::InstantaneousDegreesOfFreedom const&
+        message) {
+  return Fingerprint2011(SerializeAsBytes(message).get());
+}
+
 template<typename Frame>
 Hermite3<Instant, Position<Frame>> DiscreteTrajectory<Frame>::GetInterpolation(
     Instant const& time) const {
@@ -550,6 +550,14 @@ TEST_F(DiscreteTrajectoryDeathTest, AppendError) {
   }, "out of order");
 }
 
+TEST_F(DiscreteTrajectoryDeathTest, AppendAtLastTimeError) {
+  EXPECT_DEATH({
+    massive_trajectory_->Append(t1_, d1_);
+    massive_trajectory_->Append(t2_, d2_);
+    massive_trajectory_->Append(t2_, d2_);
+  }, "out of order");
+}
+
 TEST_F(DiscreteTrajectoryTest, AppendAtExistingTime) {
   massive_trajectory_->Append(t1_, d1_);
   massive_trajectory_->Append(t1_, d1_);
@@ -834,6 +842,29 @@ TEST_F(DiscreteTrajectoryTest, IteratorSuccess) {
   EXPECT_TRUE(it == fork->End());
 }
 
+// The iterators, including the fork positions, remain valid when enough
+// points are appended that the storage of the timeline is reallocated.
+TEST_F(DiscreteTrajectoryTest, IteratorsAcrossAppend) {
+  massless_trajectory_->Append(t1_, d1_);
+  auto const first = massless_trajectory_->Begin();
+  not_null<DiscreteTrajectory<World>*> const fork =
+      massless_trajectory_->NewForkAtLast();
+  Instant t = t1_;
+  for (int i = 0; i < 5000; ++i) {
+    t += 1 * Second;
+    massless_trajectory_->Append(t, d2_);
+  }
+  EXPECT_EQ(5001, massless_trajectory_->Size());
+  EXPECT_EQ(t1_, first.time());
+  EXPECT_EQ(d1_, first.degrees_of_freedom());
+  EXPECT_EQ(t1_, fork->Fork().time());
+  EXPECT_EQ(d1_, fork->Fork().degrees_of_freedom());
+
+  fork->Append(t1_ + 0.5 * Second, d3_);
+  EXPECT_EQ(2, fork->Size());
+  EXPECT_EQ(t1_ + 0.5 * Second, fork->last().time());
+}
+
 TEST_F(DiscreteTrajectoryTest, QuadrilateralCircle) {
   DiscreteTrajectory<World> circle;
   AngularFrequency const ω = 3 * Radian / Second;
@@ -948,6 +979,84 @@ TEST_F(DiscreteTrajectoryTest, DownsamplingSerialization) {
   }
 }
 
+TEST_F(DiscreteTrajectoryTest, DeltaSerialization) {
+  auto circle = make_not_null_unique<DiscreteTrajectory<World>>();
+  circle->SetDownsampling(/*max_dense_intervals=*/50,
+                          /*tolerance=*/1 * Milli(Metre));
+  AngularFrequency const ω = 3 * Radian / Second;
+  Length const r = 2 * Metre;
+  Speed const v = ω * r / Radian;
+  auto const append = [&circle, r, v, ω, this](Instant const& t) {
+    circle->Append(
+        t,
+        {World::origin + Displacement<World>{{r * Cos(ω * (t - t0_)),
+                                              r * Sin(ω * (t - t0_)),
+                                              0 * Metre}},
+         Velocity<World>{{-v * Sin(ω * (t - t0_)),
+                          v * Cos(ω * (t - t0_)),
+                          0 * Metre / Second}}});
+  };
+  Instant t = t0_;
+  for (; t <= t0_ + 5 * Second; t += 10 * Milli(Second)) {
+    append(t);
+  }
+
+  // The first serialization is complete.
+  serialization::DiscreteTrajectory base;
+  auto const base1 =
+      circle->WriteDeltaToMessage(&base, /*forks=*/{}, /*base=*/std::nullopt);
+  ASSERT_TRUE(base1.has_value());
+  EXPECT_FALSE(base.has_delta());
+  EXPECT_EQ(circle->Size(), base.timeline_size());
+
+  // A delta on top of the last point of the base is empty.
+  auto const last_point_base =
+      DiscreteTrajectory<World>::LastPointDeltaBase(base);
+  EXPECT_EQ(circle->last().time(), last_point_base.last_time);
+  serialization::DiscreteTrajectory empty_delta;
+  circle->WriteDeltaToMessage(&empty_delta, /*forks=*/{}, last_point_base);
+  EXPECT_TRUE(empty_delta.has_delta());
+  EXPECT_EQ(0, empty_delta.timeline_size());
+
+  // Forget some points at the beginning, let the downsampling change the
+  // points at the end, and add a fork.  The delta only has the new points.
+  circle->ForgetBefore(t0_ + 1 * Second);
+  for (; t <= t0_ + 10 * Second; t += 10 * Milli(Second)) {
+    append(t);
+  }
+  DiscreteTrajectory<World>* fork = circle->NewForkAtLast();
+  fork->Append(t, circle->last().degrees_of_freedom());
+  serialization::DiscreteTrajectory delta;
+  auto const base2 = circle->WriteDeltaToMessage(&delta, {fork}, base1);
+  ASSERT_TRUE(base2.has_value());
+  EXPECT_TRUE(delta.has_delta());
+  EXPECT_LT(delta.timeline_size(), circle->Size());
+  EXPECT_EQ(1, delta.children_size());
+
+  // Applying the delta yields a complete serialization.
+  serialization::DiscreteTrajectory expected;
+  circle->WriteToMessage(&expected, {fork});
+  DiscreteTrajectory<World>::ApplyDelta(delta, &base);
+  EXPECT_THAT(base, EqualsProto(expected));
+  DiscreteTrajectory<World>* deserialized_fork = nullptr;
+  auto const deserialized_circle =
+      DiscreteTrajectory<World>::ReadFromMessage(base, {&deserialized_fork});
+  EXPECT_EQ(circle->Size(), deserialized_circle->Size());
+  EXPECT_EQ(fork->last().time(), deserialized_fork->last().time());
+
+  // Once the base has been forgotten, the serialization is complete again.
+  circle->DeleteFork(fork);
+  ASSERT_LT(base2->last_time, circle->last().time());
+  circle->ForgetBefore(circle->last().time());
+  delta.Clear();
+  circle->WriteDeltaToMessage(&delta, /*forks=*/{}, base2);
+  EXPECT_FALSE(delta.has_delta());
+  DiscreteTrajectory<World>::ApplyDelta(delta, &base);
+  expected.Clear();
+  circle->WriteToMessage(&expected, /*forks=*/{});
+  EXPECT_THAT(base, EqualsProto(expected));
+}
+
 TEST_F(DiscreteTrajectoryTest, DownsamplingForgetAfter) {
   DiscreteTrajectory<World> circle;
   DiscreteTrajectory<World> forgotten_circle;
@@ -1,7 +1,9 @@
 ﻿
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <future>
 #include <limits>
 #include <map>
 #include <memory>
@@ -10,6 +12,7 @@
 #include "absl/synchronization/mutex.h"
 #include "base/not_null.hpp"
 #include "base/status.hpp"
+#include "base/thread_pool.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
 #include "google/protobuf/repeated_field.h"
@@ -31,6 +34,7 @@ namespace internal_ephemeris {
 
 using base::not_null;
 using base::Status;
+using base::ThreadPool;
 using geometry::Instant;
 using geometry::Position;
 using geometry::Vector;
@@ -172,6 +176,14 @@ class Ephemeris {
   virtual not_null<ContinuousTrajectory<Frame> const*> trajectory(
       not_null<MassiveBody const*> body) const;
 
+  // Returns the positions (resp. the degrees of freedom) of all the bodies at
+  // time |t|, in the order of |bodies()|.  This is faster than evaluating the
+  // |trajectory| of each body.
+  virtual std::vector<Position<Frame>> EvaluateAllPositions(
+      Instant const& t) const EXCLUDES(lock_);
+  virtual std::vector<DegreesOfFreedom<Frame>> EvaluateAllDegreesOfFreedom(
+      Instant const& t) const EXCLUDES(lock_);
+
   // Returns true if at least one of the trajectories is empty.
   virtual bool empty() const EXCLUDES(lock_);
 
@@ -182,6 +194,7 @@ class Ephemeris {
 
   virtual FixedStepSizeIntegrator<NewtonianMotionEquation> const&
   planetary_integrator() const;
+  virtual FixedStepParameters const& fixed_step_parameters() const;
 
   virtual Status last_severe_integration_status() const;
 
@@ -191,6 +204,16 @@ class Ephemeris {
   // Prolongs the ephemeris up to at least |t|.  After the call, |t_max() >= t|.
   virtual void Prolong(Instant const& t) EXCLUDES(lock_);
 
+  // From now on, the polynomials approximating the trajectories of the massive
+  // bodies are fitted on the given |thread_pool|, one task per body, while the
+  // integrator proceeds with the next steps.  The trajectories and checkpoints
+  // are bit-for-bit identical to those of the serial computation.  If
+  // |thread_pool| is null, the fitting is done on the integrating thread.  The
+  // |thread_pool| must outlive this object, and its threads must not wait on
+  // this object, lest the integration deadlock.
+  virtual void SetFittingThreadPool(ThreadPool<Status>* thread_pool)
+      EXCLUDES(lock_);
+
   // Creates an instance suitable for integrating the given |trajectories| with
   // their |intrinsic_accelerations| using a fixed-step integrator parameterized
   // by |parameters|.
@@ -201,6 +224,19 @@ class Ephemeris {
       IntrinsicAccelerations const& intrinsic_accelerations,
       FixedStepParameters const& parameters);
 
+  // Same as above, but the gravitational accelerations on the |trajectories|
+  // are computed by splitting them in chunks that are processed concurrently on
+  // the given |thread_pool|.  The results are bit-for-bit identical to those of
+  // the serial computation.  The |thread_pool| must not be the one on which the
+  // instance is integrated, lest the integration deadlock.
+  virtual not_null<
+      std::unique_ptr<typename Integrator<NewtonianMotionEquation>::Instance>>
+  NewInstance(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      FixedStepParameters const& parameters,
+      not_null<ThreadPool<void>*> thread_pool);
+
   // Integrates, until exactly |t| (except for timeouts or singularities), the
   // |trajectory| followed by a massless body in the gravitational potential
   // described by |*this|.  If |t > t_max()|, calls |Prolong(t)| beforehand.
@@ -302,6 +338,24 @@ class Ephemeris {
       typename NewtonianMotionEquation::SystemState const& state,
       std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories);
 
+  // Records the |status| of an |Append| to the trajectory of |bodies_[index]|.
+  void RecordAppendStatus(int index, Status const& status) REQUIRES(lock_);
+
+  // Starts appending the |pending_states_| to the trajectories of the massive
+  // bodies on the |fitting_thread_pool_|, without waiting for completion.  No
+  // appending may be in progress.
+  void StartAppendingPendingStates() REQUIRES(lock_);
+  // Returns true if the appending started by |StartAppendingPendingStates|, if
+  // any, has completed.  Doesn't block.
+  bool AppendingDone() const REQUIRES_SHARED(lock_);
+  // Waits until the appending started by |StartAppendingPendingStates|, if any,
+  // has completed, and records its status.
+  void FinishAppending() REQUIRES(lock_);
+  // Appends all the states produced by the integrator to the trajectories of
+  // the massive bodies and waits for completion.  After this call, the
+  // trajectories are consistent with |instance_|.
+  void FlushPendingStates() REQUIRES(lock_);
+
   Checkpoint GetCheckpoint() REQUIRES_SHARED(lock_);
 
   // Same as t_max, but |lock_| must be held.
@@ -333,16 +387,21 @@ class Ephemeris {
       std::vector<Geopotential<Frame>> const& geopotentials);
 
   // Computes the accelerations due to one body, |body1| (with index |b1| in the
-  // |bodies_| and |trajectories_| arrays) on massless bodies at the given
-  // |positions|.  The template parameter specifies what we know about the
-  // massive body, and therefore what forces apply.  Returns false iff a
-  // collision occurred, i.e., the massless body is inside |body1|.
+  // |bodies_| and |trajectories_| arrays, located at |position1|) on massless
+  // bodies at the given |positions| (with indices [b2_begin, b2_end[ in the
+  // |positions| and |accelerations| arrays).  The template parameter specifies
+  // what we know about the massive body, and therefore what forces apply.
+  // Returns false iff a collision occurred, i.e., the massless body is inside
+  // |body1|.
   template<bool body1_is_oblate>
   bool ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
       Instant const& t,
       MassiveBody const& body1,
       std::size_t const b1,
+      Position<Frame> const& position1,
       std::vector<Position<Frame>> const& positions,
+      std::size_t const b2_begin,
+      std::size_t const b2_end,
       std::vector<Vector<Acceleration, Frame>>& accelerations) const
       REQUIRES_SHARED(lock_);
 
@@ -352,26 +411,73 @@ class Ephemeris {
       std::vector<Position<Frame>> const& positions,
       std::vector<Vector<Acceleration, Frame>>& accelerations) const;
 
+  // Computes the acceleration exerted by the massive bodies in |bodies_|, which
+  // are at |body_positions|, on the massless bodies with indices
+  // [b2_begin, b2_end[ in the |positions| and |accelerations| arrays.  The
+  // |accelerations| in that range must have been zeroed.  Returns false iff a
+  // collision occurred.
+  bool ComputeMasslessBodiesGravitationalAccelerations(
+      Instant const& t,
+      std::vector<Position<Frame>> const& body_positions,
+      std::vector<Position<Frame>> const& positions,
+      std::size_t const b2_begin,
+      std::size_t const b2_end,
+      std::vector<Vector<Acceleration, Frame>>& accelerations) const
+      REQUIRES_SHARED(lock_);
+
   // Computes the acceleration exerted by the massive bodies in |bodies_| on
   // massless bodies.  The massless bodies are at the given |positions|.
   // Returns false iff a collision occurred, i.e., the massless body is inside
-  // one of the |bodies_|.
+  // one of the |bodies_|.  If |thread_pool| is not null, the massless bodies
+  // are processed in chunks of |massless_bodies_per_chunk| on that pool.
   bool ComputeMasslessBodiesGravitationalAccelerations(
       Instant const& t,
       std::vector<Position<Frame>> const& positions,
-      std::vector<Vector<Acceleration, Frame>>& accelerations) const
+      std::vector<Vector<Acceleration, Frame>>& accelerations,
+      ThreadPool<void>* thread_pool) const
       EXCLUDES(lock_);
 
+  // The implementation of the public |NewInstance| functions.  |thread_pool|
+  // may be null.
+  not_null<
+      std::unique_ptr<typename Integrator<NewtonianMotionEquation>::Instance>>
+  NewInstanceWithThreadPool(
+      std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+      IntrinsicAccelerations const& intrinsic_accelerations,
+      FixedStepParameters const& parameters,
+      ThreadPool<void>* thread_pool);
+
   // Flows the given ODE with an adaptive step integrator.
-  template<typename ODE>
+  template<typename ODE, typename ComputeAcceleration>
   Status FlowODEWithAdaptiveStep(
-      typename ODE::RightHandSideComputation compute_acceleration,
+      ComputeAcceleration const& compute_acceleration,
       not_null<DiscreteTrajectory<Frame>*> trajectory,
       Instant const& t,
       ODEAdaptiveStepParameters<ODE> const& parameters,
       std::int64_t max_ephemeris_steps,
       bool last_point_only);
 
+  // Returns an instance of |integrator| for |problem| with the right-hand side
+  // |compute_acceleration|.  If |integrator| is the only adaptive integrator
+  // that may be deserialized for the |NewtonianMotionEquation|, the
+  // right-hand side is passed with its type so that its calls may be inlined.
+  // Otherwise it goes through the |std::function| of the equation.
+  template<typename ODE, typename ComputeAcceleration>
+  static not_null<std::unique_ptr<typename Integrator<ODE>::Instance>>
+  NewAdaptiveStepInstance(
+      AdaptiveStepSizeIntegrator<ODE> const& integrator,
+      IntegrationProblem<ODE> problem,
+      ComputeAcceleration const& compute_acceleration,
+      typename AdaptiveStepSizeIntegrator<ODE>::AppendState const&
+          append_state,
+      typename AdaptiveStepSizeIntegrator<ODE>::ToleranceToErrorRatio const&
+          tolerance_to_error_ratio,
+      typename AdaptiveStepSizeIntegrator<ODE>::Parameters const& parameters);
+
+  // Stores |polynomial_index| in the |polynomial_index_hint_| for the next
+  // evaluation of all the trajectories.
+  void UpdatePolynomialIndexHint(int polynomial_index) const;
+
   // Computes an estimate of the ratio |tolerance / error|.
   static double ToleranceToErrorRatio(
       Length const& length_integration_tolerance,
@@ -400,6 +506,11 @@ class Ephemeris {
   // The indices in |bodies_| correspond to those in |trajectories_|.
   std::vector<not_null<ContinuousTrajectory<Frame>*>> trajectories_;
 
+  // The index of the polynomial last used when evaluating all the
+  // |trajectories_|, a hint for the next evaluation.  It is read and written by
+  // threads that hold |lock_| shared, hence atomic.  Any value is correct.
+  mutable std::atomic_int polynomial_index_hint_ = 0;
+
   std::map<not_null<MassiveBody const*>,
            not_null<std::unique_ptr<ContinuousTrajectory<Frame>>>>
       bodies_to_trajectories_;
@@ -416,6 +527,17 @@ class Ephemeris {
   int number_of_oblate_bodies_ = 0;
   int number_of_spherical_bodies_ = 0;
 
+  // If not null, the polynomials of the massive bodies are fitted on this pool.
+  ThreadPool<Status>* fitting_thread_pool_ = nullptr;
+  // The states produced by the integrator that have not been appended to the
+  // trajectories yet.  Only used if |fitting_thread_pool_| is not null.
+  std::vector<typename NewtonianMotionEquation::SystemState> pending_states_;
+  // The states being appended to the trajectories on the
+  // |fitting_thread_pool_|, and the futures of the tasks, one per body, that
+  // append them.  The tasks only read |appending_states_|.
+  std::vector<typename NewtonianMotionEquation::SystemState> appending_states_;
+  std::vector<std::future<Status>> appending_futures_;
+
   Status last_severe_integration_status_;
 };
 
@@ -4,10 +4,13 @@
 #include "physics/ephemeris.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
+#include <future>
 #include <limits>
 #include <optional>
 #include <set>
+#include <type_traits>
 #include <vector>
 
 #include "astronomy/epoch.hpp"
@@ -19,6 +22,7 @@
 #include "integrators/integrators.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
 #include "numerics/hermite3.hpp"
+#include "numerics/inverse_square_kernels.hpp"
 #include "physics/continuous_trajectory.hpp"
 #include "quantities/elementary_functions.hpp"
 #include "quantities/named_quantities.hpp"
@@ -42,10 +46,15 @@ using geometry::R3Element;
 using geometry::Sign;
 using geometry::Velocity;
 using integrators::EmbeddedExplicitGeneralizedRungeKuttaNyströmIntegrator;
+using integrators::EmbeddedExplicitRungeKuttaNyströmIntegrator;
 using integrators::ExplicitSecondOrderOrdinaryDifferentialEquation;
 using integrators::Integrator;
 using integrators::IntegrationProblem;
+using integrators::methods::DormandالمكاوىPrince1986RKN434FM;
 using integrators::methods::Fine1987RKNG34;
+using numerics::AddAccelerationsBySource;
+using numerics::AddMutualAccelerations;
+using numerics::BestKernelInstructionSet;
 using numerics::Bisect;
 using numerics::DoublePrecision;
 using numerics::Hermite3;
@@ -53,6 +62,7 @@ using quantities::Abs;
 using quantities::Exponentiation;
 using quantities::GravitationalParameter;
 using quantities::Quotient;
+using quantities::SIUnit;
 using quantities::Sqrt;
 using quantities::Square;
 using quantities::Time;
@@ -68,6 +78,13 @@ using ::std::placeholders::_3;
 constexpr Length pre_ἐρατοσθένης_default_ephemeris_fitting_tolerance =
     1 * Milli(Metre);
 constexpr Time max_time_between_checkpoints = 180 * Day;
+// The number of massless bodies processed by each task when computing the
+// accelerations on a thread pool.  Smaller chunks are not worth the
+// synchronization overhead.
+constexpr std::size_t massless_bodies_per_chunk = 16;
+// Below this number of massless bodies, packing them in a structure of arrays
+// for the vectorized kernels costs more than it saves.
+constexpr std::size_t min_massless_bodies_for_kernels = 4;
 
 template<typename Frame>
 template<typename ODE>
@@ -306,6 +323,51 @@ not_null<ContinuousTrajectory<Frame> const*> Ephemeris<Frame>::trajectory(
   return FindOrDie(bodies_to_trajectories_, body).get();
 }
 
+template<typename Frame>
+std::vector<Position<Frame>> Ephemeris<Frame>::EvaluateAllPositions(
+    Instant const& t) const {
+  std::vector<Position<Frame>> positions;
+  {
+    absl::ReaderMutexLock l(&lock_);
+    int polynomial_index = polynomial_index_hint_;
+    ContinuousTrajectory<Frame>::EvaluateAllPositions(trajectories_,
+                                                      t,
+                                                      polynomial_index,
+                                                      positions);
+    UpdatePolynomialIndexHint(polynomial_index);
+  }
+  // Reorder the positions to match |unowned_bodies_|.
+  std::vector<Position<Frame>> unowned_positions(positions.size());
+  for (int b = 0; b < bodies_.size(); ++b) {
+    unowned_positions[FindOrDie(unowned_bodies_indices_, bodies_[b].get())] =
+        positions[b];
+  }
+  return unowned_positions;
+}
+
+template<typename Frame>
+std::vector<DegreesOfFreedom<Frame>>
+Ephemeris<Frame>::EvaluateAllDegreesOfFreedom(Instant const& t) const {
+  std::vector<DegreesOfFreedom<Frame>> degrees_of_freedom;
+  {
+    absl::ReaderMutexLock l(&lock_);
+    int polynomial_index = polynomial_index_hint_;
+    ContinuousTrajectory<Frame>::EvaluateAllDegreesOfFreedom(
+        trajectories_, t, polynomial_index, degrees_of_freedom);
+    UpdatePolynomialIndexHint(polynomial_index);
+  }
+  // Reorder the degrees of freedom to match |unowned_bodies_|.
+  std::vector<DegreesOfFreedom<Frame>> unowned_degrees_of_freedom(
+      degrees_of_freedom.size(),
+      DegreesOfFreedom<Frame>(Position<Frame>(), Velocity<Frame>()));
+  for (int b = 0; b < bodies_.size(); ++b) {
+    unowned_degrees_of_freedom[FindOrDie(unowned_bodies_indices_,
+                                         bodies_[b].get())] =
+        degrees_of_freedom[b];
+  }
+  return unowned_degrees_of_freedom;
+}
+
 template<typename Frame>
 bool Ephemeris<Frame>::empty() const {
   absl::ReaderMutexLock l(&lock_);
@@ -344,6 +406,12 @@ Ephemeris<Frame>::planetary_integrator() const {
   return *fixed_step_parameters_.integrator_;
 }
 
+template<typename Frame>
+typename Ephemeris<Frame>::FixedStepParameters const&
+Ephemeris<Frame>::fixed_step_parameters() const {
+  return fixed_step_parameters_;
+}
+
 template<typename Frame>
 Status Ephemeris<Frame>::last_severe_integration_status() const {
   return last_severe_integration_status_;
@@ -396,10 +464,20 @@ void Ephemeris<Frame>::Prolong(Instant const& t) {
   absl::MutexLock l(&lock_);
   while (t_max_locked() < t) {
     instance_->Solve(t_final);
+    // The trajectories must be up-to-date before we look at |t_max_locked()|.
+    FlushPendingStates();
     t_final += fixed_step_parameters_.step_;
   }
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::SetFittingThreadPool(
+    ThreadPool<Status>* const thread_pool) {
+  absl::MutexLock l(&lock_);
+  FlushPendingStates();
+  fitting_thread_pool_ = thread_pool;
+}
+
 template<typename Frame>
 not_null<std::unique_ptr<typename Integrator<
     typename Ephemeris<Frame>::NewtonianMotionEquation>::Instance>>
@@ -407,15 +485,45 @@ Ephemeris<Frame>::NewInstance(
     std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
     IntrinsicAccelerations const& intrinsic_accelerations,
     FixedStepParameters const& parameters) {
+  return NewInstanceWithThreadPool(trajectories,
+                                   intrinsic_accelerations,
+                                   parameters,
+                                   /*thread_pool=*/nullptr);
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<typename Integrator<
+    typename Ephemeris<Frame>::NewtonianMotionEquation>::Instance>>
+Ephemeris<Frame>::NewInstance(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    FixedStepParameters const& parameters,
+    not_null<ThreadPool<void>*> const thread_pool) {
+  return NewInstanceWithThreadPool(trajectories,
+                                   intrinsic_accelerations,
+                                   parameters,
+                                   thread_pool);
+}
+
+template<typename Frame>
+not_null<std::unique_ptr<typename Integrator<
+    typename Ephemeris<Frame>::NewtonianMotionEquation>::Instance>>
+Ephemeris<Frame>::NewInstanceWithThreadPool(
+    std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+    IntrinsicAccelerations const& intrinsic_accelerations,
+    FixedStepParameters const& parameters,
+    ThreadPool<void>* const thread_pool) {
   IntegrationProblem<NewtonianMotionEquation> problem;
 
-  problem.equation.compute_acceleration = [this, intrinsic_accelerations](
-      Instant const& t,
-      std::vector<Position<Frame>> const& positions,
-      std::vector<Vector<Acceleration, Frame>>& accelerations) {
+  problem.equation.compute_acceleration =
+      [this, intrinsic_accelerations, thread_pool](
+          Instant const& t,
+          std::vector<Position<Frame>> const& positions,
+          std::vector<Vector<Acceleration, Frame>>& accelerations) {
     if (ComputeMasslessBodiesGravitationalAccelerations(t,
                                                         positions,
-                                                        accelerations)) {
+                                                        accelerations,
+                                                        thread_pool)) {
       // Add the intrinsic accelerations.
       for (int i = 0; i < intrinsic_accelerations.size(); ++i) {
         auto const intrinsic_acceleration = intrinsic_accelerations[i];
@@ -465,9 +573,11 @@ Status Ephemeris<Frame>::FlowWithAdaptiveStep(
       Instant const& t,
       std::vector<Position<Frame>> const& positions,
       std::vector<Vector<Acceleration, Frame>>& accelerations) {
-    if (ComputeMasslessBodiesGravitationalAccelerations(t,
-                                                        positions,
-                                                        accelerations)) {
+    if (ComputeMasslessBodiesGravitationalAccelerations(
+            t,
+            positions,
+            accelerations,
+            /*thread_pool=*/nullptr)) {
       if (intrinsic_acceleration != nullptr) {
         accelerations[0] += intrinsic_acceleration(t);
       }
@@ -478,7 +588,7 @@ Status Ephemeris<Frame>::FlowWithAdaptiveStep(
   };
 
   return FlowODEWithAdaptiveStep<NewtonianMotionEquation>(
-             std::move(compute_acceleration),
+             compute_acceleration,
              trajectory,
              t,
              parameters,
@@ -500,9 +610,11 @@ Status Ephemeris<Frame>::FlowWithAdaptiveStep(
           std::vector<Position<Frame>> const& positions,
           std::vector<Velocity<Frame>> const& velocities,
           std::vector<Vector<Acceleration, Frame>>& accelerations) {
-        if (ComputeMasslessBodiesGravitationalAccelerations(t,
-                                                            positions,
-                                                            accelerations)) {
+        if (ComputeMasslessBodiesGravitationalAccelerations(
+                t,
+                positions,
+                accelerations,
+                /*thread_pool=*/nullptr)) {
           accelerations[0] +=
               intrinsic_acceleration(t, {positions[0], velocities[0]});
           return Status::OK;
@@ -512,7 +624,7 @@ Status Ephemeris<Frame>::FlowWithAdaptiveStep(
       };
 
   return FlowODEWithAdaptiveStep<GeneralizedNewtonianMotionEquation>(
-             std::move(compute_acceleration),
+             compute_acceleration,
              trajectory,
              t,
              parameters,
@@ -537,7 +649,10 @@ ComputeGravitationalAccelerationOnMasslessBody(
     Position<Frame> const& position,
     Instant const& t) const {
   std::vector<Vector<Acceleration, Frame>> accelerations(1);
-  ComputeMasslessBodiesGravitationalAccelerations(t, {position}, accelerations);
+  ComputeMasslessBodiesGravitationalAccelerations(t,
+                                                  {position},
+                                                  accelerations,
+                                                  /*thread_pool=*/nullptr);
 
   return accelerations[0];
 }
@@ -565,17 +680,19 @@ ComputeGravitationalAccelerationOnMassiveBody(
   int b1 = -1;
 
   // Evaluate the |positions|.
-  positions.reserve(bodies_.size());
   for (int b = 0; b < bodies_.size(); ++b) {
-    auto const& current_body = bodies_[b];
-    auto const& current_body_trajectory = trajectories_[b];
-    if (current_body.get() == body) {
+    if (bodies_[b].get() == body) {
       CHECK_EQ(-1, b1);
       b1 = b;
     }
-    positions.push_back(current_body_trajectory->EvaluatePosition(t));
   }
   CHECK_LE(0, b1);
+  int polynomial_index = polynomial_index_hint_;
+  ContinuousTrajectory<Frame>::EvaluateAllPositions(trajectories_,
+                                                    t,
+                                                    polynomial_index,
+                                                    positions);
+  UpdatePolynomialIndexHint(polynomial_index);
 
   if (body_is_oblate) {
     ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
@@ -824,24 +941,26 @@ Ephemeris<Frame>::Ephemeris(
 template<typename Frame>
 void Ephemeris<Frame>::AppendMassiveBodiesState(
     typename NewtonianMotionEquation::SystemState const& state) {
-  int index = 0;
-  for (int i = 0; i < trajectories_.size(); ++i) {
-    auto const& trajectory = trajectories_[i];
-    auto const status = trajectory->Append(
-        state.time.value,
-        DegreesOfFreedom<Frame>(state.positions[index].value,
-                                state.velocities[index].value));
-
-    // Handle the apocalypse.
-    if (!status.ok()) {
-      last_severe_integration_status_ =
-          Status(status.error(),
-                 "Error extending trajectory for " + bodies_[i]->name() + ". " +
-                     status.message());
-      LOG(ERROR) << "New Apocalypse: " << last_severe_integration_status_;
+  if (fitting_thread_pool_ == nullptr) {
+    int index = 0;
+    for (int i = 0; i < trajectories_.size(); ++i) {
+      auto const& trajectory = trajectories_[i];
+      RecordAppendStatus(
+          i,
+          trajectory->Append(
+              state.time.value,
+              DegreesOfFreedom<Frame>(state.positions[index].value,
+                                      state.velocities[index].value)));
+      ++index;
+    }
+  } else {
+    // Let the integrator proceed while the fitting is in progress; the states
+    // produced in the meantime are appended in the next batch.
+    pending_states_.push_back(state);
+    if (AppendingDone()) {
+      FinishAppending();
+      StartAppendingPendingStates();
     }
-
-    ++index;
   }
 
   // Record an intermediate state if we haven't done so for too long.
@@ -850,6 +969,17 @@ void Ephemeris<Frame>::AppendMassiveBodiesState(
       checkpoints_.empty()
           ? astronomy::InfinitePast
           : checkpoints_.back().instance->time().value;
+  if (fitting_thread_pool_ != nullptr) {
+    // Since |t_max_locked()| is at most the time of the last state, there is
+    // nothing to do if that time is close enough to the last checkpoint.
+    // Otherwise, the trajectories must be consistent with |instance_| to
+    // compute |t_max_locked()| and to take a checkpoint.
+    if (state.time.value - t_last_intermediate_state <=
+        max_time_between_checkpoints) {
+      return;
+    }
+    FlushPendingStates();
+  }
   if (t_max_locked() - t_last_intermediate_state >
       max_time_between_checkpoints) {
     checkpoints_.push_back(GetCheckpoint());
@@ -870,6 +1000,71 @@ void Ephemeris<Frame>::AppendMasslessBodiesState(
   }
 }
 
+template<typename Frame>
+void Ephemeris<Frame>::RecordAppendStatus(int const index,
+                                          Status const& status) {
+  // Handle the apocalypse.
+  if (!status.ok()) {
+    last_severe_integration_status_ =
+        Status(status.error(),
+               "Error extending trajectory for " + bodies_[index]->name() +
+                   ". " + status.message());
+    LOG(ERROR) << "New Apocalypse: " << last_severe_integration_status_;
+  }
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::StartAppendingPendingStates() {
+  CHECK(appending_futures_.empty());
+  if (pending_states_.empty()) {
+    return;
+  }
+  appending_states_.swap(pending_states_);
+  pending_states_.clear();
+  for (int i = 0; i < trajectories_.size(); ++i) {
+    appending_futures_.push_back(fitting_thread_pool_->Add([this, i]() {
+      // The states must be appended in order, so they are all appended by the
+      // same task.
+      Status status;
+      for (auto const& state : appending_states_) {
+        Status const append_status = trajectories_[i]->Append(
+            state.time.value,
+            DegreesOfFreedom<Frame>(state.positions[i].value,
+                                    state.velocities[i].value));
+        if (!append_status.ok()) {
+          status = append_status;
+        }
+      }
+      return status;
+    }));
+  }
+}
+
+template<typename Frame>
+bool Ephemeris<Frame>::AppendingDone() const {
+  return std::all_of(appending_futures_.begin(),
+                     appending_futures_.end(),
+                     [](std::future<Status> const& future) {
+                       return future.wait_for(std::chrono::seconds(0)) ==
+                              std::future_status::ready;
+                     });
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FinishAppending() {
+  for (int i = 0; i < appending_futures_.size(); ++i) {
+    RecordAppendStatus(i, appending_futures_[i].get());
+  }
+  appending_futures_.clear();
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::FlushPendingStates() {
+  FinishAppending();
+  StartAppendingPendingStates();
+  FinishAppending();
+}
+
 template<typename Frame>
 typename Ephemeris<Frame>::Checkpoint Ephemeris<Frame>::GetCheckpoint() {
   std::vector<typename ContinuousTrajectory<Frame>::Checkpoint> checkpoints;
@@ -974,14 +1169,16 @@ ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies(
     Instant const& t,
     MassiveBody const& body1,
     std::size_t const b1,
+    Position<Frame> const& position1,
     std::vector<Position<Frame>> const& positions,
+    std::size_t const b2_begin,
+    std::size_t const b2_end,
     std::vector<Vector<Acceleration, Frame>>& accelerations) const {
   GravitationalParameter const& μ1 = body1.gravitational_parameter();
-  Position<Frame> const position1 = trajectories_[b1]->EvaluatePosition(t);
   Length const body1_mean_radius = body1.mean_radius();
   bool ok = true;
 
-  for (std::size_t b2 = 0; b2 < positions.size(); ++b2) {
+  for (std::size_t b2 = b2_begin; b2 < b2_end; ++b2) {
     // A vector from the center of |b2| to the center of |b1|.
     Displacement<Frame> const Δq = position1 - positions[b2];
 
@@ -1038,61 +1235,212 @@ void Ephemeris<Frame>::ComputeMassiveBodiesGravitationalAccelerations(
         /*b2_end=*/number_of_oblate_bodies_ + number_of_spherical_bodies_,
         positions, accelerations, geopotentials_);
   }
-  for (std::size_t b1 = number_of_oblate_bodies_;
-       b1 < number_of_oblate_bodies_ +
-            number_of_spherical_bodies_;
-       ++b1) {
-    MassiveBody const& body1 = *bodies_[b1];
-    ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies<
-        /*body1_is_oblate=*/false,
-        /*body2_is_oblate=*/false>(
-        t,
-        body1, b1,
-        /*bodies2=*/bodies_,
-        /*b2_begin=*/b1 + 1,
-        /*b2_end=*/number_of_oblate_bodies_ + number_of_spherical_bodies_,
-        positions, accelerations, geopotentials_);
+  // The accelerations between spherical bodies are computed by a vectorized
+  // kernel on a structure of arrays.  This gives the same results as
+  // |ComputeGravitationalAccelerationByMassiveBodyOnMassiveBodies|.
+  // The arrays are reused from one evaluation to the next to avoid an
+  // allocation in the integration loop.
+  std::size_t const number_of_spherical_bodies = number_of_spherical_bodies_;
+  thread_local std::vector<double> soa;
+  soa.resize(7 * number_of_spherical_bodies);
+  double* const x = soa.data();
+  double* const y = x + number_of_spherical_bodies;
+  double* const z = y + number_of_spherical_bodies;
+  double* const μ = z + number_of_spherical_bodies;
+  double* const ax = μ + number_of_spherical_bodies;
+  double* const ay = ax + number_of_spherical_bodies;
+  double* const az = ay + number_of_spherical_bodies;
+  for (std::size_t i = 0; i < number_of_spherical_bodies; ++i) {
+    std::size_t const b = number_of_oblate_bodies_ + i;
+    auto const q = (positions[b] - Frame::origin).coordinates();
+    auto const a = accelerations[b].coordinates();
+    x[i] = q.x / SIUnit<Length>();
+    y[i] = q.y / SIUnit<Length>();
+    z[i] = q.z / SIUnit<Length>();
+    μ[i] = bodies_[b]->gravitational_parameter() /
+           SIUnit<GravitationalParameter>();
+    ax[i] = a.x / SIUnit<Acceleration>();
+    ay[i] = a.y / SIUnit<Acceleration>();
+    az[i] = a.z / SIUnit<Acceleration>();
+  }
+  auto const instruction_set = BestKernelInstructionSet();
+  for (std::size_t i1 = 0; i1 < number_of_spherical_bodies; ++i1) {
+    std::size_t const i2 = i1 + 1;
+    AddMutualAccelerations(instruction_set,
+                           x[i1], y[i1], z[i1],
+                           μ[i1],
+                           ax[i1], ay[i1], az[i1],
+                           /*size=*/number_of_spherical_bodies - i2,
+                           x + i2, y + i2, z + i2,
+                           μ + i2,
+                           ax + i2, ay + i2, az + i2);
+  }
+  for (std::size_t i = 0; i < number_of_spherical_bodies; ++i) {
+    accelerations[number_of_oblate_bodies_ + i] = Vector<Acceleration, Frame>(
+        {ax[i] * SIUnit<Acceleration>(),
+         ay[i] * SIUnit<Acceleration>(),
+         az[i] * SIUnit<Acceleration>()});
   }
 }
 
+
 template<typename Frame>
 bool Ephemeris<Frame>::ComputeMasslessBodiesGravitationalAccelerations(
       Instant const& t,
+      std::vector<Position<Frame>> const& body_positions,
       std::vector<Position<Frame>> const& positions,
+      std::size_t const b2_begin,
+      std::size_t const b2_end,
       std::vector<Vector<Acceleration, Frame>>& accelerations) const {
-  CHECK_EQ(positions.size(), accelerations.size());
-  accelerations.assign(accelerations.size(), Vector<Acceleration, Frame>());
   bool ok = true;
-
-  absl::ReaderMutexLock l(&lock_);
   for (std::size_t b1 = 0; b1 < number_of_oblate_bodies_; ++b1) {
     MassiveBody const& body1 = *bodies_[b1];
     ok &= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
         /*body1_is_oblate=*/true>(
         t,
-        body1, b1,
-        positions,
+        body1, b1, body_positions[b1],
+        positions, b2_begin, b2_end,
         accelerations);
   }
+  if (b2_end - b2_begin < min_massless_bodies_for_kernels) {
+    for (std::size_t b1 = number_of_oblate_bodies_;
+         b1 < number_of_oblate_bodies_ +
+              number_of_spherical_bodies_;
+         ++b1) {
+      MassiveBody const& body1 = *bodies_[b1];
+      ok &= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
+          /*body1_is_oblate=*/false>(
+          t,
+          body1, b1, body_positions[b1],
+          positions, b2_begin, b2_end,
+          accelerations);
+    }
+    return ok;
+  }
+
+  // The accelerations due to spherical bodies are computed by a vectorized
+  // kernel on a structure of arrays.  This gives the same results as
+  // |ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies|.
+  // The arrays are reused from one evaluation to the next, on each thread, to
+  // avoid an allocation in the integration loop.
+  std::size_t const size = b2_end - b2_begin;
+  thread_local std::vector<double> soa;
+  soa.resize(6 * size);
+  double* const x = soa.data();
+  double* const y = x + size;
+  double* const z = y + size;
+  double* const ax = z + size;
+  double* const ay = ax + size;
+  double* const az = ay + size;
+  for (std::size_t i = 0; i < size; ++i) {
+    auto const q = (positions[b2_begin + i] - Frame::origin).coordinates();
+    auto const a = accelerations[b2_begin + i].coordinates();
+    x[i] = q.x / SIUnit<Length>();
+    y[i] = q.y / SIUnit<Length>();
+    z[i] = q.z / SIUnit<Length>();
+    ax[i] = a.x / SIUnit<Acceleration>();
+    ay[i] = a.y / SIUnit<Acceleration>();
+    az[i] = a.z / SIUnit<Acceleration>();
+  }
+  auto const instruction_set = BestKernelInstructionSet();
   for (std::size_t b1 = number_of_oblate_bodies_;
        b1 < number_of_oblate_bodies_ +
             number_of_spherical_bodies_;
        ++b1) {
     MassiveBody const& body1 = *bodies_[b1];
-    ok &= ComputeGravitationalAccelerationByMassiveBodyOnMasslessBodies<
-        /*body1_is_oblate=*/false>(
+    auto const q1 = (body_positions[b1] - Frame::origin).coordinates();
+    ok &= AddAccelerationsBySource(
+        instruction_set,
+        q1.x / SIUnit<Length>(),
+        q1.y / SIUnit<Length>(),
+        q1.z / SIUnit<Length>(),
+        body1.gravitational_parameter() / SIUnit<GravitationalParameter>(),
+        body1.mean_radius() / SIUnit<Length>(),
+        size,
+        x, y, z,
+        ax, ay, az);
+  }
+  for (std::size_t i = 0; i < size; ++i) {
+    accelerations[b2_begin + i] = Vector<Acceleration, Frame>(
+        {ax[i] * SIUnit<Acceleration>(),
+         ay[i] * SIUnit<Acceleration>(),
+         az[i] * SIUnit<Acceleration>()});
+  }
+  return ok;
+}
+
+template<typename Frame>
+bool Ephemeris<Frame>::ComputeMasslessBodiesGravitationalAccelerations(
+      Instant const& t,
+      std::vector<Position<Frame>> const& positions,
+      std::vector<Vector<Acceleration, Frame>>& accelerations,
+      ThreadPool<void>* const thread_pool) const {
+  CHECK_EQ(positions.size(), accelerations.size());
+  accelerations.assign(accelerations.size(), Vector<Acceleration, Frame>());
+
+  absl::ReaderMutexLock l(&lock_);
+
+  // Evaluate the positions of the massive bodies once, they are shared by all
+  // the chunks.
+  std::vector<Position<Frame>> body_positions;
+  int polynomial_index = polynomial_index_hint_;
+  ContinuousTrajectory<Frame>::EvaluateAllPositions(trajectories_,
+                                                    t,
+                                                    polynomial_index,
+                                                    body_positions);
+  UpdatePolynomialIndexHint(polynomial_index);
+
+  if (thread_pool == nullptr ||
+      positions.size() <= massless_bodies_per_chunk) {
+    return ComputeMasslessBodiesGravitationalAccelerations(
         t,
-        body1, b1,
+        body_positions,
         positions,
+        /*b2_begin=*/0,
+        /*b2_end=*/positions.size(),
         accelerations);
   }
+
+  // Each chunk writes to a disjoint range of |accelerations| and accumulates
+  // the contributions of the massive bodies in the same order as the serial
+  // computation, so the results are bit-for-bit identical.  The tasks don't
+  // take |lock_|: it is held in shared mode by this thread until they have all
+  // completed.
+  std::size_t const number_of_chunks =
+      (positions.size() + massless_bodies_per_chunk - 1) /
+      massless_bodies_per_chunk;
+  std::vector<std::uint8_t> chunk_ok(number_of_chunks);
+  std::vector<std::future<void>> futures;
+  futures.reserve(number_of_chunks);
+  for (std::size_t chunk = 0; chunk < number_of_chunks; ++chunk) {
+    std::size_t const b2_begin = chunk * massless_bodies_per_chunk;
+    std::size_t const b2_end =
+        std::min(b2_begin + massless_bodies_per_chunk, positions.size());
+    futures.push_back(thread_pool->Add(
+        [this, &t, &body_positions, &positions, &accelerations, &chunk_ok,
+         chunk, b2_begin, b2_end]() {
+          chunk_ok[chunk] = ComputeMasslessBodiesGravitationalAccelerations(
+                                t,
+                                body_positions,
+                                positions,
+                                b2_begin,
+                                b2_end,
+                                accelerations);
+        }));
+  }
+
+  bool ok = true;
+  for (std::size_t chunk = 0; chunk < number_of_chunks; ++chunk) {
+    futures[chunk].wait();
+    ok &= static_cast<bool>(chunk_ok[chunk]);
+  }
   return ok;
 }
 
 template<typename Frame>
-template<typename ODE>
+template<typename ODE, typename ComputeAcceleration>
 Status Ephemeris<Frame>::FlowODEWithAdaptiveStep(
-      typename ODE::RightHandSideComputation compute_acceleration,
+      ComputeAcceleration const& compute_acceleration,
       not_null<DiscreteTrajectory<Frame>*> trajectory,
       Instant const& t,
       ODEAdaptiveStepParameters<ODE> const& parameters,
@@ -1117,8 +1465,6 @@ Status Ephemeris<Frame>::FlowODEWithAdaptiveStep(
   Prolong(t_final);
 
   IntegrationProblem<ODE> problem;
-  problem.equation.compute_acceleration = std::move(compute_acceleration);
-
   auto const trajectory_last = trajectory->last();
   auto const last_degrees_of_freedom = trajectory_last.degrees_of_freedom();
   problem.initial_state = {{last_degrees_of_freedom.position()},
@@ -1151,11 +1497,12 @@ Status Ephemeris<Frame>::FlowODEWithAdaptiveStep(
         &Ephemeris::AppendMasslessBodiesState, _1, std::cref(trajectories));
   }
 
-  auto const instance =
-      parameters.integrator_->NewInstance(problem,
-                                          append_state,
-                                          tolerance_to_error_ratio,
-                                          integrator_parameters);
+  auto const instance = NewAdaptiveStepInstance(*parameters.integrator_,
+                                                problem,
+                                                compute_acceleration,
+                                                append_state,
+                                                tolerance_to_error_ratio,
+                                                integrator_parameters);
   auto status = instance->Solve(t_final);
 
   // We probably don't care if the vessel gets too close to the singularity, as
@@ -1183,6 +1530,48 @@ Status Ephemeris<Frame>::FlowODEWithAdaptiveStep(
   }
 }
 
+template<typename Frame>
+template<typename ODE, typename ComputeAcceleration>
+not_null<std::unique_ptr<typename Integrator<ODE>::Instance>>
+Ephemeris<Frame>::NewAdaptiveStepInstance(
+    AdaptiveStepSizeIntegrator<ODE> const& integrator,
+    IntegrationProblem<ODE> problem,
+    ComputeAcceleration const& compute_acceleration,
+    typename AdaptiveStepSizeIntegrator<ODE>::AppendState const& append_state,
+    typename AdaptiveStepSizeIntegrator<ODE>::ToleranceToErrorRatio const&
+        tolerance_to_error_ratio,
+    typename AdaptiveStepSizeIntegrator<ODE>::Parameters const& parameters) {
+  if constexpr (std::is_same_v<ODE, NewtonianMotionEquation>) {
+    // The deserialized integrators are the ones returned by this function, so
+    // comparing the addresses is enough to identify the concrete type.
+    auto const& typed_integrator = EmbeddedExplicitRungeKuttaNyströmIntegrator<
+        DormandالمكاوىPrince1986RKN434FM,
+        Position<Frame>>();
+    if (&integrator == &typed_integrator) {
+      return typed_integrator.NewInstance(problem,
+                                          compute_acceleration,
+                                          append_state,
+                                          tolerance_to_error_ratio,
+                                          parameters);
+    }
+  }
+  problem.equation.compute_acceleration = compute_acceleration;
+  return integrator.NewInstance(problem,
+                                append_state,
+                                tolerance_to_error_ratio,
+                                parameters);
+}
+
+template<typename Frame>
+void Ephemeris<Frame>::UpdatePolynomialIndexHint(
+    int const polynomial_index) const {
+  // Only write the atomic if it changes, to avoid contention between the
+  // threads that evaluate the trajectories at nearby times.
+  if (polynomial_index_hint_ != polynomial_index) {
+    polynomial_index_hint_ = polynomial_index;
+  }
+}
+
 template<typename Frame>
 double Ephemeris<Frame>::ToleranceToErrorRatio(
     Length const& length_integration_tolerance,
@@ -0,0 +1,131 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+#include "base/array.hpp"
+#include "base/mapped_file.hpp"
+#include "base/not_null.hpp"
+#include "base/status.hpp"
+#include "geometry/named_quantities.hpp"
+#include "physics/ephemeris.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_ephemeris_cache {
+
+using base::Array;
+using base::MappedFile;
+using base::not_null;
+using base::Status;
+using geometry::Instant;
+using geometry::Position;
+using geometry::Velocity;
+
+// An on-disk cache of the polynomials fitted to the trajectories of the massive
+// bodies of an ephemeris.  The cache is a versioned binary file which is
+// memory-mapped for reading: opening it only validates its header and its
+// tables, it doesn't parse anything, and the pages that hold the coefficients
+// of the polynomials are only read when these polynomials are evaluated.  The
+// cache is tagged with a |fingerprint|, typically that of the gravity model,
+// and it is rejected if that fingerprint doesn't match.
+template<typename Frame>
+class EphemerisCache final {
+ public:
+  // Writes the polynomials of the trajectories of all the bodies of
+  // |ephemeris|, in the order of |bodies()|, to the file at |path|.  The file
+  // is replaced atomically.
+  static Status Write(Ephemeris<Frame> const& ephemeris,
+                      std::uint64_t fingerprint,
+                      std::filesystem::path const& path);
+
+  // Maps the cache at |path|, validates its header and all its tables, and
+  // stores it in |cache|.  Returns |NOT_FOUND| if the file doesn't exist, if it
+  // was written with a fingerprint other than |fingerprint|, or if it is
+  // truncated or corrupted.  In the last two cases the file is deleted, so that
+  // the caller may rebuild it with |Write|.
+  static Status Open(std::filesystem::path const& path,
+                     std::uint64_t fingerprint,
+                     not_null<std::unique_ptr<EphemerisCache>*> cache);
+
+  int number_of_bodies() const;
+
+  // The range of the trajectory of the body at |body_index| in the order of
+  // |bodies()| of the ephemeris that was written.
+  Instant t_min(int body_index) const;
+  Instant t_max(int body_index) const;
+
+  // Same as the corresponding functions of |ContinuousTrajectory|, to within a
+  // few ULPs since the polynomials are evaluated with Horner's scheme.  |time|
+  // must be in [t_min(body_index), t_max(body_index)].
+  Position<Frame> EvaluatePosition(int body_index, Instant const& time) const;
+  Velocity<Frame> EvaluateVelocity(int body_index, Instant const& time) const;
+
+ private:
+  // The layout of the file is: a |Header|; a |BodyEntry| for each body; for
+  // each body, a |PolynomialEntry| for each of its polynomials in increasing
+  // time order; the coefficients of all the polynomials.  All the times are in
+  // seconds from J2000, all the quantities are in SI units, and all the offsets
+  // are in bytes from the beginning of the file.  The file uses the native
+  // byte order.
+  static constexpr char file_magic[8] =
+      {'P', 'R', 'N', 'C', 'E', 'P', 'H', 'C'};
+  static constexpr std::uint32_t file_version = 1;
+  // Larger than the degree of any polynomial of a |ContinuousTrajectory|.
+  static constexpr std::uint64_t max_degree = 32;
+
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t number_of_bodies;
+    std::uint64_t fingerprint;
+    std::uint64_t size;
+  };
+
+  struct BodyEntry {
+    double t_min;
+    std::uint64_t number_of_polynomials;
+    std::uint64_t polynomials_offset;
+  };
+
+  // The polynomial is valid until |t_max| and has coefficients relative to
+  // |origin|.  Its |3 * (degree + 1)| coefficients are stored at
+  // |coefficients_offset| in increasing order of powers, each as x, y, z.
+  struct PolynomialEntry {
+    double t_max;
+    double origin;
+    std::uint64_t degree;
+    std::uint64_t coefficients_offset;
+  };
+
+  explicit EphemerisCache(not_null<std::unique_ptr<MappedFile>> file);
+
+  // Returns an error if |contents| is not a well-formed cache written with
+  // |fingerprint|.  Once this has succeeded, all the offsets in the file are
+  // known to be within the file and suitably aligned.
+  static Status Validate(Array<std::uint8_t const> const& contents,
+                         std::uint64_t fingerprint);
+
+  BodyEntry const& body(int body_index) const;
+  PolynomialEntry const* polynomials(BodyEntry const& body) const;
+
+  // Returns the polynomial applicable for |time|.
+  PolynomialEntry const& FindPolynomialForInstant(int body_index,
+                                                  Instant const& time) const;
+  double const* coefficients(PolynomialEntry const& polynomial) const;
+
+  not_null<std::unique_ptr<MappedFile>> const file_;
+  Header const* header_;
+  BodyEntry const* bodies_;
+};
+
+}  // namespace internal_ephemeris_cache
+
+using internal_ephemeris_cache::EphemerisCache;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/ephemeris_cache_body.hpp"
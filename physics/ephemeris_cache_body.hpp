@@ -0,0 +1,328 @@
+﻿
+#pragma once
+
+#include "physics/ephemeris_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "astronomy/epoch.hpp"
+#include "base/macros.hpp"
+#include "glog/logging.h"
+#include "quantities/si.hpp"
+#include "serialization/physics.pb.h"
+
+namespace principia {
+namespace physics {
+namespace internal_ephemeris_cache {
+
+using astronomy::J2000;
+using base::Error;
+using geometry::Displacement;
+using quantities::si::Metre;
+using quantities::si::Second;
+
+namespace {
+
+// Returns the magnitude of the given coordinate of a serialized coefficient.
+double Magnitude(serialization::R3Element::Coordinate const& coordinate) {
+  return coordinate.has_quantity() ? coordinate.quantity().magnitude()
+                                   : coordinate.double_();
+}
+
+}  // namespace
+
+template<typename Frame>
+Status EphemerisCache<Frame>::Write(Ephemeris<Frame> const& ephemeris,
+                                    std::uint64_t const fingerprint,
+                                    std::filesystem::path const& path) {
+  auto const& bodies = ephemeris.bodies();
+  std::vector<BodyEntry> body_entries;
+  std::vector<PolynomialEntry> polynomial_entries;
+  std::vector<double> coefficients;
+  for (auto const body : bodies) {
+    serialization::ContinuousTrajectory message;
+    ephemeris.trajectory(body)->WriteToMessage(&message);
+    if (!message.has_first_time()) {
+      return Status(Error::FAILED_PRECONDITION, "Empty trajectory");
+    }
+    body_entries.push_back(
+        {(Instant::ReadFromMessage(message.first_time()) - J2000) / Second,
+         static_cast<std::uint64_t>(message.instant_polynomial_pair_size()),
+         /*polynomials_offset=*/0});
+    for (auto const& pair : message.instant_polynomial_pair()) {
+      auto const& polynomial = pair.polynomial();
+      auto const& extension = polynomial.GetExtension(
+          serialization::PolynomialInMonomialBasis::extension);
+      CHECK_EQ(polynomial.degree() + 1, extension.coefficient_size());
+      polynomial_entries.push_back(
+          {(Instant::ReadFromMessage(pair.t_max()) - J2000) / Second,
+           extension.origin().scalar().magnitude(),
+           static_cast<std::uint64_t>(polynomial.degree()),
+           /*coefficients_offset=*/coefficients.size() * sizeof(double)});
+      for (auto const& coefficient : extension.coefficient()) {
+        auto const& vector = coefficient.multivector().vector();
+        coefficients.push_back(Magnitude(vector.x()));
+        coefficients.push_back(Magnitude(vector.y()));
+        coefficients.push_back(Magnitude(vector.z()));
+      }
+    }
+  }
+
+  // Now that we know the sizes of the tables, fix the offsets.
+  std::uint64_t const bodies_offset = sizeof(Header);
+  std::uint64_t const polynomials_offset =
+      bodies_offset + body_entries.size() * sizeof(BodyEntry);
+  std::uint64_t const coefficients_offset =
+      polynomials_offset + polynomial_entries.size() * sizeof(PolynomialEntry);
+  std::uint64_t next_polynomials_offset = polynomials_offset;
+  for (auto& body_entry : body_entries) {
+    body_entry.polynomials_offset = next_polynomials_offset;
+    next_polynomials_offset +=
+        body_entry.number_of_polynomials * sizeof(PolynomialEntry);
+  }
+  for (auto& polynomial_entry : polynomial_entries) {
+    polynomial_entry.coefficients_offset += coefficients_offset;
+  }
+
+  Header header;
+  std::memcpy(header.magic, file_magic, sizeof(file_magic));
+  header.version = file_version;
+  header.number_of_bodies = body_entries.size();
+  header.fingerprint = fingerprint;
+  header.size = coefficients_offset + coefficients.size() * sizeof(double);
+
+  // Write to a temporary file and rename it so that a reader never sees a
+  // partially-written cache.
+  std::filesystem::path temporary_path = path;
+  temporary_path += ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    file.write(reinterpret_cast<char const*>(body_entries.data()),
+               body_entries.size() * sizeof(BodyEntry));
+    file.write(reinterpret_cast<char const*>(polynomial_entries.data()),
+               polynomial_entries.size() * sizeof(PolynomialEntry));
+    file.write(reinterpret_cast<char const*>(coefficients.data()),
+               coefficients.size() * sizeof(double));
+    if (!file.good()) {
+      return Status(Error::UNAVAILABLE,
+                    "Cannot write " + temporary_path.string());
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary_path, path, error);
+  if (error) {
+    return Status(Error::UNAVAILABLE,
+                  "Cannot rename " + temporary_path.string() + ": " +
+                      error.message());
+  }
+  return Status::OK;
+}
+
+template<typename Frame>
+Status EphemerisCache<Frame>::Open(
+    std::filesystem::path const& path,
+    std::uint64_t const fingerprint,
+    not_null<std::unique_ptr<EphemerisCache>*> const cache) {
+  auto file = std::make_unique<MappedFile>(path);
+  if (!file->is_open()) {
+    return Status(Error::NOT_FOUND, "No ephemeris cache at " + path.string());
+  }
+  Status const status = Validate(file->contents(), fingerprint);
+  if (!status.ok()) {
+    LOG(WARNING) << "Deleting ephemeris cache at " << path << ": " << status;
+    // The file must be unmapped before it can be deleted on Windows.
+    file.reset();
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    LOG_IF(WARNING, error) << "Cannot delete " << path << ": "
+                           << error.message();
+    return Status(Error::NOT_FOUND, status.message());
+  }
+  cache->reset(new EphemerisCache(std::move(file)));
+  return Status::OK;
+}
+
+template<typename Frame>
+int EphemerisCache<Frame>::number_of_bodies() const {
+  return header_->number_of_bodies;
+}
+
+template<typename Frame>
+Instant EphemerisCache<Frame>::t_min(int const body_index) const {
+  return J2000 + body(body_index).t_min * Second;
+}
+
+template<typename Frame>
+Instant EphemerisCache<Frame>::t_max(int const body_index) const {
+  BodyEntry const& entry = body(body_index);
+  return J2000 +
+         polynomials(entry)[entry.number_of_polynomials - 1].t_max * Second;
+}
+
+template<typename Frame>
+Position<Frame> EphemerisCache<Frame>::EvaluatePosition(
+    int const body_index,
+    Instant const& time) const {
+  PolynomialEntry const& polynomial =
+      FindPolynomialForInstant(body_index, time);
+  double const* const c = coefficients(polynomial);
+  double const argument = (time - J2000) / Second - polynomial.origin;
+  double x = c[3 * polynomial.degree];
+  double y = c[3 * polynomial.degree + 1];
+  double z = c[3 * polynomial.degree + 2];
+  for (int k = polynomial.degree - 1; k >= 0; --k) {
+    x = x * argument + c[3 * k];
+    y = y * argument + c[3 * k + 1];
+    z = z * argument + c[3 * k + 2];
+  }
+  return Frame::origin + Displacement<Frame>({x * Metre, y * Metre, z * Metre});
+}
+
+template<typename Frame>
+Velocity<Frame> EphemerisCache<Frame>::EvaluateVelocity(
+    int const body_index,
+    Instant const& time) const {
+  PolynomialEntry const& polynomial =
+      FindPolynomialForInstant(body_index, time);
+  double const* const c = coefficients(polynomial);
+  double const argument = (time - J2000) / Second - polynomial.origin;
+  double vx = 0;
+  double vy = 0;
+  double vz = 0;
+  for (int k = polynomial.degree; k >= 1; --k) {
+    vx = vx * argument + k * c[3 * k];
+    vy = vy * argument + k * c[3 * k + 1];
+    vz = vz * argument + k * c[3 * k + 2];
+  }
+  return Velocity<Frame>(
+      {vx * Metre / Second, vy * Metre / Second, vz * Metre / Second});
+}
+
+template<typename Frame>
+EphemerisCache<Frame>::EphemerisCache(
+    not_null<std::unique_ptr<MappedFile>> file)
+    : file_(std::move(file)),
+      header_(reinterpret_cast<Header const*>(file_->contents().data)),
+      bodies_(reinterpret_cast<BodyEntry const*>(file_->contents().data +
+                                                 sizeof(Header))) {}
+
+template<typename Frame>
+Status EphemerisCache<Frame>::Validate(
+    Array<std::uint8_t const> const& contents,
+    std::uint64_t const fingerprint) {
+  auto const inconsistent = [](std::string const& what) {
+    return Status(Error::DATA_LOSS, "Inconsistent " + what);
+  };
+  if (contents.size < sizeof(Header)) {
+    return Status(Error::DATA_LOSS, "Truncated header");
+  }
+  Header const& header = *reinterpret_cast<Header const*>(contents.data);
+  if (std::memcmp(header.magic, file_magic, sizeof(file_magic)) != 0 ||
+      header.version != file_version) {
+    return Status(Error::DATA_LOSS, "Unrecognized format");
+  }
+  if (header.fingerprint != fingerprint) {
+    std::stringstream message;
+    message << "Stale fingerprint " << std::hex << std::uppercase
+            << header.fingerprint << " instead of " << fingerprint;
+    return Status(Error::FAILED_PRECONDITION, message.str());
+  }
+  if (header.size != contents.size) {
+    return Status(Error::DATA_LOSS, "Truncated file");
+  }
+  std::uint64_t const polynomials_offset =
+      sizeof(Header) + header.number_of_bodies * sizeof(BodyEntry);
+  if (polynomials_offset > contents.size) {
+    return inconsistent("table of bodies");
+  }
+
+  // The tables of polynomials must be within the file, and so must be the
+  // coefficients of each polynomial.  The times must be increasing so that the
+  // binary search in |FindPolynomialForInstant| is valid.  This touches the
+  // tables, but not the pages that hold the coefficients.
+  auto const* const bodies =
+      reinterpret_cast<BodyEntry const*>(contents.data + sizeof(Header));
+  for (std::uint32_t i = 0; i < header.number_of_bodies; ++i) {
+    BodyEntry const& body = bodies[i];
+    if (body.number_of_polynomials == 0 ||
+        body.polynomials_offset < polynomials_offset ||
+        body.polynomials_offset > contents.size ||
+        body.polynomials_offset % alignof(PolynomialEntry) != 0 ||
+        body.number_of_polynomials >
+            (contents.size - body.polynomials_offset) /
+                sizeof(PolynomialEntry)) {
+      return inconsistent("table of polynomials");
+    }
+    auto const* const polynomials = reinterpret_cast<PolynomialEntry const*>(
+        contents.data + body.polynomials_offset);
+    double t_min = body.t_min;
+    for (std::uint64_t j = 0; j < body.number_of_polynomials; ++j) {
+      PolynomialEntry const& polynomial = polynomials[j];
+      if (!(t_min < polynomial.t_max)) {
+        return inconsistent("polynomial times");
+      }
+      t_min = polynomial.t_max;
+      if (polynomial.degree > max_degree ||
+          polynomial.coefficients_offset < polynomials_offset ||
+          polynomial.coefficients_offset > contents.size ||
+          polynomial.coefficients_offset % alignof(double) != 0 ||
+          3 * (polynomial.degree + 1) >
+              (contents.size - polynomial.coefficients_offset) /
+                  sizeof(double)) {
+        return inconsistent("polynomial coefficients");
+      }
+    }
+  }
+  return Status::OK;
+}
+
+template<typename Frame>
+typename EphemerisCache<Frame>::BodyEntry const& EphemerisCache<Frame>::body(
+    int const body_index) const {
+  CHECK_LE(0, body_index);
+  CHECK_LT(body_index, number_of_bodies());
+  return bodies_[body_index];
+}
+
+template<typename Frame>
+typename EphemerisCache<Frame>::PolynomialEntry const*
+EphemerisCache<Frame>::polynomials(BodyEntry const& body) const {
+  return reinterpret_cast<PolynomialEntry const*>(file_->contents().data +
+                                                  body.polynomials_offset);
+}
+
+template<typename Frame>
+typename EphemerisCache<Frame>::PolynomialEntry const&
+EphemerisCache<Frame>::FindPolynomialForInstant(int const body_index,
+                                                Instant const& time) const {
+  CHECK_LE(t_min(body_index), time);
+  CHECK_GE(t_max(body_index), time);
+  BodyEntry const& entry = body(body_index);
+  auto const* const begin = polynomials(entry);
+  auto const* const end = begin + entry.number_of_polynomials;
+  double const t = (time - J2000) / Second;
+  // This returns the first polynomial |p| such that |t <= p.t_max|.
+  auto const* const it = std::lower_bound(
+      begin, end, t, [](PolynomialEntry const& left, double const right) {
+        return left.t_max < right;
+      });
+  CHECK(it != end);
+  return *it;
+}
+
+template<typename Frame>
+double const* EphemerisCache<Frame>::coefficients(
+    PolynomialEntry const& polynomial) const {
+  return reinterpret_cast<double const*>(file_->contents().data +
+                                         polynomial.coefficients_offset);
+}
+
+}  // namespace internal_ephemeris_cache
+}  // namespace physics
+}  // namespace principia
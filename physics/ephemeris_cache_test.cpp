@@ -0,0 +1,170 @@
+
+#include "physics/ephemeris_cache.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "astronomy/frames.hpp"
+#include "geometry/named_quantities.hpp"
+#include "gtest/gtest.h"
+#include "integrators/methods.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/massive_body.hpp"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/numerics.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_ephemeris_cache {
+
+using astronomy::ICRS;
+using base::Error;
+using base::make_not_null_unique;
+using geometry::Displacement;
+using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::methods::QuinlanTremaine1990Order12;
+using quantities::GravitationalParameter;
+using quantities::Pow;
+using quantities::Sqrt;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Micro;
+using quantities::si::Milli;
+using quantities::si::Minute;
+using quantities::si::Second;
+using testing_utilities::AbsoluteError;
+using ::testing::Lt;
+
+class EphemerisCacheTest : public ::testing::Test {
+ protected:
+  EphemerisCacheTest()
+      : path_(std::filesystem::temp_directory_path() /
+              "ephemeris_cache_test.bin"),
+        ephemeris_(MakeEphemeris(t0_)) {
+    ephemeris_->Prolong(t0_ + 30 * 24 * 60 * Minute);
+  }
+
+  ~EphemerisCacheTest() override {
+    std::filesystem::remove(path_);
+  }
+
+  // An Earth-Moon system on circular orbits.
+  static not_null<std::unique_ptr<Ephemeris<ICRS>>> MakeEphemeris(
+      Instant const& t0) {
+    GravitationalParameter const μ1 =
+        398600.4418 * Pow<3>(Kilo(Metre)) / Pow<2>(Second);
+    GravitationalParameter const μ2 = μ1 / 81;
+    Displacement<ICRS> const r({0 * Metre, 4e8 * Metre, 0 * Metre});
+    auto const ω = Sqrt((μ1 + μ2) / Pow<3>(r.Norm()));
+    Velocity<ICRS> const v(
+        {-ω * r.Norm(), 0 * Metre / Second, 0 * Metre / Second});
+    std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+    bodies.emplace_back(make_not_null_unique<MassiveBody>(μ1));
+    bodies.emplace_back(make_not_null_unique<MassiveBody>(μ2));
+    std::vector<DegreesOfFreedom<ICRS>> const initial_state{
+        {ICRS::origin - μ2 / (μ1 + μ2) * r, -μ2 / (μ1 + μ2) * v},
+        {ICRS::origin + μ1 / (μ1 + μ2) * r, μ1 / (μ1 + μ2) * v}};
+    return make_not_null_unique<Ephemeris<ICRS>>(
+        std::move(bodies),
+        initial_state,
+        t0,
+        /*fitting_tolerance=*/1 * Milli(Metre),
+        Ephemeris<ICRS>::FixedStepParameters(
+            SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                               Position<ICRS>>(),
+            /*step=*/10 * Minute));
+  }
+
+  static constexpr std::uint64_t fingerprint_ = 0x1234'5678'9ABC'DEF0;
+  Instant const t0_;
+  std::filesystem::path const path_;
+  not_null<std::unique_ptr<Ephemeris<ICRS>>> const ephemeris_;
+};
+
+TEST_F(EphemerisCacheTest, RoundTrip) {
+  EXPECT_OK(EphemerisCache<ICRS>::Write(*ephemeris_, fingerprint_, path_));
+  std::unique_ptr<EphemerisCache<ICRS>> cache;
+  EXPECT_OK(EphemerisCache<ICRS>::Open(path_, fingerprint_, &cache));
+  ASSERT_NE(nullptr, cache);
+  ASSERT_EQ(2, cache->number_of_bodies());
+  for (int i = 0; i < 2; ++i) {
+    auto const& trajectory = *ephemeris_->trajectory(ephemeris_->bodies()[i]);
+    EXPECT_EQ(trajectory.t_min(), cache->t_min(i));
+    EXPECT_EQ(trajectory.t_max(), cache->t_max(i));
+    for (Instant t = trajectory.t_min();
+         t <= trajectory.t_max();
+         t += 17 * Minute) {
+      EXPECT_THAT(AbsoluteError(trajectory.EvaluatePosition(t),
+                                cache->EvaluatePosition(i, t)),
+                  Lt(1 * Micro(Metre)));
+      EXPECT_THAT(AbsoluteError(trajectory.EvaluateVelocity(t),
+                                cache->EvaluateVelocity(i, t)),
+                  Lt(1 * Micro(Metre) / Second));
+    }
+  }
+}
+
+TEST_F(EphemerisCacheTest, Rejected) {
+  std::unique_ptr<EphemerisCache<ICRS>> cache;
+  EXPECT_EQ(Error::NOT_FOUND,
+            EphemerisCache<ICRS>::Open(path_, fingerprint_, &cache).error());
+  EXPECT_EQ(nullptr, cache);
+
+  // A stale cache is deleted.
+  EXPECT_OK(EphemerisCache<ICRS>::Write(*ephemeris_, fingerprint_, path_));
+  EXPECT_EQ(
+      Error::NOT_FOUND,
+      EphemerisCache<ICRS>::Open(path_, fingerprint_ + 1, &cache).error());
+  EXPECT_EQ(nullptr, cache);
+  EXPECT_FALSE(std::filesystem::exists(path_));
+
+  // So is a truncated cache.
+  EXPECT_OK(EphemerisCache<ICRS>::Write(*ephemeris_, fingerprint_, path_));
+  std::filesystem::resize_file(path_,
+                               std::filesystem::file_size(path_) - 8);
+  EXPECT_EQ(Error::NOT_FOUND,
+            EphemerisCache<ICRS>::Open(path_, fingerprint_, &cache).error());
+  EXPECT_EQ(nullptr, cache);
+  EXPECT_FALSE(std::filesystem::exists(path_));
+
+  // And one with a corrupted magic number.
+  {
+    std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+    file << "PRNCEPHX and some garbage to make it long enough";
+  }
+  EXPECT_EQ(Error::NOT_FOUND,
+            EphemerisCache<ICRS>::Open(path_, fingerprint_, &cache).error());
+  EXPECT_EQ(nullptr, cache);
+  EXPECT_FALSE(std::filesystem::exists(path_));
+}
+
+TEST_F(EphemerisCacheTest, Corrupted) {
+  EXPECT_OK(EphemerisCache<ICRS>::Write(*ephemeris_, fingerprint_, path_));
+  auto const size = std::filesystem::file_size(path_);
+  // Overwrite the first polynomial entry, which follows the header (32 bytes)
+  // and the entries of the two bodies (24 bytes each).  The file keeps its
+  // size, so it is only rejected by the validation of the tables.
+  {
+    std::fstream file(path_, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(32 + 2 * 24);
+    std::uint64_t const garbage = 0xFFFF'FFFF'FFFF'FFFF;
+    for (int i = 0; i < 4; ++i) {
+      file.write(reinterpret_cast<char const*>(&garbage), sizeof(garbage));
+    }
+  }
+  ASSERT_EQ(size, std::filesystem::file_size(path_));
+  std::unique_ptr<EphemerisCache<ICRS>> cache;
+  EXPECT_EQ(Error::NOT_FOUND,
+            EphemerisCache<ICRS>::Open(path_, fingerprint_, &cache).error());
+  EXPECT_EQ(nullptr, cache);
+  EXPECT_FALSE(std::filesystem::exists(path_));
+}
+
+}  // namespace internal_ephemeris_cache
+}  // namespace physics
+}  // namespace principia
@@ -9,6 +9,7 @@
 
 #include "astronomy/frames.hpp"
 #include "base/macros.hpp"
+#include "base/thread_pool.hpp"
 #include "geometry/barycentre_calculator.hpp"
 #include "geometry/frame.hpp"
 #include "gmock/gmock.h"
@@ -39,7 +40,10 @@ namespace physics {
 namespace internal_ephemeris {
 
 using astronomy::ICRS;
+using base::make_not_null_unique;
 using base::not_null;
+using base::Status;
+using base::ThreadPool;
 using geometry::Barycentre;
 using geometry::AngularVelocity;
 using geometry::Displacement;
@@ -330,6 +334,54 @@ TEST_P(EphemerisTest, ForgetBefore) {
   EXPECT_EQ(t0_ + 3 * period, moon_trajectory.t_min());
 }
 
+// Checks that evaluating all the bodies at once gives the same results as
+// evaluating their trajectories one by one, in the order of |bodies()|.
+TEST_P(EphemerisTest, EvaluateAll) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRS>> initial_state;
+  Position<ICRS> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  Ephemeris<ICRS> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      5 * Milli(Metre),
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), period / 100));
+
+  ephemeris.Prolong(t0_ + 3 * period);
+  ephemeris.ForgetBefore(t0_ + period);
+
+  // Go back and forth in time to exercise the lookup of the polynomials.
+  std::vector<Instant> times;
+  for (int i = 0; i <= 20; ++i) {
+    times.push_back(t0_ + period + i * period / 10);
+    times.push_back(t0_ + 3 * period - i * period / 10);
+  }
+  for (Instant const& t : times) {
+    auto const positions = ephemeris.EvaluateAllPositions(t);
+    auto const degrees_of_freedom = ephemeris.EvaluateAllDegreesOfFreedom(t);
+    ASSERT_EQ(2, positions.size());
+    ASSERT_EQ(2, degrees_of_freedom.size());
+    for (int i = 0; i < 2; ++i) {
+      auto const& trajectory = *ephemeris.trajectory(ephemeris.bodies()[i]);
+      EXPECT_EQ(trajectory.EvaluatePosition(t), positions[i]);
+      EXPECT_EQ(trajectory.EvaluateDegreesOfFreedom(t), degrees_of_freedom[i]);
+    }
+  }
+
+  // The hint kept from the previous evaluations is stale once polynomials are
+  // forgotten.
+  ephemeris.ForgetBefore(t0_ + 2 * period);
+  Instant const t = t0_ + 3 * period;
+  auto const positions = ephemeris.EvaluateAllPositions(t);
+  for (int i = 0; i < 2; ++i) {
+    auto const& trajectory = *ephemeris.trajectory(ephemeris.bodies()[i]);
+    EXPECT_EQ(trajectory.EvaluatePosition(t), positions[i]);
+  }
+}
+
 // The Moon alone.  It moves in straight line.
 TEST_P(EphemerisTest, Moon) {
   std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
@@ -629,6 +681,126 @@ TEST_P(EphemerisTest, EarthTwoProbes) {
               Eq(q_probe2));
 }
 
+// Checks that the accelerations computed on a thread pool give the same
+// trajectories, bit for bit, as the serial computation.
+TEST_P(EphemerisTest, ParallelMasslessBodies) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  std::vector<DegreesOfFreedom<ICRS>> initial_state;
+  Position<ICRS> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(bodies, initial_state, centre_of_mass, period);
+
+  Position<ICRS> const earth_position = initial_state[0].position();
+  Velocity<ICRS> const earth_velocity = initial_state[0].velocity();
+
+  Ephemeris<ICRS> ephemeris(
+      std::move(bodies),
+      initial_state,
+      t0_,
+      5 * Milli(Metre),
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), period / 100));
+
+  // Enough probes to have several chunks, the last one incomplete.
+  int const number_of_probes = 50;
+  std::vector<not_null<std::unique_ptr<DiscreteTrajectory<ICRS>>>>
+      serial_trajectories;
+  std::vector<not_null<std::unique_ptr<DiscreteTrajectory<ICRS>>>>
+      parallel_trajectories;
+  std::vector<not_null<DiscreteTrajectory<ICRS>*>> serial;
+  std::vector<not_null<DiscreteTrajectory<ICRS>*>> parallel;
+  for (int i = 0; i < number_of_probes; ++i) {
+    DegreesOfFreedom<ICRS> const degrees_of_freedom(
+        earth_position + Vector<Length, ICRS>(
+                             {0 * Metre, (i + 1) * 1e7 * Metre, 0 * Metre}),
+        earth_velocity + Velocity<ICRS>({(i + 1) * 10 * Metre / Second,
+                                         0 * Metre / Second,
+                                         0 * Metre / Second}));
+    serial_trajectories.push_back(
+        make_not_null_unique<DiscreteTrajectory<ICRS>>());
+    parallel_trajectories.push_back(
+        make_not_null_unique<DiscreteTrajectory<ICRS>>());
+    serial_trajectories.back()->Append(t0_, degrees_of_freedom);
+    parallel_trajectories.back()->Append(t0_, degrees_of_freedom);
+    serial.push_back(serial_trajectories.back().get());
+    parallel.push_back(parallel_trajectories.back().get());
+  }
+
+  Ephemeris<ICRS>::FixedStepParameters const parameters(
+      SymmetricLinearMultistepIntegrator<Quinlan1999Order8A,
+                                         Position<ICRS>>(),
+      period / 1000);
+  auto const serial_instance = ephemeris.NewInstance(
+      serial, Ephemeris<ICRS>::NoIntrinsicAccelerations, parameters);
+  ThreadPool<void> pool(/*pool_size=*/3);
+  auto const parallel_instance = ephemeris.NewInstance(
+      parallel, Ephemeris<ICRS>::NoIntrinsicAccelerations, parameters, &pool);
+  EXPECT_OK(ephemeris.FlowWithFixedStep(t0_ + period / 10, *serial_instance));
+  EXPECT_OK(ephemeris.FlowWithFixedStep(t0_ + period / 10, *parallel_instance));
+
+  for (int i = 0; i < number_of_probes; ++i) {
+    EXPECT_EQ(serial_trajectories[i]->Size(),
+              parallel_trajectories[i]->Size());
+    for (auto it1 = serial_trajectories[i]->Begin(),
+              it2 = parallel_trajectories[i]->Begin();
+         it1 != serial_trajectories[i]->End();
+         ++it1, ++it2) {
+      EXPECT_EQ(it1.time(), it2.time());
+      EXPECT_EQ(it1.degrees_of_freedom(), it2.degrees_of_freedom());
+    }
+  }
+}
+
+// Checks that fitting the polynomials on a thread pool gives the same
+// trajectories and checkpoints, bit for bit, as the serial computation.
+TEST_P(EphemerisTest, PipelinedFitting) {
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> serial_bodies;
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> pipelined_bodies;
+  std::vector<DegreesOfFreedom<ICRS>> serial_initial_state;
+  std::vector<DegreesOfFreedom<ICRS>> pipelined_initial_state;
+  Position<ICRS> centre_of_mass;
+  Time period;
+  SetUpEarthMoonSystem(
+      serial_bodies, serial_initial_state, centre_of_mass, period);
+  SetUpEarthMoonSystem(
+      pipelined_bodies, pipelined_initial_state, centre_of_mass, period);
+
+  Ephemeris<ICRS> serial_ephemeris(
+      std::move(serial_bodies),
+      serial_initial_state,
+      t0_,
+      5 * Milli(Metre),
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), period / 100));
+  Ephemeris<ICRS> pipelined_ephemeris(
+      std::move(pipelined_bodies),
+      pipelined_initial_state,
+      t0_,
+      5 * Milli(Metre),
+      Ephemeris<ICRS>::FixedStepParameters(integrator(), period / 100));
+  ThreadPool<Status> pool(/*pool_size=*/2);
+  pipelined_ephemeris.SetFittingThreadPool(&pool);
+
+  // Long enough to have several checkpoints.
+  serial_ephemeris.Prolong(t0_ + 20 * period);
+  pipelined_ephemeris.Prolong(t0_ + 20 * period);
+  EXPECT_EQ(serial_ephemeris.t_max(), pipelined_ephemeris.t_max());
+  for (int i = 0; i < 2; ++i) {
+    auto const& serial_trajectory =
+        *serial_ephemeris.trajectory(serial_ephemeris.bodies()[i]);
+    auto const& pipelined_trajectory =
+        *pipelined_ephemeris.trajectory(pipelined_ephemeris.bodies()[i]);
+    for (Instant t = t0_; t < serial_ephemeris.t_max(); t += period / 7) {
+      EXPECT_EQ(serial_trajectory.EvaluateDegreesOfFreedom(t),
+                pipelined_trajectory.EvaluateDegreesOfFreedom(t));
+    }
+  }
+
+  serialization::Ephemeris serial_message;
+  serialization::Ephemeris pipelined_message;
+  serial_ephemeris.WriteToMessage(&serial_message);
+  pipelined_ephemeris.WriteToMessage(&pipelined_message);
+  EXPECT_THAT(pipelined_message, EqualsProto(serial_message));
+}
+
 TEST_P(EphemerisTest, Serialization) {
   std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
   std::vector<DegreesOfFreedom<ICRS>> initial_state;
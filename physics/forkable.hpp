@@ -39,7 +39,9 @@ class Forkable;
 // static Instant const& time(TimelineConstIterator it);
 //
 // TimelineConstIterator must be an STL-like iterator in the timeline of
-// Tr4jectory.  |time()| must return the corresponding time.
+// Tr4jectory.  |time()| must return the corresponding time.  The iterators,
+// including the end iterator, must remain valid when points are appended to
+// the timeline, as the forks keep their position in the parent timeline.
 //
 // NOTE(phl): This was originally written as a trait under the assumption that
 // we would want to expose STL iterators to clients.  This doesn't seem like a
@@ -0,0 +1,76 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+#include "absl/synchronization/mutex.h"
+#include "base/not_null.hpp"
+#include "geometry/named_quantities.hpp"
+#include "physics/dynamic_frame.hpp"
+#include "physics/rigid_motion.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_frame_motion_cache {
+
+using base::not_null;
+using geometry::Instant;
+using geometry::Position;
+using quantities::Time;
+
+// A cache of the motion of a |DynamicFrame| with respect to its inertial frame,
+// for clients that need to transform many points at arbitrary times, e.g., for
+// plotting.  The motion is computed exactly at nodes spaced by |step| and
+// interpolated in-between: cubic Hermite interpolation for the origin, constant
+// angular velocity for the axes, linear interpolation for the angular velocity.
+// The nodes are computed as needed and kept until the cache is full, so
+// clients that plot several trajectories in the same frame share the work.
+// The motion of the |frame| at a given time must not change during the
+// lifetime of this object.  This class is thread-safe.
+template<typename InertialFrame, typename ThisFrame>
+class FrameMotionCache final {
+ public:
+  FrameMotionCache(not_null<DynamicFrame<InertialFrame, ThisFrame> const*> frame,
+                   Time const& step);
+
+  // An approximation of |frame->ToThisFrameAtTime(t)|, exact at the nodes.
+  // Falls back to the frame if the nodes around |t| are not in the range of
+  // the frame.
+  RigidMotion<InertialFrame, ThisFrame> ToThisFrameAtTime(
+      Instant const& t) const EXCLUDES(lock_);
+
+ private:
+  struct Node final {
+    explicit Node(RigidMotion<InertialFrame, ThisFrame> const& to_this_frame);
+
+    RigidMotion<InertialFrame, ThisFrame> to_this_frame;
+    // The position of |ThisFrame::origin| in |InertialFrame|.
+    Position<InertialFrame> origin;
+  };
+
+  // Returns a copy of the node with the given |index|, computing it if needed.
+  // The lock is only held while accessing |nodes_|.
+  Node GetNode(std::int64_t index) const EXCLUDES(lock_);
+
+  Instant NodeTime(std::int64_t index) const;
+
+  // Beyond this number of nodes, the cache is emptied.
+  static constexpr int max_nodes_ = 20'000;
+
+  not_null<DynamicFrame<InertialFrame, ThisFrame> const*> const frame_;
+  Time const step_;
+
+  mutable absl::Mutex lock_;
+  mutable std::map<std::int64_t, Node> nodes_ GUARDED_BY(lock_);
+};
+
+}  // namespace internal_frame_motion_cache
+
+using internal_frame_motion_cache::FrameMotionCache;
+
+}  // namespace physics
+}  // namespace principia
+
+#include "physics/frame_motion_cache_body.hpp"
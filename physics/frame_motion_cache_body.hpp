@@ -0,0 +1,130 @@
+﻿
+#pragma once
+
+#include "physics/frame_motion_cache.hpp"
+
+#include <cmath>
+#include <utility>
+
+#include "geometry/grassmann.hpp"
+#include "geometry/orthogonal_map.hpp"
+#include "geometry/quaternion.hpp"
+#include "geometry/rotation.hpp"
+#include "numerics/hermite3.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_frame_motion_cache {
+
+using geometry::AngularVelocity;
+using geometry::OrthogonalMap;
+using geometry::Quaternion;
+using geometry::RigidTransformation;
+using geometry::Rotation;
+using numerics::Hermite3;
+
+template<typename InertialFrame, typename ThisFrame>
+FrameMotionCache<InertialFrame, ThisFrame>::FrameMotionCache(
+    not_null<DynamicFrame<InertialFrame, ThisFrame> const*> const frame,
+    Time const& step)
+    : frame_(frame),
+      step_(step) {}
+
+template<typename InertialFrame, typename ThisFrame>
+RigidMotion<InertialFrame, ThisFrame>
+FrameMotionCache<InertialFrame, ThisFrame>::ToThisFrameAtTime(
+    Instant const& t) const {
+  std::int64_t const index = std::floor((t - Instant()) / step_);
+  Instant const t1 = NodeTime(index);
+  Instant const t2 = NodeTime(index + 1);
+  if (t1 < frame_->t_min() || t2 > frame_->t_max()) {
+    return frame_->ToThisFrameAtTime(t);
+  }
+
+  // The nodes are copied so that the interpolation below doesn't hold the
+  // lock.
+  Node const node1 = GetNode(index);
+  if (t == t1) {
+    return node1.to_this_frame;
+  }
+  Node const node2 = GetNode(index + 1);
+  double const s = (t - t1) / step_;
+
+  Hermite3<Instant, Position<InertialFrame>> const origin(
+      {t1, t2},
+      {node1.origin, node2.origin},
+      {node1.to_this_frame.velocity_of_to_frame_origin(),
+       node2.to_this_frame.velocity_of_to_frame_origin()});
+
+  // Rotate the axes at |t1| towards those at |t2| around a fixed axis, at a
+  // constant rate.  The rotation between two nodes is small, so we don't need
+  // to worry about its angle being close to π.
+  OrthogonalMap<InertialFrame, ThisFrame> const& map1 =
+      node1.to_this_frame.orthogonal_map();
+  Quaternion q = (map1.Inverse() * node2.to_this_frame.orthogonal_map())
+                     .rotation()
+                     .quaternion();
+  if (q.real_part() < 0) {
+    q = -q;
+  }
+  double const sin_half_angle = q.imaginary_part().Norm();
+  OrthogonalMap<InertialFrame, ThisFrame> map = map1;
+  if (sin_half_angle > 0) {
+    double const half_angle = std::atan2(sin_half_angle, q.real_part());
+    Rotation<InertialFrame, InertialFrame> const partial_rotation(Quaternion(
+        std::cos(s * half_angle),
+        q.imaginary_part() * (std::sin(s * half_angle) / sin_half_angle)));
+    map = map1 * partial_rotation.Forget();
+  }
+
+  AngularVelocity<InertialFrame> const angular_velocity =
+      node1.to_this_frame.angular_velocity_of_to_frame() +
+      s * (node2.to_this_frame.angular_velocity_of_to_frame() -
+           node1.to_this_frame.angular_velocity_of_to_frame());
+
+  return RigidMotion<InertialFrame, ThisFrame>(
+      RigidTransformation<InertialFrame, ThisFrame>(
+          origin.Evaluate(t), ThisFrame::origin, map),
+      angular_velocity,
+      origin.EvaluateDerivative(t));
+}
+
+template<typename InertialFrame, typename ThisFrame>
+FrameMotionCache<InertialFrame, ThisFrame>::Node::Node(
+    RigidMotion<InertialFrame, ThisFrame> const& to_this_frame)
+    : to_this_frame(to_this_frame),
+      origin(to_this_frame.rigid_transformation().Inverse()(
+          ThisFrame::origin)) {}
+
+template<typename InertialFrame, typename ThisFrame>
+typename FrameMotionCache<InertialFrame, ThisFrame>::Node
+FrameMotionCache<InertialFrame, ThisFrame>::GetNode(
+    std::int64_t const index) const {
+  {
+    absl::ReaderMutexLock l(&lock_);
+    auto const it = nodes_.find(index);
+    if (it != nodes_.end()) {
+      return it->second;
+    }
+  }
+  // Compute the node without holding the lock.  If another thread computes it
+  // concurrently, both get the same result and the second insertion is a
+  // no-op.
+  Node const node(frame_->ToThisFrameAtTime(NodeTime(index)));
+  absl::MutexLock l(&lock_);
+  if (nodes_.size() >= max_nodes_) {
+    nodes_.clear();
+  }
+  nodes_.emplace(index, node);
+  return node;
+}
+
+template<typename InertialFrame, typename ThisFrame>
+Instant FrameMotionCache<InertialFrame, ThisFrame>::NodeTime(
+    std::int64_t const index) const {
+  return Instant() + index * step_;
+}
+
+}  // namespace internal_frame_motion_cache
+}  // namespace physics
+}  // namespace principia
@@ -0,0 +1,170 @@
+
+#include "physics/frame_motion_cache.hpp"
+
+#include <algorithm>
+
+#include "astronomy/epoch.hpp"
+#include "astronomy/frames.hpp"
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/rotation.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "integrators/methods.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "physics/barycentric_rotating_dynamic_frame.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/mock_dynamic_frame.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/solar_system_factory.hpp"
+
+namespace principia {
+namespace physics {
+namespace internal_frame_motion_cache {
+
+using astronomy::ICRS;
+using astronomy::InfiniteFuture;
+using astronomy::InfinitePast;
+using geometry::AngularVelocity;
+using geometry::Bivector;
+using geometry::DefinesFrame;
+using geometry::Displacement;
+using geometry::Frame;
+using geometry::RigidTransformation;
+using geometry::Rotation;
+using geometry::Velocity;
+using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::methods::QuinlanTremaine1990Order12;
+using quantities::AngularFrequency;
+using quantities::Length;
+using quantities::si::Day;
+using quantities::si::Hour;
+using quantities::si::Kilo;
+using quantities::si::Metre;
+using quantities::si::Milli;
+using quantities::si::Minute;
+using quantities::si::Radian;
+using quantities::si::Second;
+using testing_utilities::SolarSystemFactory;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Lt;
+using ::testing::Return;
+
+class FrameMotionCacheTest : public ::testing::Test {
+ protected:
+  using Inertial =
+      Frame<serialization::Frame::TestTag, serialization::Frame::TEST, true>;
+  using Rotating =
+      Frame<serialization::Frame::TestTag, serialization::Frame::TEST1, false>;
+
+  FrameMotionCacheTest() {
+    ON_CALL(frame_, t_min()).WillByDefault(Return(InfinitePast));
+    ON_CALL(frame_, t_max()).WillByDefault(Return(InfiniteFuture));
+    ON_CALL(frame_, ToThisFrameAtTime(_))
+        .WillByDefault(Invoke(this, &FrameMotionCacheTest::Motion));
+  }
+
+  // A frame whose origin moves uniformly and whose axes rotate uniformly.
+  // For such a frame the interpolation is exact.
+  RigidMotion<Inertial, Rotating> Motion(Instant const& t) const {
+    auto const Δt = t - Instant();
+    Rotation<Inertial, Rotating> const rotation(ω_ * Δt,
+                                                axis_,
+                                                DefinesFrame<Rotating>{});
+    return RigidMotion<Inertial, Rotating>(
+        RigidTransformation<Inertial, Rotating>(
+            origin_ + velocity_ * Δt, Rotating::origin, rotation.Forget()),
+        AngularVelocity<Inertial>(ω_ * axis_.coordinates()),
+        velocity_);
+  }
+
+  Length DistanceBetweenImages(RigidMotion<Inertial, Rotating> const& left,
+                               RigidMotion<Inertial, Rotating> const& right) {
+    return (left.rigid_transformation()(point_) -
+            right.rigid_transformation()(point_)).Norm();
+  }
+
+  ::testing::NiceMock<MockDynamicFrame<Inertial, Rotating>> frame_;
+  AngularFrequency const ω_ = 1e-3 * Radian / Second;
+  Bivector<double, Inertial> const axis_{{0, 0, 1}};
+  Position<Inertial> const origin_ =
+      Inertial::origin +
+      Displacement<Inertial>({1 * Kilo(Metre), 2 * Kilo(Metre), 0 * Metre});
+  Velocity<Inertial> const velocity_{
+      {3 * Metre / Second, -1 * Metre / Second, 2 * Metre / Second}};
+  Position<Inertial> const point_ =
+      Inertial::origin +
+      Displacement<Inertial>({7000 * Kilo(Metre), 0 * Metre, 0 * Metre});
+};
+
+TEST_F(FrameMotionCacheTest, Interpolation) {
+  FrameMotionCache<Inertial, Rotating> const cache(&frame_, 10 * Minute);
+  // All the evaluations fall between two nodes.
+  EXPECT_CALL(frame_, ToThisFrameAtTime(_)).Times(2);
+  for (int i = 1; i < 100; ++i) {
+    Instant const t = Instant() + i * 6 * Second;
+    EXPECT_THAT(DistanceBetweenImages(Motion(t), cache.ToThisFrameAtTime(t)),
+                Lt(1 * Milli(Metre)));
+  }
+}
+
+// The Earth-Moon rotating frame of an actual ephemeris, with nodes every 10
+// minutes as in the plugin.  The rotation of that frame is far from uniform
+// because of the eccentricity of the lunar orbit and of the solar
+// perturbations, but the interpolation error remains small.
+TEST_F(FrameMotionCacheTest, EarthMoon) {
+  using EarthMoon = Frame<serialization::Frame::TestTag,
+                          serialization::Frame::TEST2,
+                          /*frame_is_inertial=*/false>;
+  auto const solar_system = SolarSystemFactory::AtСпутник1Launch(
+      SolarSystemFactory::Accuracy::MajorBodiesOnly);
+  auto const ephemeris = solar_system->MakeEphemeris(
+      /*fitting_tolerance=*/1 * Milli(Metre),
+      Ephemeris<ICRS>::FixedStepParameters(
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<ICRS>>(),
+          /*step=*/10 * Minute));
+  Instant const t0 = solar_system->epoch();
+  ephemeris->Prolong(t0 + 2 * Day);
+
+  auto const earth = solar_system->massive_body(
+      *ephemeris, SolarSystemFactory::name(SolarSystemFactory::Earth));
+  auto const moon = solar_system->massive_body(
+      *ephemeris, SolarSystemFactory::name(SolarSystemFactory::Moon));
+  BarycentricRotatingDynamicFrame<ICRS, EarthMoon> const frame(
+      ephemeris.get(), earth, moon);
+  FrameMotionCache<ICRS, EarthMoon> const cache(&frame, 10 * Minute);
+
+  Length max_earth_error;
+  Length max_moon_error;
+  for (Instant t = t0 + 1 * Hour; t < t0 + 1 * Day; t += 433 * Second) {
+    auto const expected = frame.ToThisFrameAtTime(t).rigid_transformation();
+    auto const actual = cache.ToThisFrameAtTime(t).rigid_transformation();
+    auto const earth_position =
+        ephemeris->trajectory(earth)->EvaluatePosition(t);
+    auto const moon_position = ephemeris->trajectory(moon)->EvaluatePosition(t);
+    max_earth_error = std::max(
+        max_earth_error,
+        (expected(earth_position) - actual(earth_position)).Norm());
+    max_moon_error =
+        std::max(max_moon_error,
+                 (expected(moon_position) - actual(moon_position)).Norm());
+  }
+  // The Earth is about 4700 km from the barycentre and the Moon about
+  // 380 000 km.
+  EXPECT_THAT(max_earth_error, Lt(2 * Metre));
+  EXPECT_THAT(max_moon_error, Lt(100 * Metre));
+}
+
+TEST_F(FrameMotionCacheTest, OutOfRange) {
+  EXPECT_CALL(frame_, t_max()).WillRepeatedly(Return(Instant() + 1 * Minute));
+  FrameMotionCache<Inertial, Rotating> const cache(&frame_, 10 * Minute);
+  // The next node is beyond |t_max|, the frame is used directly.
+  EXPECT_CALL(frame_, ToThisFrameAtTime(Instant() + 30 * Second));
+  cache.ToThisFrameAtTime(Instant() + 30 * Second);
+}
+
+}  // namespace internal_frame_motion_cache
+}  // namespace physics
+}  // namespace principia
@@ -56,6 +56,16 @@ class HarmonicDamping final {
       Inverse<Square<Length>>& σℜ_over_r,
       Vector<Inverse<Square<Length>>, Frame>& grad_σℜ) const;
 
+  // Same as above, but only computes the radial component σℜʹ of grad_σℜ (the
+  // gradient is always along r_normalized).
+  void ComputeDampedRadialQuantities(
+      Length const& r_norm,
+      Square<Length> const& r²,
+      Inverse<Square<Length>> const& ℜ_over_r,
+      Inverse<Square<Length>> const& ℜʹ,
+      Inverse<Square<Length>>& σℜ_over_r,
+      Inverse<Square<Length>>& σℜʹ) const;
+
  private:
   Length outer_threshold_ = Infinity<Length>();
   Length inner_threshold_ = Infinity<Length>();
@@ -113,9 +123,29 @@ class Geopotential {
 
   using UnitVector = Vector<double, Frame>;
 
+  // Degrees up to this value are evaluated by the templates below, which are
+  // unrolled at compile time.  Higher degrees are evaluated by
+  // |RuntimeDegreeAcceleration|.
+  static constexpr int max_unrolled_degree = 10;
+
   // Holds precomputed data for one evaluation of the acceleration.
   struct Precomputations;
 
+  // The data for the harmonic of degree n and order m used by
+  // |RuntimeDegreeAcceleration|.  The normalized associated Legendre functions
+  // (with the factor cos_β^m removed) satisfy:
+  //   P̄mm = a P̄m-1m-1,
+  //   P̄nm = a sin_β P̄n-1m - b P̄n-2m for n > m,
+  // and the derivative of the unnormalized function multiplied by the
+  // normalization factor for (n, m) is |derivative_factor| P̄nm+1.
+  struct HarmonicTerm {
+    double Cnm;
+    double Snm;
+    double a;
+    double b;
+    double derivative_factor;
+  };
+
   // Helper templates for iterating over the degrees/orders of the geopotential.
   template<int degree, int order>
   struct DegreeNOrderM;
@@ -143,6 +173,18 @@ class Geopotential {
                            Exponentiation<Length, -2> const& one_over_r²,
                            Exponentiation<Length, -3> const& one_over_r³) const;
 
+  // Evaluates the harmonics up to |max_degree| using recurrences on contiguous
+  // arrays, order by order.  This supports all the degrees of |body_|, not just
+  // those up to |max_unrolled_degree|.
+  Vector<Quotient<Acceleration, GravitationalParameter>, Frame>
+  RuntimeDegreeAcceleration(
+      int max_degree,
+      Instant const& t,
+      Displacement<Frame> const& r,
+      Length const& r_norm,
+      Square<Length> const& r²,
+      Exponentiation<Length, -3> const& one_over_r³) const;
+
   not_null<OblateBody<Frame> const*> body_;
 
   // The contribution from the harmonics of degree n is damped by
@@ -158,6 +200,12 @@ class Geopotential {
   //   degree_damping[2] ≼ sectoral_damping_ ≼ degree_damping[3]
   // holds, where ≼ denotes the ordering of the thresholds.
   HarmonicDamping sectoral_damping_;
+
+  // The data for all the harmonics of |body_|, in order-major layout: the terms
+  // for order m are stored contiguously for degrees m to the degree of |body_|.
+  std::vector<HarmonicTerm> order_major_terms_;
+
+  friend class GeopotentialTest;
 };
 
 }  // namespace internal_geopotential
@@ -67,12 +67,23 @@ void HarmonicDamping::ComputeDampedRadialQuantities(
       Inverse<Square<Length>> const& ℜʹ,
       Inverse<Square<Length>>& σℜ_over_r,
       Vector<Inverse<Square<Length>>, Frame>& grad_σℜ) const {
-  Length const& s1 = outer_threshold_;
+  Inverse<Square<Length>> σℜʹ;
+  ComputeDampedRadialQuantities(r_norm, r², ℜ_over_r, ℜʹ, σℜ_over_r, σℜʹ);
+  grad_σℜ = σℜʹ * r_normalized;
+}
+
+inline void HarmonicDamping::ComputeDampedRadialQuantities(
+      Length const& r_norm,
+      Square<Length> const& r²,
+      Inverse<Square<Length>> const& ℜ_over_r,
+      Inverse<Square<Length>> const& ℜʹ,
+      Inverse<Square<Length>>& σℜ_over_r,
+      Inverse<Square<Length>>& σℜʹ) const {
   Length const& s0 = inner_threshold_;
   if (r_norm <= s0) {
     // Below the inner threshold, σ = 1.
     σℜ_over_r = ℜ_over_r;
-    grad_σℜ = ℜʹ * r_normalized;
+    σℜʹ = ℜʹ;
   } else {
     auto const& c = sigmoid_coefficients_;
     Derivative<double, Length> const c1 = std::get<1>(c);
@@ -88,16 +99,16 @@ void HarmonicDamping::ComputeDampedRadialQuantities(
     σℜ_over_r = σ * ℜ_over_r;
     // Writing this as σ′ℜ + ℜ′σ rather than ℜ∇σ + σ∇ℜ turns some vector
     // operations into scalar ones.
-    grad_σℜ = (σʹr * ℜ_over_r + ℜʹ * σ) * r_normalized;
+    σℜʹ = σʹr * ℜ_over_r + ℜʹ * σ;
   }
 }
 
 template<typename Frame>
 struct Geopotential<Frame>::Precomputations {
-  // Allocate the maximum size to cover all possible degrees.  Making |size| a
+  // Allocate the maximum size to cover all unrolled degrees.  Making |size| a
   // template parameter of this class would be possible, but it would greatly
   // increase the number of instances of DegreeNOrderM and friends.
-  static constexpr int size = OblateBody<Frame>::max_geopotential_degree + 1;
+  static constexpr int size = max_unrolled_degree + 1;
 
   // These quantities are independent from n and m.
   typename OblateBody<Frame>::GeopotentialCoefficients const* cos;
@@ -531,8 +542,12 @@ Geopotential<Frame>::Geopotential(not_null<OblateBody<Frame> const*> body,
       harmonic_thresholds(after);
   for (int n = 2; n <= body_->geopotential_degree(); ++n) {
     for (int m = 0; m <= n; ++m) {
+      // Beyond the tabulated degrees, use the bound
+      // |P̄nm| ≤ √((2 - δm0)(2n + 1)), which follows from the addition theorem.
       double const max_abs_Pnm =
-          MaxAbsNormalizedAssociatedLegendreFunction[n][m];
+          n < MaxAbsNormalizedAssociatedLegendreFunction.rows
+              ? MaxAbsNormalizedAssociatedLegendreFunction[n][m]
+              : std::sqrt((m == 0 ? 1 : 2) * (2 * n + 1));
       double const Cnm = body->cos()[n][m];
       double const Snm = body->sin()[n][m];
       // TODO(egg): write a rootn.
@@ -568,6 +583,34 @@ Geopotential<Frame>::Geopotential(not_null<OblateBody<Frame> const*> body,
     }
     harmonic_thresholds.pop();
   }
+
+  int const degree = body_->geopotential_degree();
+  order_major_terms_.reserve((degree + 1) * (degree + 2) / 2);
+  for (int m = 0; m <= degree; ++m) {
+    for (int n = m; n <= degree; ++n) {
+      HarmonicTerm term;
+      term.Cnm = body_->cos()[n][m];
+      term.Snm = body_->sin()[n][m];
+      if (n == m) {
+        term.a = m == 0 ? 1
+                        : m == 1 ? std::sqrt(3.0)
+                                 : std::sqrt((2 * m + 1) / (2.0 * m));
+        term.b = 0;
+        term.derivative_factor = 0;
+      } else {
+        term.a = std::sqrt(((2 * n - 1) * (2 * n + 1)) /
+                           (static_cast<double>(n - m) * (n + m)));
+        term.b = n == m + 1
+                     ? 0
+                     : std::sqrt(((2 * n + 1) * (n + m - 1) * (n - m - 1)) /
+                                 (static_cast<double>(n - m) * (n + m) *
+                                  (2 * n - 3)));
+        term.derivative_factor =
+            std::sqrt((n - m) * (n + m + 1) / (m == 0 ? 2.0 : 1.0));
+      }
+      order_major_terms_.push_back(term);
+    }
+  }
 }
 
 template<typename Frame>
@@ -614,6 +657,10 @@ Geopotential<Frame>::GeneralSphericalHarmonicsAcceleration(
           }) - degree_damping_.begin();
   // We have |max_degree > 0|.
   int const max_degree = limiting_degree - 1;
+  if (max_degree > max_unrolled_degree) {
+    return RuntimeDegreeAcceleration(
+        max_degree, t, r, r_norm, r², one_over_r³);
+  }
   switch (max_degree) {
     PRINCIPIA_CASE_SPHERICAL_HARMONICS(2);
     PRINCIPIA_CASE_SPHERICAL_HARMONICS(3);
@@ -634,6 +681,201 @@ Geopotential<Frame>::GeneralSphericalHarmonicsAcceleration(
 
 #undef PRINCIPIA_CASE_SPHERICAL_HARMONICS
 
+template<typename Frame>
+Vector<Quotient<Acceleration, GravitationalParameter>, Frame>
+Geopotential<Frame>::RuntimeDegreeAcceleration(
+    int const max_degree,
+    Instant const& t,
+    Displacement<Frame> const& r,
+    Length const& r_norm,
+    Square<Length> const& r²,
+    Exponentiation<Length, -3> const& one_over_r³) const {
+  static constexpr int size = OblateBody<Frame>::max_geopotential_degree + 1;
+  int const degree = body_->geopotential_degree();
+  DCHECK_LE(2, max_degree);
+  DCHECK_LE(max_degree, degree);
+
+  OblateBody<Frame> const& body = *body_;
+  const bool is_zonal =
+      body.is_zonal() || r_norm > sectoral_damping_.outer_threshold();
+
+  // In the zonal case the rotation of the body is of no importance, so any pair
+  // of equatorial vectors will do.
+  UnitVector x̂;
+  UnitVector ŷ;
+  UnitVector const ẑ = body.polar_axis();
+  if (is_zonal) {
+    x̂ = body.biequatorial();
+    ŷ = body.equatorial();
+  } else {
+    auto const from_surface_frame =
+      body.template FromSurfaceFrame<SurfaceFrame>(t);
+    x̂ = from_surface_frame(x_);
+    ŷ = from_surface_frame(y_);
+  }
+
+  Length const x = InnerProduct(r, x̂);
+  Length const y = InnerProduct(r, ŷ);
+  Length const z = InnerProduct(r, ẑ);
+
+  Inverse<Length> const one_over_r_norm = 1 / r_norm;
+  auto const r_normalized = r * one_over_r_norm;
+
+  Square<Length> const x²_plus_y² = x * x + y * y;
+  Length const r_equatorial = Sqrt(x²_plus_y²);
+
+  double cos_λ = 1;
+  double sin_λ = 0;
+  if (r_equatorial > Length{}) {
+    Inverse<Length> const one_over_r_equatorial = 1 / r_equatorial;
+    cos_λ = x * one_over_r_equatorial;
+    sin_λ = y * one_over_r_equatorial;
+  }
+
+  double const cos_β = r_equatorial * one_over_r_norm;
+  double const sin_β = z * one_over_r_norm;
+
+  UnitVector const grad_𝔅_vector =
+      (-sin_β * cos_λ) * x̂ - (sin_β * sin_λ) * ŷ + cos_β * ẑ;
+  UnitVector const grad_𝔏_vector = cos_λ * ŷ - sin_λ * x̂;
+
+  // The radial quantities, which depend on n but are independent from m.
+  // Degree 2 has two sets of damped radial quantities because its sectoral
+  // harmonics are damped separately.
+  FixedVector<Exponentiation<Length, -2>, size> ℜ_over_r{uninitialized};
+  FixedVector<Inverse<Square<Length>>, size> σℜ_over_r{uninitialized};
+  FixedVector<Inverse<Square<Length>>, size> σℜʹ{uninitialized};
+  Inverse<Square<Length>> sectoral_σℜ_over_r;
+  Inverse<Square<Length>> sectoral_σℜʹ;
+  ℜ_over_r[1] = body.reference_radius() * one_over_r³;
+  for (int n = 2; n <= max_degree; ++n) {
+    // Compute ℜ based on the values around n/2 to reduce error accumulation.
+    int const h1 = n / 2;
+    int const h2 = n - h1;
+    ℜ_over_r[n] = ℜ_over_r[h1] * ℜ_over_r[h2] * r²;
+    auto const ℜʹ = -(n + 1) * ℜ_over_r[n];
+    degree_damping_[n].ComputeDampedRadialQuantities(
+        r_norm, r², ℜ_over_r[n], ℜʹ, σℜ_over_r[n], σℜʹ[n]);
+    // If we are above the outer threshold, we should not have been called
+    // (σ = 0).
+    DCHECK_LT(r_norm, degree_damping_[n].outer_threshold());
+    if (n == 2 && !is_zonal) {
+      sectoral_damping_.ComputeDampedRadialQuantities(
+          r_norm, r², ℜ_over_r[n], ℜʹ, sectoral_σℜ_over_r, sectoral_σℜʹ);
+    }
+  }
+
+  // These quantities depend on m but are independent from n.
+  FixedVector<double, size> cos_mλ{uninitialized};
+  FixedVector<double, size> sin_mλ{uninitialized};
+  FixedVector<double, size> cos_β_to_the_m{uninitialized};
+  cos_mλ[0] = 1;
+  sin_mλ[0] = 0;
+  cos_β_to_the_m[0] = 1;
+  cos_mλ[1] = cos_λ;
+  sin_mλ[1] = sin_λ;
+  cos_β_to_the_m[1] = cos_β;
+
+  // Two columns of the normalized associated Legendre functions (with the
+  // factor cos_β^m removed), for orders m and m + 1, indexed by degree.  Only
+  // the entries for degrees at least equal to the order are meaningful.
+  FixedVector<double, size> column1{uninitialized};
+  FixedVector<double, size> column2{uninitialized};
+  FixedVector<double, size>* P̄_m = &column1;
+  FixedVector<double, size>* P̄_m_plus_1 = &column2;
+
+  // Fills the column for order m, where |terms| points to the terms for that
+  // order and |P̄mm| is the sectoral value.
+  auto const fill_column = [max_degree, sin_β](int const m,
+                                               HarmonicTerm const* const terms,
+                                               double const P̄mm,
+                                               FixedVector<double, size>& P̄) {
+    P̄[m] = P̄mm;
+    if (m < max_degree) {
+      P̄[m + 1] = terms[1].a * sin_β * P̄[m];
+    }
+    for (int n = m + 2; n <= max_degree; ++n) {
+      HarmonicTerm const& term = terms[n - m];
+      P̄[n] = term.a * sin_β * P̄[n - 1] - term.b * P̄[n - 2];
+    }
+  };
+
+  // The terms for order m start at index m (degree + 1) - m (m - 1) / 2.
+  auto const terms_of_order = [this, degree](int const m) {
+    return &order_major_terms_[m * (degree + 1) - m * (m - 1) / 2];
+  };
+
+  // The coefficients of the acceleration along r_normalized, grad_𝔅_vector and
+  // grad_𝔏_vector.
+  ReducedAcceleration grad_ℜ_coefficient;
+  ReducedAcceleration grad_𝔅_coefficient;
+  ReducedAcceleration grad_𝔏_coefficient;
+
+  double P̄mm = 1;
+  fill_column(/*m=*/0, terms_of_order(0), P̄mm, *P̄_m);
+
+  // In the zonal case, no point in going beyond order 0, but the column for
+  // order 1 is still needed for the derivatives.
+  int const max_order = is_zonal ? 0 : max_degree;
+  for (int m = 0; m <= max_order; ++m) {
+    HarmonicTerm const* const terms = terms_of_order(m);
+    if (m < max_degree) {
+      HarmonicTerm const* const next_terms = terms_of_order(m + 1);
+      P̄mm *= next_terms[0].a;
+      fill_column(m + 1, next_terms, P̄mm, *P̄_m_plus_1);
+    }
+
+    if (m >= 2) {
+      // Compute the values for m * λ based on the values around m/2 * λ to
+      // reduce error accumulation.
+      int const h1 = m / 2;
+      int const h2 = m - h1;
+      sin_mλ[m] = sin_mλ[h1] * cos_mλ[h2] + cos_mλ[h1] * sin_mλ[h2];
+      cos_mλ[m] = cos_mλ[h1] * cos_mλ[h2] - sin_mλ[h1] * sin_mλ[h2];
+      cos_β_to_the_m[m] = cos_β_to_the_m[h1] * cos_β_to_the_m[h2];
+    }
+    // Not used if m = 0.
+    double const cos_β_to_the_m_minus_1 = m == 0 ? 0 : cos_β_to_the_m[m - 1];
+
+    for (int n = std::max(m, 2); n <= max_degree; ++n) {
+      HarmonicTerm const& term = terms[n - m];
+      double const P̄nm = (*P̄_m)[n];
+      double const 𝔅 = cos_β_to_the_m[m] * P̄nm;
+
+      double grad_𝔅_polynomials = 0;
+      if (m < n) {
+        grad_𝔅_polynomials = cos_β * cos_β_to_the_m[m] *
+                             term.derivative_factor * (*P̄_m_plus_1)[n];
+      }
+      if (m > 0) {
+        // Remove a singularity when m == 0 and cos_β == 0.
+        grad_𝔅_polynomials -= m * sin_β * cos_β_to_the_m_minus_1 * P̄nm;
+      }
+
+      double const 𝔏 = term.Cnm * cos_mλ[m] + term.Snm * sin_mλ[m];
+
+      bool const is_degree_2_sectoral = n == 2 && m > 0;
+      auto const& σℜn_over_r = is_degree_2_sectoral ? sectoral_σℜ_over_r
+                                                     : σℜ_over_r[n];
+      auto const& σℜnʹ = is_degree_2_sectoral ? sectoral_σℜʹ : σℜʹ[n];
+
+      grad_ℜ_coefficient += 𝔅 * 𝔏 * σℜnʹ;
+      grad_𝔅_coefficient += σℜn_over_r * 𝔏 * grad_𝔅_polynomials;
+      if (m > 0) {
+        // Compensate a cos_β to remove a singularity when cos_β == 0.
+        grad_𝔏_coefficient +=
+            σℜn_over_r * cos_β_to_the_m_minus_1 * P̄nm *  // 𝔅/cos_β
+            m * (term.Snm * cos_mλ[m] - term.Cnm * sin_mλ[m]);
+      }
+    }
+    std::swap(P̄_m, P̄_m_plus_1);
+  }
+
+  return grad_ℜ_coefficient * r_normalized +
+         grad_𝔅_coefficient * grad_𝔅_vector +
+         grad_𝔏_coefficient * grad_𝔏_vector;
+}
+
 template<typename Frame>
 std::vector<HarmonicDamping> const& Geopotential<Frame>::degree_damping()
     const {
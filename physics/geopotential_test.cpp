@@ -1,6 +1,7 @@
 ﻿
 #include "physics/geopotential.hpp"
 
+#include <random>
 #include <vector>
 
 #include "astronomy/fortran_astrodynamics_toolkit.hpp"
@@ -92,6 +93,19 @@ class GeopotentialTest : public ::testing::Test {
         t, r, r_norm, r², one_over_r³);
   }
 
+  template<typename Frame>
+  Vector<Quotient<Acceleration, GravitationalParameter>, Frame>
+  RuntimeDegreeAcceleration(Geopotential<Frame> const& geopotential,
+                            int const max_degree,
+                            Instant const& t,
+                            Displacement<Frame> const& r) {
+    auto const r² = r.Norm²();
+    auto const r_norm = Sqrt(r²);
+    auto const one_over_r³ = r_norm / (r² * r²);
+    return geopotential.RuntimeDegreeAcceleration(
+        max_degree, t, r, r_norm, r², one_over_r³);
+  }
+
   // The axis of rotation is along the z axis for ease of testing.
   AngularFrequency const angular_frequency_ = -1.5 * Radian / Second;
   Angle const right_ascension_of_pole_ = 0 * Degree;
@@ -339,6 +353,131 @@ TEST_F(GeopotentialTest, TestVector) {
               AlmostEquals(actual_acceleration_f90, 4, 8));
 }
 
+TEST_F(GeopotentialTest, RuntimeDegree) {
+  SolarSystem<ICRS> solar_system_2000(
+            SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+            SOLUTION_DIR / "astronomy" /
+                "sol_initial_state_jd_2451545_000000000.proto.txt");
+  solar_system_2000.LimitOblatenessToDegree("Earth", /*max_degree=*/10);
+  auto earth_message = solar_system_2000.gravity_model_message("Earth");
+
+  auto const earth_μ = solar_system_2000.gravitational_parameter("Earth");
+  auto const earth_reference_radius =
+      ParseQuantity<Length>(earth_message.reference_radius());
+  MassiveBody::Parameters const massive_body_parameters(earth_μ);
+  RotatingBody<ICRS>::Parameters rotating_body_parameters(
+      /*mean_radius=*/solar_system_2000.mean_radius("Earth"),
+      /*reference_angle=*/0 * Radian,
+      /*reference_instant=*/Instant(),
+      /*angular_frequency=*/1e-20 * Radian / Second,
+      right_ascension_of_pole_,
+      declination_of_pole_);
+  OblateBody<ICRS> const earth = OblateBody<ICRS>(
+      massive_body_parameters,
+      rotating_body_parameters,
+      OblateBody<ICRS>::Parameters::ReadFromMessage(
+          earth_message.geopotential(), earth_reference_radius));
+  Geopotential<ICRS> const geopotential(&earth, /*tolerance=*/0);
+
+  // Consistency between the unrolled implementation and the runtime-degree one,
+  // including on the axis of rotation where cos_β == 0.
+  for (auto const& displacement :
+       {Displacement<ITRS>({6000 * Kilo(Metre),
+                            -4000 * Kilo(Metre),
+                            5000 * Kilo(Metre)}),
+        Displacement<ITRS>({7000 * Kilo(Metre),
+                            0 * Kilo(Metre),
+                            0 * Kilo(Metre)}),
+        Displacement<ITRS>({0 * Kilo(Metre),
+                            0 * Kilo(Metre),
+                            -7000 * Kilo(Metre)})}) {
+    Displacement<ICRS> const icrs_displacement =
+        earth.FromSurfaceFrame<ITRS>(Instant())(displacement);
+    auto const unrolled_acceleration = GeneralSphericalHarmonicsAcceleration(
+        geopotential, Instant(), icrs_displacement);
+    auto const runtime_degree_acceleration = RuntimeDegreeAcceleration(
+        geopotential, /*max_degree=*/10, Instant(), icrs_displacement);
+    EXPECT_THAT(
+        RelativeError(unrolled_acceleration, runtime_degree_acceleration),
+        Lt(1e-13));
+  }
+}
+
+TEST_F(GeopotentialTest, HighDegree) {
+  SolarSystem<ICRS> solar_system_2000(
+            SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+            SOLUTION_DIR / "astronomy" /
+                "sol_initial_state_jd_2451545_000000000.proto.txt");
+  solar_system_2000.LimitOblatenessToDegree("Earth", /*max_degree=*/10);
+  auto earth_message = solar_system_2000.gravity_model_message("Earth");
+
+  // Extend the model with random coefficients following Kaula's rule up to a
+  // degree beyond those that are unrolled.
+  constexpr int max_degree = 20;
+  std::mt19937_64 random(42);
+  std::normal_distribution<> distribution;
+  for (int n = 11; n <= max_degree; ++n) {
+    auto* const row = earth_message.mutable_geopotential()->add_row();
+    row->set_degree(n);
+    for (int m = 0; m <= n; ++m) {
+      auto* const column = row->add_column();
+      column->set_order(m);
+      column->set_cos(1e-5 / (n * n) * distribution(random));
+      column->set_sin(m == 0 ? 0 : 1e-5 / (n * n) * distribution(random));
+    }
+  }
+
+  auto const earth_μ = solar_system_2000.gravitational_parameter("Earth");
+  auto const earth_reference_radius =
+      ParseQuantity<Length>(earth_message.reference_radius());
+  MassiveBody::Parameters const massive_body_parameters(earth_μ);
+  RotatingBody<ICRS>::Parameters rotating_body_parameters(
+      /*mean_radius=*/solar_system_2000.mean_radius("Earth"),
+      /*reference_angle=*/0 * Radian,
+      /*reference_instant=*/Instant(),
+      /*angular_frequency=*/1e-20 * Radian / Second,
+      right_ascension_of_pole_,
+      declination_of_pole_);
+  OblateBody<ICRS> const earth = OblateBody<ICRS>(
+      massive_body_parameters,
+      rotating_body_parameters,
+      OblateBody<ICRS>::Parameters::ReadFromMessage(
+          earth_message.geopotential(), earth_reference_radius));
+  EXPECT_EQ(max_degree, earth.geopotential_degree());
+  Geopotential<ICRS> const geopotential(&earth, /*tolerance=*/0);
+
+  Displacement<ITRS> const displacement(
+      {6000000 * Metre, -4000000 * Metre, 5000000 * Metre});
+
+  Displacement<ICRS> const icrs_displacement =
+      earth.FromSurfaceFrame<ITRS>(Instant())(displacement);
+  auto const icrs_acceleration =
+      earth_μ * (GeneralSphericalHarmonicsAcceleration(
+                     geopotential, Instant(), icrs_displacement) -
+                 icrs_displacement / Pow<3>(icrs_displacement.Norm()));
+  Vector<Acceleration, ITRS> const actual_acceleration_cpp =
+      earth.ToSurfaceFrame<ITRS>(Instant())(icrs_acceleration);
+
+  double mu = earth_μ / SIUnit<GravitationalParameter>();
+  double rbar = earth_reference_radius / Metre;
+  numerics::FixedMatrix<double, max_degree + 1, max_degree + 1> cnm;
+  numerics::FixedMatrix<double, max_degree + 1, max_degree + 1> snm;
+  for (int n = 0; n <= max_degree; ++n) {
+    for (int m = 0; m <= n; ++m) {
+      cnm[n][m] = earth.cos()[n][m] * LegendreNormalizationFactor[n][m];
+      snm[n][m] = earth.sin()[n][m] * LegendreNormalizationFactor[n][m];
+    }
+  }
+  Vector<Acceleration, ITRS> const actual_acceleration_f90(
+      SIUnit<Acceleration>() *
+      astronomy::fortran_astrodynamics_toolkit::
+          ComputeGravityAccelerationLear<max_degree, max_degree>(
+              displacement.coordinates() / Metre, mu, rbar, cnm, snm));
+
+  EXPECT_THAT(RelativeError(actual_acceleration_cpp, actual_acceleration_f90),
+              Lt(1e-14));
+}
+
 TEST_F(GeopotentialTest, HarmonicDamping) {
   HarmonicDamping σ(1 * Metre);
   EXPECT_THAT(σ.inner_threshold(), Eq(1 * Metre));
@@ -31,6 +31,10 @@ class MockEphemeris : public Ephemeris<Frame> {
   MOCK_CONST_METHOD1_T(trajectory,
                        not_null<ContinuousTrajectory<Frame> const*>(
                            not_null<MassiveBody const*> body));
+  MOCK_CONST_METHOD1_T(EvaluateAllPositions,
+                       std::vector<Position<Frame>>(Instant const& t));
+  MOCK_CONST_METHOD1_T(EvaluateAllDegreesOfFreedom,
+                       std::vector<DegreesOfFreedom<Frame>>(Instant const& t));
   MOCK_CONST_METHOD0_T(empty, bool());
   MOCK_CONST_METHOD0_T(t_min, Instant());
   MOCK_CONST_METHOD0_T(t_max, Instant());
@@ -40,6 +44,8 @@ class MockEphemeris : public Ephemeris<Frame> {
 
   MOCK_METHOD1_T(ForgetBefore, void(Instant const& t));
   MOCK_METHOD1_T(Prolong, void(Instant const& t));
+  MOCK_METHOD1_T(SetFittingThreadPool,
+                 void(ThreadPool<Status>* thread_pool));
   MOCK_METHOD3_T(
       NewInstance,
       not_null<std::unique_ptr<
@@ -47,6 +53,14 @@ class MockEphemeris : public Ephemeris<Frame> {
           std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
           IntrinsicAccelerations const& intrinsic_accelerations,
           FixedStepParameters const& parameters));
+  MOCK_METHOD4_T(
+      NewInstance,
+      not_null<std::unique_ptr<
+          typename Integrator<NewtonianMotionEquation>::Instance>>(
+          std::vector<not_null<DiscreteTrajectory<Frame>*>> const& trajectories,
+          IntrinsicAccelerations const& intrinsic_accelerations,
+          FixedStepParameters const& parameters,
+          not_null<ThreadPool<void>*> thread_pool));
   MOCK_METHOD6_T(
       FlowWithAdaptiveStep,
       Status(not_null<DiscreteTrajectory<Frame>*> trajectory,
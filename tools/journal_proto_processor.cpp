@@ -312,6 +312,49 @@ void JournalProtoProcessor::ProcessRequiredFixed32Field(
   field_cxx_type_[descriptor] = "uint32_t";
 }
 
+void JournalProtoProcessor::ProcessBufferFixed64Field(
+    FieldDescriptor const* descriptor) {
+  FieldOptions const& options = descriptor->options();
+  CHECK(!Contains(out_, descriptor))
+      << descriptor->full_name() << " cannot be an out parameter";
+  CHECK(options.HasExtension(journal::serialization::pointer_to))
+      << descriptor->full_name() << " is missing a (pointer_to) option";
+  CHECK(!options.HasExtension(journal::serialization::is_consumed) &&
+        !options.HasExtension(journal::serialization::is_consumed_if) &&
+        !options.HasExtension(journal::serialization::is_produced) &&
+        !options.HasExtension(journal::serialization::is_produced_if) &&
+        !options.HasExtension(journal::serialization::disposable) &&
+        !options.HasExtension(journal::serialization::is_subject))
+      << descriptor->full_name() << " cannot be a buffer and a pointer";
+  std::string const pointer_to =
+      options.GetExtension(journal::serialization::pointer_to);
+  std::string const buffer_size =
+      options.GetExtension(journal::serialization::buffer_size);
+
+  // The array is pinned by the marshaller, and the elements written by the
+  // interface are copied back.
+  field_cs_type_[descriptor] = pointer_to + "[]";
+  field_cs_marshal_[descriptor] = "In, Out";
+  field_cxx_type_[descriptor] = pointer_to + "*";
+
+  field_cxx_arguments_fn_[descriptor] =
+      [](std::string const& identifier) -> std::vector<std::string> {
+        return {identifier + ".get()"};
+      };
+  field_cxx_deserializer_fn_[descriptor] =
+      [pointer_to, buffer_size](
+          std::string const& expr) -> std::vector<std::string> {
+        // The use of |substr| below is a bit of a cheat because we know the
+        // structure of |expr|.
+        return {"std::make_unique<" + pointer_to + "[]>(" +
+                expr.substr(0, expr.find('.')) + "." + buffer_size + "())"};
+      };
+  field_cxx_serializer_fn_[descriptor] =
+      [](std::string const& expr) {
+        return "SerializePointer(" + expr + ")";
+      };
+}
+
 void JournalProtoProcessor::ProcessRequiredFixed64Field(
     FieldDescriptor const* descriptor) {
   FieldOptions const& options = descriptor->options();
@@ -319,6 +362,10 @@ void JournalProtoProcessor::ProcessRequiredFixed64Field(
         !options.HasExtension(journal::serialization::encoding))
       << descriptor->full_name()
       << " cannot have both a (pointer_to) and an (encoding) option";
+  if (options.HasExtension(journal::serialization::buffer_size)) {
+    ProcessBufferFixed64Field(descriptor);
+    return;
+  }
   std::string pointer_to;
   if (options.HasExtension(journal::serialization::pointer_to)) {
     pointer_to = options.GetExtension(journal::serialization::pointer_to);
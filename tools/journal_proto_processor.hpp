@@ -50,6 +50,7 @@ class JournalProtoProcessor final {
   void ProcessOptionalMessageField(FieldDescriptor const* descriptor);
 
   void ProcessRequiredFixed32Field(FieldDescriptor const* descriptor);
+  void ProcessBufferFixed64Field(FieldDescriptor const* descriptor);
   void ProcessRequiredFixed64Field(FieldDescriptor const* descriptor);
   void ProcessRequiredMessageField(FieldDescriptor const* descriptor);
   void ProcessRequiredBoolField(FieldDescriptor const* descriptor);